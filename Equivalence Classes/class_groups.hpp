@@ -0,0 +1,76 @@
+#ifndef CLASS_GROUPS_HPP_
+#define CLASS_GROUPS_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include "ics_exceptions.hpp"
+
+
+namespace ics {
+
+
+//ClassGroups stores the classes of an Equivalence in two flat arrays: the
+//  values of class c are values[offsets[c]] .. values[offsets[c+1]-1], so
+//  offsets has class_count()+1 entries, the last being size(). The
+//  class_groups() method of each Equivalence builds one in a single pass
+//  (O(N) for N values), without hashing or comparing any sets.
+template<class T> class ClassGroups {
+  public:
+    //Queries
+    int      class_count () const {return offsets.size()-1;}
+    int      size        () const {return values.size();}
+    int      class_size  (int c) const {check(c); return offsets[c+1]-offsets[c];}
+    const T* begin       (int c) const {check(c); return values.data()+offsets[c];}
+    const T* end         (int c) const {check(c); return values.data()+offsets[c+1];}
+    std::string str      () const;
+
+    //Commands (used while building)
+    void add (const T& v) {values.push_back(v);}
+    void end_class ()     {offsets.push_back(values.size());}
+
+    std::vector<int> offsets = std::vector<int>(1,0);
+    std::vector<T>   values;
+
+  private:
+    void check (int c) const;
+};
+
+
+template<class T>
+std::string ClassGroups<T>::str () const {
+  std::ostringstream answer;
+  answer << *this;
+  return answer.str();
+}
+
+
+template<class T>
+void ClassGroups<T>::check (int c) const {
+  if (c < 0 || c >= class_count()) {
+    std::ostringstream answer;
+    answer << "ClassGroups::check c(" << c << ") is not a class number (class_count = " << class_count() << ")";
+    throw EquivalenceError(answer.str());
+  }
+}
+
+
+//Prints, for example, groups[[a,c],[b],[d,e,f]]
+template<class T>
+std::ostream& operator << (std::ostream& outs, const ClassGroups<T>& g) {
+  outs << "groups[";
+  for (int c=0; c<g.class_count(); ++c) {
+    outs << (c == 0 ? "[" : ",[");
+    for (const T* v=g.begin(c); v!=g.end(c); ++v)
+      outs << (v == g.begin(c) ? "" : ",") << *v;
+    outs << "]";
+  }
+  outs << "]";
+  return outs;
+}
+
+
+}
+
+#endif /* CLASS_GROUPS_HPP_ */
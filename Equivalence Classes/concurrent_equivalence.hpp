@@ -0,0 +1,293 @@
+#ifndef CONCURRENT_EQUIVALENCE_HPP_
+#define CONCURRENT_EQUIVALENCE_HPP_
+
+#include <sstream>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "ics_exceptions.hpp"
+#include "hash_map.hpp"
+#include "hash_set.hpp"
+#include "dense_equivalence.hpp"
+
+
+namespace ics {
+
+
+//ConcurrentEquivalence stores the ids 0..n-1 (all added as singletons when it
+//  is constructed) in an array of atomic parents, so that in_same_class and
+//  merge_classes_of can be called from many threads at once without locks.
+//  - Finding a root uses path splitting: each node on the path is made to refer
+//    to its grandparent with a compare-and-swap; a failed swap just means some
+//    other thread already changed that parent, so it is simply skipped. Finds
+//    are lock-free (not wait-free): concurrent merges can keep lengthening
+//    the path a find is following.
+//  - Roots are linked by a fixed random-looking priority of their ids (the id
+//    times an odd constant): the root with lower priority is made to refer to
+//    the other one, by a compare-and-swap that succeeds only if it is still a
+//    root. If it fails, both roots are found again and the merge is retried.
+//    Since every parent has a higher priority than its children (linking and
+//    path splitting both preserve this) no thread can ever create a cycle.
+//The remaining methods (classes, heights, ...) should be called only when no
+//  other thread is merging.
+class ConcurrentEquivalence {
+  public:
+    typedef DenseEquivalence::Class Class;
+
+    //Destructor/Constructors
+    ~ConcurrentEquivalence ();
+
+    explicit ConcurrentEquivalence (int n);         //adds singletons 0..n-1
+    ConcurrentEquivalence          (const ConcurrentEquivalence& to_copy);
+
+
+    //Queries (safe to call concurrently with each other and with merge_classes_of)
+    bool in_same_class (int a, int b);
+    int  root_of       (int a);
+    int  size          () const;                    // number of values in all Equivalences
+    int  class_count   () const;                    // number of Equivalences
+
+
+    //Queries (not safe to call concurrently with merge_classes_of)
+    HashSet<Class>   classes      ();
+    ClassGroups<int> class_groups () const;
+    DenseEquivalence to_dense     () const;
+    std::string str               () const; //supplies useful debugging information; contrast to operator <<
+
+
+    //Commands (safe to call concurrently); returns whether a and b were in different classes
+    bool merge_classes_of (int a, int b);
+
+
+    //Operators
+    friend std::ostream& operator << (std::ostream& outs, const ConcurrentEquivalence& e);
+
+
+    //Miscellaneous methods (useful for testing/debugging)
+    int max_height                                   () const;
+    HashMap<int,int,DenseEquivalence::hash_id> heights () const;
+    std::string equivalence_info                     () const;
+
+  private:
+    int                                 n;
+    std::unique_ptr<std::atomic<int>[]> parent;
+    std::atomic<int>                    classes_left;
+
+    ConcurrentEquivalence& operator = (const ConcurrentEquivalence& rhs);  //not supported
+
+    //Helper methods
+    static unsigned priority (int a) {return unsigned(a)*2654435761u;}
+    void check_value      (int a, const char* where, const char* name) const;
+    int  compress_to_root (int a);
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//ConcurrentEquivalence class and related definitions
+
+//Destructor/Constructors
+
+inline ConcurrentEquivalence::~ConcurrentEquivalence ()
+{}
+
+
+inline ConcurrentEquivalence::ConcurrentEquivalence (int n)
+: n(n), parent(new std::atomic<int>[n < 0 ? 0 : n]), classes_left(n) {
+  if (n < 0) {
+    std::ostringstream answer;
+    answer << "ConcurrentEquivalence::ConcurrentEquivalence n(" << n << ") is negative";
+    throw EquivalenceError(answer.str());
+  }
+  for (int i=0; i<n; ++i)
+    parent[i].store(i, std::memory_order_relaxed);
+}
+
+
+inline ConcurrentEquivalence::ConcurrentEquivalence (const ConcurrentEquivalence& to_copy)
+: n(to_copy.n), parent(new std::atomic<int>[to_copy.n]), classes_left(to_copy.classes_left.load()) {
+  for (int i=0; i<n; ++i)
+    parent[i].store(to_copy.parent[i].load(), std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+//Find both roots; if they differ, a and b were in different classes at the
+//  moment the first root was seen still to be a root (after finding the
+//  second); otherwise that root was merged in the meantime, so try again.
+//Throw an EquivalenceError (with a descriptive message) if the parameter a or b
+//  is not an id in the Equivalence.
+inline bool ConcurrentEquivalence::in_same_class (int a, int b) {
+  check_value(a, "in_same_class", "a");
+  check_value(b, "in_same_class", "b");
+  for (;;) {
+    a = compress_to_root(a);
+    b = compress_to_root(b);
+    if (a == b)
+      return true;
+    if (parent[a].load(std::memory_order_acquire) == a)
+      return false;
+  }
+}
+
+
+inline int ConcurrentEquivalence::root_of (int a) {
+  check_value(a, "root_of", "a");
+  return compress_to_root(a);
+}
+
+
+inline int ConcurrentEquivalence::size () const {
+  return n;
+}
+
+
+inline int ConcurrentEquivalence::class_count () const {
+  return classes_left.load();
+}
+
+
+inline HashSet<ConcurrentEquivalence::Class> ConcurrentEquivalence::classes () {
+  return to_dense().classes();
+}
+
+
+inline ClassGroups<int> ConcurrentEquivalence::class_groups () const {
+  return to_dense().class_groups();
+}
+
+
+//Copy the trees (as they are) into a DenseEquivalence
+inline DenseEquivalence ConcurrentEquivalence::to_dense () const {
+  DenseEquivalence answer(n);
+  for (int i=0; i<n; ++i)
+    answer.merge_classes_of(i, parent[i].load());
+  return answer;
+}
+
+
+inline std::string ConcurrentEquivalence::str () const {
+  std::ostringstream answer;
+  answer << "ConcurrentEquivalence [" << std::endl;
+  answer << "  parent: [";
+  for (int i=0; i<n; ++i)
+    answer << (i == 0 ? "" : ",") << parent[i].load();
+  answer << "]" << std::endl;
+  answer << "  class_count: " << class_count() << "]" << std::endl;
+  return answer.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+//Make the root of lower priority refer to the other root, if it is still a
+//  root; otherwise find the roots again and retry.
+//Throw an EquivalenceError (with a descriptive message) if the parameter a or b
+//  is not an id in the Equivalence.
+inline bool ConcurrentEquivalence::merge_classes_of (int a, int b) {
+  check_value(a, "merge_classes_of", "a");
+  check_value(b, "merge_classes_of", "b");
+  for (;;) {
+    a = compress_to_root(a);
+    b = compress_to_root(b);
+    if (a == b)
+      return false;
+    if (priority(a) > priority(b))
+      std::swap(a,b);
+    int expected = a;
+    if (parent[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel)) {
+      classes_left.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+inline std::ostream& operator << (std::ostream& outs, const ConcurrentEquivalence& e) {
+  outs << e.str();
+  return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Helper methods
+
+inline void ConcurrentEquivalence::check_value (int a, const char* where, const char* name) const {
+  if (a < 0 || a >= n) {
+    std::ostringstream answer;
+    answer << "ConcurrentEquivalence::" << where << " " << name << "(" << a << ") is not a value in the Equivalence";
+    throw EquivalenceError(answer.str());
+  }
+}
+
+
+//Path splitting: make each node on the path from a refer to its grandparent
+//  (unless another thread has changed its parent first) while walking up.
+inline int ConcurrentEquivalence::compress_to_root (int a) {
+  for (;;) {
+    int p = parent[a].load(std::memory_order_acquire);
+    if (p == a)
+      return a;
+    int gp = parent[p].load(std::memory_order_acquire);
+    if (p != gp)
+      parent[a].compare_exchange_weak(p, gp, std::memory_order_acq_rel);
+    a = p;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Miscellaneous methods (useful for testing/debugging)
+
+inline int ConcurrentEquivalence::max_height () const {
+  int mh = 0;
+  for (const pair<int,int>& h : heights())
+    if (h.second > mh)
+      mh = h.second;
+  return mh;
+}
+
+
+//Compute/Return a map of all root heights.
+//Don't compress any nodes here
+inline HashMap<int,int,DenseEquivalence::hash_id> ConcurrentEquivalence::heights () const {
+  HashMap<int,int,DenseEquivalence::hash_id> answer;
+  for (int i=0; i<n; ++i) {
+    int e = i, depth = 0;
+    while (parent[e].load() != e) {
+      e = parent[e].load();
+      depth++;
+    }
+    if (answer[e] < depth)
+      answer[e] = depth;
+  }
+  return answer;
+}
+
+
+inline std::string ConcurrentEquivalence::equivalence_info () const {
+  std::ostringstream answer;
+  answer << "  parent     : " << str()        << std::endl;
+  answer << "  heights map: " << heights()    << std::endl;
+  answer << "  max height : " << max_height() << std::endl;
+  return answer.str();
+}
+
+
+}
+
+#endif /* CONCURRENT_EQUIVALENCE_HPP_ */
@@ -0,0 +1,665 @@
+#ifndef DENSE_EQUIVALENCE_HPP_
+#define DENSE_EQUIVALENCE_HPP_
+
+#include <sstream>
+#include <vector>
+#include "ics_exceptions.hpp"
+#include "hash_map.hpp"
+#include "hash_set.hpp"
+#include "class_groups.hpp"
+
+
+namespace ics {
+
+
+//DenseEquivalence stores values that are small non-negative ints (ids) in two
+//  contiguous arrays indexed by id, instead of the HashMap of nodes used by
+//  HashEquivalence: parent[id] is -1 if id is not a value in the Equivalence;
+//  root_size[id] is meaningful only when id is a root.
+//Roots are found by path halving (each node on the path is made to refer to its
+//  grandparent: no second pass or temporary set) and classes are merged by size,
+//  so trees stay nearly flat and every operation is a few array accesses.
+//Adding singleton id grows the arrays to id+1; call reserve (or construct with
+//  n, which adds the singletons 0..n-1) to allocate them once up front.
+class DenseEquivalence {
+  public:
+    static int hash_id (const int& id) {return id;}
+    typedef HashSet<int,hash_id> Class;
+
+    //Destructor/Constructors
+    ~DenseEquivalence ();
+
+    explicit DenseEquivalence (int n = 0);       //adds singletons 0..n-1
+    DenseEquivalence          (const DenseEquivalence& to_copy);
+    explicit DenseEquivalence (const std::initializer_list<int>& il);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit DenseEquivalence (const Iterable& i);
+
+
+    //Queries
+    bool             in_same_class (int a, int b);   // Not const because compression
+    bool             contains      (int a) const;
+    int              size          () const;         // number of values in all Equivalences
+    int              class_count   () const;         // number of Equivalences
+    int              root_of       (int a);          // Not const because compression
+    HashSet<Class>   classes       ();               // Not const because compression used
+    ClassGroups<int> class_groups  () const;         // all classes, O(size())
+    Class            class_of      (int a) const;    // a's class, O(its size)
+    int              class_size    (int a);          // Not const because compression
+    std::string str                () const; //supplies useful debugging information; contrast to operator <<
+
+
+    //Commands
+    void reserve          (int n);
+    void add_singleton    (int a);
+    void merge_classes_of (int a, int b);
+
+
+    //Operators
+    DenseEquivalence& operator = (const DenseEquivalence& rhs);
+    friend std::ostream& operator << (std::ostream& outs, const DenseEquivalence& e);
+
+
+    //Miscellaneous methods (useful for testing/debugging)
+    int max_height                 () const;
+    HashMap<int,int,hash_id> heights () const;
+    std::string equivalence_info   () const;
+
+  private:
+    std::vector<int> parent;
+    std::vector<int> root_size;
+    std::vector<int> next;      //links the values of each class into a ring
+    int used         = 0;
+    int classes_left = 0;
+
+    //Helper methods
+    void check_value      (int a, const char* where, const char* name) const;
+    int  compress_to_root (int a);
+};
+
+
+
+
+//InternedEquivalence supplies the HashEquivalence interface for any T by
+//  assigning each value an id (in the order the values are added as
+//  singletons) and storing the classes in a DenseEquivalence. Each query or
+//  command does one hash lookup per value to find its id; the root finding and
+//  merging after that are all array operations.
+template<class T, int (*thash) (const T& a)> class InternedEquivalence {
+  public:
+    //Destructor/Constructors
+    ~InternedEquivalence ();
+
+    InternedEquivalence          (double the_load_threshold = 1.0);
+    InternedEquivalence          (const InternedEquivalence<T,thash>& to_copy, double the_load_threshold = 1.0);
+    explicit InternedEquivalence (const std::initializer_list<T>& il, double the_load_threshold = 1.0);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit InternedEquivalence (const Iterable& i, double the_load_threshold = 1.0);
+
+
+    //Queries
+    bool                in_same_class (const T& a, const T& b); // Not const because compression
+    int                 size          () const;                 // number of values in all Equivalences
+    int                 class_count   () const;                 // number of Equivalences
+    int                 id            (const T& a) const;       // dense id of a (0..size()-1)
+    const T&            value         (int id) const;           // value with that id
+    HashSet<HashSet<T,thash>> classes ();                       // Not const because compression used
+    ClassGroups<T>      class_groups  () const;                 // all classes, O(size())
+    HashSet<T,thash>    class_of      (const T& a) const;       // a's class, O(its size)
+    int                 class_size    (const T& a);             // Not const because compression
+    std::string str                   () const; //supplies useful debugging information; contrast to operator <<
+
+
+    //Commands
+    void reserve          (int n);
+    void add_singleton    (const T& a);
+    void merge_classes_of (const T& a, const T& b);
+
+
+    //Operators
+    template<class T2, int (*thash2) (const T2& a)>
+    friend std::ostream& operator << (std::ostream& outs, const InternedEquivalence<T2,thash2>& e);
+
+
+    //Miscellaneous methods (useful for testing/debugging)
+    int max_height               () const;
+    HashMap<T,int> heights       () const;
+    std::string equivalence_info () const;
+
+  private:
+    HashMap<T,int>   ids;
+    std::vector<T>   values;
+    DenseEquivalence dense;
+
+    //Helper methods
+    int lookup (const T& a, const char* where, const char* name) const;
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//DenseEquivalence class and related definitions
+
+//Destructor/Constructors
+
+inline DenseEquivalence::~DenseEquivalence ()
+{}
+
+
+inline DenseEquivalence::DenseEquivalence (int n) {
+  reserve(n);
+  for (int i=0; i<n; ++i)
+    add_singleton(i);
+}
+
+
+inline DenseEquivalence::DenseEquivalence (const DenseEquivalence& to_copy)
+: parent(to_copy.parent), root_size(to_copy.root_size), next(to_copy.next),
+  used(to_copy.used), classes_left(to_copy.classes_left) {
+}
+
+
+inline DenseEquivalence::DenseEquivalence (const std::initializer_list<int>& il) {
+  for (int v : il)
+    add_singleton(v);
+}
+
+
+template <class Iterable>
+DenseEquivalence::DenseEquivalence (const Iterable& i) {
+  for (int v : i)
+    add_singleton(v);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+//Two values are in the same class if their equivalence trees have the same roots
+//  (finding the roots halves the paths to them).
+//Throw an EquivalenceError (with a descriptive message) if the parameter a or b
+//  is not already a value in the Equivalence (were never added as singletons).
+inline bool DenseEquivalence::in_same_class (int a, int b) {
+  check_value(a, "in_same_class", "a");
+  check_value(b, "in_same_class", "b");
+  return compress_to_root(a) == compress_to_root(b);
+}
+
+
+inline bool DenseEquivalence::contains (int a) const {
+  return a >= 0 && a < int(parent.size()) && parent[a] >= 0;
+}
+
+
+inline int DenseEquivalence::size () const {
+  return used;
+}
+
+
+inline int DenseEquivalence::class_count () const {
+  return classes_left;
+}
+
+
+inline int DenseEquivalence::root_of (int a) {
+  check_value(a, "root_of", "a");
+  return compress_to_root(a);
+}
+
+
+//Collect the members of each class in a vector indexed by root, then insert
+//  each collection into the answer as a Class.
+inline HashSet<DenseEquivalence::Class> DenseEquivalence::classes () {
+  std::vector<std::vector<int>> members(parent.size());
+  for (int i=0; i<int(parent.size()); ++i)
+    if (parent[i] >= 0)
+      members[compress_to_root(i)].push_back(i);
+
+  HashSet<Class> answer(1, [] (const Class& s) {
+    unsigned total = 1;
+    for (int i : s)
+      total = total * unsigned(hash_id(i));
+    return int(total);
+  });
+  for (const std::vector<int>& m : members)
+    if (!m.empty())
+      answer.insert(Class(m));
+  return answer;
+}
+
+
+//Walk the ring of each root, appending its values as one class
+inline ClassGroups<int> DenseEquivalence::class_groups () const {
+  ClassGroups<int> answer;
+  answer.values.reserve(used);
+  answer.offsets.reserve(classes_left+1);
+  for (int r=0; r<int(parent.size()); ++r)
+    if (parent[r] == r) {
+      int v = r;
+      do {
+        answer.add(v);
+        v = next[v];
+      } while (v != r);
+      answer.end_class();
+    }
+  return answer;
+}
+
+
+inline DenseEquivalence::Class DenseEquivalence::class_of (int a) const {
+  check_value(a, "class_of", "a");
+  Class answer;
+  int v = a;
+  do {
+    answer.insert(v);
+    v = next[v];
+  } while (v != a);
+  return answer;
+}
+
+
+inline int DenseEquivalence::class_size (int a) {
+  check_value(a, "class_size", "a");
+  return root_size[compress_to_root(a)];
+}
+
+
+inline std::string DenseEquivalence::str () const {
+  std::ostringstream answer;
+  answer << "DenseEquivalence [" << std::endl;
+  answer << "  parent   : [";
+  for (int i=0; i<int(parent.size()); ++i)
+    answer << (i == 0 ? "" : ",") << parent[i];
+  answer << "]" << std::endl;
+  answer << "  root_size: [";
+  for (int i=0; i<int(root_size.size()); ++i)
+    answer << (i == 0 ? "" : ",") << root_size[i];
+  answer << "]]" << std::endl;
+  return answer.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+inline void DenseEquivalence::reserve (int n) {
+  parent.reserve(n);
+  root_size.reserve(n);
+  next.reserve(n);
+}
+
+
+//Add the singleton a to the Equivalence, growing the arrays if necessary.
+//Throw an EquivalenceError (with a descriptive message) if the parameter a
+//  is negative or already a value in the Equivalence.
+inline void DenseEquivalence::add_singleton (int a) {
+  if (a < 0 || contains(a)) {
+    std::ostringstream answer;
+    answer << "DenseEquivalence::add_singleton a(" << a << ") is "
+           << (a < 0 ? "negative" : "already a value in the Equivalence");
+    throw EquivalenceError(answer.str());
+  }
+  if (a >= int(parent.size())) {
+    parent.resize(a+1, -1);
+    root_size.resize(a+1, 0);
+    next.resize(a+1, -1);
+  }
+  parent[a]    = a;
+  root_size[a] = 1;
+  next[a]      = a;
+  ++used;
+  ++classes_left;
+}
+
+
+//Find the roots of a and b; if they differ make the root of the smaller class
+//  refer to the root of the larger one and update the larger one's size;
+//  swapping the next values of the two roots splices their rings into one ring.
+//Throw an EquivalenceError (with a descriptive message) if the parameter a or b
+//  is not already a value in the Equivalence (were never added as singletons).
+inline void DenseEquivalence::merge_classes_of (int a, int b) {
+  check_value(a, "merge_classes_of", "a");
+  check_value(b, "merge_classes_of", "b");
+  int ra = compress_to_root(a);
+  int rb = compress_to_root(b);
+  if (ra == rb)
+    return;
+  if (root_size[ra] < root_size[rb])
+    std::swap(ra,rb);
+  parent[rb]     = ra;
+  root_size[ra] += root_size[rb];
+  std::swap(next[ra], next[rb]);
+  --classes_left;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+inline DenseEquivalence& DenseEquivalence::operator = (const DenseEquivalence& rhs) {
+  parent       = rhs.parent;
+  root_size    = rhs.root_size;
+  next         = rhs.next;
+  used         = rhs.used;
+  classes_left = rhs.classes_left;
+  return *this;
+}
+
+
+inline std::ostream& operator << (std::ostream& outs, const DenseEquivalence& e) {
+  outs << e.str();
+  return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Helper methods
+
+inline void DenseEquivalence::check_value (int a, const char* where, const char* name) const {
+  if (!contains(a)) {
+    std::ostringstream answer;
+    answer << "DenseEquivalence::" << where << " " << name << "(" << a << ") is not a value in the Equivalence";
+    throw EquivalenceError(answer.str());
+  }
+}
+
+
+//Path halving: make every other node on the path from a refer to its
+//  grandparent while walking up to the root.
+inline int DenseEquivalence::compress_to_root (int a) {
+  while (parent[a] != a) {
+    parent[a] = parent[parent[a]];
+    a = parent[a];
+  }
+  return a;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Miscellaneous methods (useful for testing/debugging)
+
+inline int DenseEquivalence::max_height () const {
+  int mh = 0;
+  for (const pair<int,int>& h : heights())
+    if (h.second > mh)
+      mh = h.second;
+  return mh;
+}
+
+
+//Compute/Return a map of all root heights.
+//Don't compress any nodes here
+inline HashMap<int,int,DenseEquivalence::hash_id> DenseEquivalence::heights () const {
+  HashMap<int,int,hash_id> answer;
+  for (int i=0; i<int(parent.size()); ++i)
+    if (parent[i] >= 0) {
+      int e = i, depth = 0;
+      while (parent[e] != e) {
+        e = parent[e];
+        depth++;
+      }
+      if (answer[e] < depth)
+        answer[e] = depth;
+    }
+  return answer;
+}
+
+
+inline std::string DenseEquivalence::equivalence_info () const {
+  std::ostringstream answer;
+  answer << "  parent/root_size: " << str()        << std::endl;
+  answer << "  heights map     : " << heights()    << std::endl;
+  answer << "  max height      : " << max_height() << std::endl;
+  return answer.str();
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//InternedEquivalence class and related definitions
+
+//Destructor/Constructors
+
+template<class T, int (*thash) (const T& a)>
+InternedEquivalence<T,thash>::~InternedEquivalence ()
+{}
+
+
+template<class T, int (*thash) (const T& a)>
+InternedEquivalence<T,thash>::InternedEquivalence (double the_load_threshold)
+: ids(the_load_threshold,thash) {
+}
+
+
+template<class T, int (*thash) (const T& a)>
+InternedEquivalence<T,thash>::InternedEquivalence (const InternedEquivalence<T,thash>& to_copy, double the_load_threshold)
+: ids(to_copy.ids,the_load_threshold,thash), values(to_copy.values), dense(to_copy.dense) {
+}
+
+
+template<class T, int (*thash) (const T& a)>
+InternedEquivalence<T,thash>::InternedEquivalence (const std::initializer_list<T>& il, double the_load_threshold)
+: ids(the_load_threshold,thash) {
+  for (const T& v : il)
+    add_singleton(v);
+}
+
+
+template<class T, int (*thash) (const T& a)>
+template <class Iterable>
+InternedEquivalence<T,thash>::InternedEquivalence (const Iterable& i, double the_load_threshold)
+: ids(the_load_threshold,thash) {
+  for (const T& v : i)
+    add_singleton(v);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class T, int (*thash) (const T& a)>
+bool InternedEquivalence<T,thash>::in_same_class (const T& a, const T& b) {
+  int ia = lookup(a, "in_same_class", "a");
+  int ib = lookup(b, "in_same_class", "b");
+  return dense.root_of(ia) == dense.root_of(ib);
+}
+
+
+template<class T, int (*thash) (const T& a)>
+int InternedEquivalence<T,thash>::size () const {
+  return dense.size();
+}
+
+
+template<class T, int (*thash) (const T& a)>
+int InternedEquivalence<T,thash>::class_count () const {
+  return dense.class_count();
+}
+
+
+template<class T, int (*thash) (const T& a)>
+int InternedEquivalence<T,thash>::id (const T& a) const {
+  return lookup(a, "id", "a");
+}
+
+
+template<class T, int (*thash) (const T& a)>
+const T& InternedEquivalence<T,thash>::value (int id) const {
+  if (id < 0 || id >= int(values.size())) {
+    std::ostringstream answer;
+    answer << "InternedEquivalence::value id(" << id << ") is not an id in the Equivalence";
+    throw EquivalenceError(answer.str());
+  }
+  return values[id];
+}
+
+
+template<class T, int (*thash) (const T& a)>
+HashSet<HashSet<T,thash>> InternedEquivalence<T,thash>::classes () {
+  HashSet<HashSet<T,thash>> answer(1, [] (const HashSet<T,thash>& s) {
+    unsigned total = 1;
+    for (const T& i : s)
+      total = total * unsigned(thash(i));
+    return int(total);
+  });
+  for (const DenseEquivalence::Class& c : dense.classes()) {
+    HashSet<T,thash> s;
+    for (int i : c)
+      s.insert(values[i]);
+    answer.insert(s);
+  }
+  return answer;
+}
+
+
+template<class T, int (*thash) (const T& a)>
+ClassGroups<T> InternedEquivalence<T,thash>::class_groups () const {
+  ClassGroups<int> groups = dense.class_groups();
+  ClassGroups<T>   answer;
+  answer.offsets = groups.offsets;
+  answer.values.reserve(groups.size());
+  for (int i : groups.values)
+    answer.add(values[i]);
+  return answer;
+}
+
+
+template<class T, int (*thash) (const T& a)>
+HashSet<T,thash> InternedEquivalence<T,thash>::class_of (const T& a) const {
+  HashSet<T,thash> answer;
+  for (int i : dense.class_of(lookup(a, "class_of", "a")))
+    answer.insert(values[i]);
+  return answer;
+}
+
+
+template<class T, int (*thash) (const T& a)>
+int InternedEquivalence<T,thash>::class_size (const T& a) {
+  return dense.class_size(lookup(a, "class_size", "a"));
+}
+
+
+template<class T, int (*thash) (const T& a)>
+std::string InternedEquivalence<T,thash>::str () const {
+  std::ostringstream answer;
+  answer << "InternedEquivalence [" << std::endl;
+  answer << "  ids  : " << ids.str() << std::endl;
+  answer << "  dense: " << dense.str() << "]" << std::endl;
+  return answer.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class T, int (*thash) (const T& a)>
+void InternedEquivalence<T,thash>::reserve (int n) {
+  values.reserve(n);
+  dense.reserve(n);
+}
+
+
+//Throw an EquivalenceError (with a descriptive message) if the parameter a
+//  already a value in the Equivalence (was previously added as a singleton).
+template<class T, int (*thash) (const T& a)>
+void InternedEquivalence<T,thash>::add_singleton (const T& a) {
+  if (ids.has_key(a)) {
+    std::ostringstream answer;
+    answer << "InternedEquivalence::add_singleton a(" << a << ") is already a value in the Equivalence";
+    throw EquivalenceError(answer.str());
+  }
+  ids[a] = values.size();
+  dense.add_singleton(values.size());
+  values.push_back(a);
+}
+
+
+template<class T, int (*thash) (const T& a)>
+void InternedEquivalence<T,thash>::merge_classes_of (const T& a, const T& b) {
+  int ia = lookup(a, "merge_classes_of", "a");
+  int ib = lookup(b, "merge_classes_of", "b");
+  dense.merge_classes_of(ia, ib);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class T, int (*thash) (const T& a)>
+std::ostream& operator << (std::ostream& outs, const InternedEquivalence<T,thash>& e) {
+  outs << "InternedEquivalence [" << std::endl;
+  outs << "  ids map: " << e.ids << std::endl;
+  outs << "  dense  : " << e.dense << "]" << std::endl;
+  return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Helper methods
+
+//Return the id of a (one probe of ids).
+//Throw an EquivalenceError (with a descriptive message) if the parameter a
+//  is not already a value in the Equivalence (was never added as a singleton).
+template<class T, int (*thash) (const T& a)>
+int InternedEquivalence<T,thash>::lookup (const T& a, const char* where, const char* name) const {
+  const int* id = ids.lookup(a);
+  if (id == nullptr) {
+    std::ostringstream answer;
+    answer << "InternedEquivalence::" << where << " " << name << "(" << a << ") is not a value in the Equivalence";
+    throw EquivalenceError(answer.str());
+  }
+  return *id;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Miscellaneous methods (useful for testing/debugging)
+
+template<class T, int (*thash) (const T& a)>
+int InternedEquivalence<T,thash>::max_height () const {
+  return dense.max_height();
+}
+
+
+template<class T, int (*thash) (const T& a)>
+HashMap<T,int> InternedEquivalence<T,thash>::heights () const {
+  HashMap<T,int> answer(1,thash);
+  for (const pair<int,int>& h : dense.heights())
+    answer[values[h.first]] = h.second;
+  return answer;
+}
+
+
+template<class T, int (*thash) (const T& a)>
+std::string InternedEquivalence<T,thash>::equivalence_info () const {
+  std::ostringstream answer;
+  answer << "  ids map    : " << ids          << std::endl;
+  answer << "  heights map: " << heights()    << std::endl;
+  answer << "  max height : " << max_height() << std::endl;
+  return answer.str();
+}
+
+
+}
+
+#endif /* DENSE_EQUIVALENCE_HPP_ */
@@ -1,57 +1,323 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <random>
 #include "ics46goody.hpp"
 #include "stopwatch.hpp"
 #include "ics_exceptions.hpp"
-#include <string>                    // std::hash<std::string>
-#include <random>
-//KLUDGE: Choose
-//#include "array_equivalence.hpp"
+#include "array_equivalence.hpp"
 #include "hash_equivalence.hpp"
-//
-//KLUDGE Choose
-//typedef ics::ArrayEquivalence<int>     TestEquivalence;
+#include "dense_equivalence.hpp"
+#include "concurrent_equivalence.hpp"
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+
+//Benchmark every equivalence implementation over several sizes (N values, all
+//  added as singletons) and merge patterns:
+//  random     : merge_factor*N random pairs
+//  chain      : (0,1), (1,2), ... (N-2,N-1)
+//  star       : (0,1), (0,2), ... (0,N-1)
+//  adversarial: merges of equal-sized classes, round after round: (i,i+1) for
+//                 even i, then (i,i+2) for i a multiple of 4, ...: union by size
+//                 builds trees of the largest possible height, log2(N)
+//Each pattern is run as a merge phase (for each pair: if !in_same_class then
+//  merge_classes_of) followed by a query phase (N random in_same_class calls).
+//For each phase it reports the per-operation latency percentiles (each
+//  operation timed by std::chrono::steady_clock, which adds ~20ns to each),
+//  the class count, max_height after the phase, and the peak memory growth
+//  (Linux only: VmHWM after the run minus VmRSS before it, after returning
+//  freed heap memory to the system and resetting VmHWM through
+//  /proc/self/clear_refs; -1 elsewhere).
+//Results are printed and may also be written as CSV or JSON, for comparing
+//  runs while tuning. Finally (optionally) the random merges are run with a
+//  ConcurrentEquivalence on 1, 2, 4, ... threads. Compile with -O2 -pthread.
+
 int hash_int (const int& s) {std::hash<int> str_hash; return str_hash(s);}
-typedef ics::HashEquivalence<int,hash_int> TestEquivalence;
 
-int main() {
-    int N            = 100000;//ics::prompt_int("Enter N for test (creates N singletons)");
-    int test_times   = 5;//ics::prompt_int("Enter number of times to test (averaged): 5 is good");
-    int merge_factor = 5;//ics::prompt_int("Enter factor (for N) for merges: 5 is good");
+typedef std::vector<std::pair<int,int>> Pairs;
+
+struct Result {
+  std::string implementation, pattern, phase;
+  int    n, operations;
+  double seconds, p50_ns, p90_ns, p99_ns, max_ns;
+  int    classes, max_height;
+  long   peak_kb;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Merge patterns
+
+const char* pattern_names[] = {"random", "chain", "star", "adversarial"};
+
+
+Pairs merge_pairs (const std::string& pattern, int N, int merge_factor, std::default_random_engine& generator) {
+  Pairs answer;
+  if (pattern == "random") {
+    std::uniform_int_distribution<int> distribution(0,N-1);
+    for (int i=0; i<merge_factor*N; ++i) {
+      int m1 = distribution(generator);
+      answer.push_back(std::make_pair(m1, distribution(generator)));
+    }
+  } else if (pattern == "chain") {
+    for (int i=0; i<N-1; ++i)
+      answer.push_back(std::make_pair(i, i+1));
+  } else if (pattern == "star") {
+    for (int i=1; i<N; ++i)
+      answer.push_back(std::make_pair(0, i));
+  } else if (pattern == "adversarial") {
+    for (int step=1; step<N; step*=2)
+      for (int i=0; i+step<N; i+=2*step)
+        answer.push_back(std::make_pair(i, i+step));
+  }
+  return answer;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Memory (Linux /proc; -1 where unavailable)
+
+long memory_kb (const std::string& field) {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line))
+    if (line.compare(0, field.size(), field) == 0)
+      return std::stol(line.substr(field.size()));
+  return -1;
+}
+
+
+void reset_peak_memory () {
+#ifdef __GLIBC__
+  malloc_trim(0);
+#endif
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5" << std::endl;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Measuring one implementation on one pattern
+
+template<class Equivalence>
+Equivalence* create (int N) {
+  Equivalence* e = new Equivalence();
+  for (int i=0; i<N; ++i)
+    e->add_singleton(i);
+  return e;
+}
+
+template<>
+ics::DenseEquivalence* create (int N) {
+  return new ics::DenseEquivalence(N);
+}
+
+template<>
+ics::ConcurrentEquivalence* create (int N) {
+  return new ics::ConcurrentEquivalence(N);
+}
+
+
+double percentile (std::vector<double>& ns, double p) {
+  if (ns.empty())
+    return 0;
+  std::vector<double>::iterator at = ns.begin() + std::min(ns.size()-1, size_t(p*ns.size()));
+  std::nth_element(ns.begin(), at, ns.end());
+  return *at;
+}
+
+
+template<class Equivalence>
+Result time_phase (Equivalence& e, const std::string& name, const std::string& pattern, const std::string& phase,
+                   int N, const Pairs& pairs, bool merge, std::vector<double>& ns, long before_kb) {
+  ns.clear();
+  ics::Stopwatch watch;
+  watch.start();
+  for (const std::pair<int,int>& p : pairs) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (!e.in_same_class(p.first, p.second) && merge)
+      e.merge_classes_of(p.first, p.second);
+    ns.push_back(std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now() - start).count());
+  }
+  watch.stop();
+
+  long peak_kb = memory_kb("VmHWM:");
+  Result r;
+  r.implementation = name;
+  r.pattern        = pattern;
+  r.phase          = phase;
+  r.n              = N;
+  r.operations     = pairs.size();
+  r.seconds        = watch.read();
+  r.p50_ns         = percentile(ns, 0.50);
+  r.p90_ns         = percentile(ns, 0.90);
+  r.p99_ns         = percentile(ns, 0.99);
+  r.max_ns         = percentile(ns, 1.00);
+  r.classes        = e.class_count();
+  r.max_height     = e.max_height();
+  r.peak_kb        = (peak_kb < 0 || before_kb < 0 ? -1 : peak_kb - before_kb);
+  return r;
+}
 
-    //Show as errors in Eclipse, but code will run
+
+template<class Equivalence>
+void measure (std::vector<Result>& results, const std::string& name, int N, int merge_factor) {
+  for (const char* pattern : pattern_names) {
     std::default_random_engine generator;
-    std::uniform_int_distribution<int> distribution(0,N-1);   //0 - 999,999: up to 6 digits
-    try {
-      std::cout << "Add/Merge Classes randomly" << std::endl << std::endl;
-      double total_time = 0;
-      for (int count=1; count<=test_times; ++count) {
-         std::cout << "Test: " << count << " of " << test_times << std::endl;
-         TestEquivalence e;
-         for (int i=0; i<N; ++i)
-           e.add_singleton(i);
-
-         ics::Stopwatch watch;
-         watch.start();
-         //while (e.class_count() != 1) {  //KLUDGE Alternative loop: until 1 class
-         for (int i=0; i<merge_factor*N; ++i) {
-           int m1 = distribution(generator);
-           int m2 = distribution(generator);
-           //std::cout << e.classes() << " merging: " << m1 << "/" << m2 << std::endl;
-           if (!e.in_same_class(m1, m2))
-             e.merge_classes_of(m1, m2);
-         }
-         watch.stop();
-         total_time += watch.read();
-         std::cout << "  # of values (should be " << N << ") = " << e.size() << std::endl;
-         std::cout << "  # of classes = " << e.class_count() << std::endl;
-         std::cout << "  MaxHeight = " << e.max_height() << std::endl;
-         std::cout << "  Time = " << watch.read() << std::endl << std::endl;
-       }
-
-       std::cout << "\nAverage time = " << total_time/test_times << std::endl;
-    } catch (ics::IcsError& e) {
-      std::cout << "  " << e.what() << std::endl;
+    Pairs merges = merge_pairs(pattern, N, merge_factor, generator);
+    Pairs queries;
+    std::uniform_int_distribution<int> distribution(0,N-1);
+    for (int i=0; i<N; ++i) {
+      int q1 = distribution(generator);
+      queries.push_back(std::make_pair(q1, distribution(generator)));
+    }
+
+    std::vector<double> ns(std::max(merges.size(), queries.size()));  //latencies: allocated before measuring memory
+
+    reset_peak_memory();
+    long before_kb = memory_kb("VmRSS:");
+    Equivalence* e = create<Equivalence>(N);
+    results.push_back(time_phase(*e, name, pattern, "merge", N, merges,  true,  ns, before_kb));
+    results.push_back(time_phase(*e, name, pattern, "query", N, queries, false, ns, before_kb));
+    delete e;
+
+    for (int i=results.size()-2; i<int(results.size()); ++i) {
+      const Result& r = results[i];
+      std::cout << "  " << r.implementation << " " << r.pattern << " " << r.phase << ": n = " << r.n
+                << ", time = " << r.seconds << ", p50/p90/p99/max ns = " << r.p50_ns << "/" << r.p90_ns << "/"
+                << r.p99_ns << "/" << r.max_ns << ", classes = " << r.classes << ", MaxHeight = " << r.max_height
+                << ", peak KB = " << r.peak_kb << std::endl;
     }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Writing results
+
+void write_csv (std::ostream& outs, const std::vector<Result>& results) {
+  outs << "implementation,pattern,phase,n,operations,seconds,p50_ns,p90_ns,p99_ns,max_ns,classes,max_height,peak_kb" << std::endl;
+  for (const Result& r : results)
+    outs << r.implementation << "," << r.pattern << "," << r.phase << "," << r.n << "," << r.operations << ","
+         << r.seconds << "," << r.p50_ns << "," << r.p90_ns << "," << r.p99_ns << "," << r.max_ns << ","
+         << r.classes << "," << r.max_height << "," << r.peak_kb << std::endl;
+}
+
+
+void write_json (std::ostream& outs, const std::vector<Result>& results) {
+  outs << "[" << std::endl;
+  for (int i=0; i<int(results.size()); ++i) {
+    const Result& r = results[i];
+    outs << "  {\"implementation\": \"" << r.implementation << "\", \"pattern\": \"" << r.pattern
+         << "\", \"phase\": \"" << r.phase << "\", \"n\": " << r.n << ", \"operations\": " << r.operations
+         << ", \"seconds\": " << r.seconds << ", \"p50_ns\": " << r.p50_ns << ", \"p90_ns\": " << r.p90_ns
+         << ", \"p99_ns\": " << r.p99_ns << ", \"max_ns\": " << r.max_ns << ", \"classes\": " << r.classes
+         << ", \"max_height\": " << r.max_height << ", \"peak_kb\": " << r.peak_kb << "}"
+         << (i+1 < int(results.size()) ? "," : "") << std::endl;
+  }
+  outs << "]" << std::endl;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Concurrent merges
+
+//Merge the same random pairs into a ConcurrentEquivalence, splitting them into
+//  contiguous slices for 1, 2, 4, ... threads (up to the number of cores), and
+//  report the average time and the speedup over 1 thread.
+void concurrent_merges(int N, int merges, int test_times) {
+  int cores = std::max(1u, std::thread::hardware_concurrency());
+  std::default_random_engine generator;
+  std::uniform_int_distribution<int> distribution(0,N-1);
+  std::vector<int> m1(merges), m2(merges);
+  for (int i=0; i<merges; ++i) {
+    m1[i] = distribution(generator);
+    m2[i] = distribution(generator);
+  }
+
+  std::cout << "\nMerge Classes concurrently (" << cores << " cores)" << std::endl;
+  double one_thread_time = 0;
+  for (int threads=1; ; threads = std::min(2*threads, cores)) {
+    double total_time = 0;
+    int classes = 0;
+    for (int count=1; count<=test_times; ++count) {
+      ics::ConcurrentEquivalence e(N);
+      std::vector<std::thread> team;
+      ics::Stopwatch watch;
+      watch.start();
+      for (int t=0; t<threads; ++t)
+        team.push_back(std::thread([&e,&m1,&m2,merges,threads,t] () {
+          for (int i=long(merges)*t/threads; i<long(merges)*(t+1)/threads; ++i)
+            if (!e.in_same_class(m1[i], m2[i]))
+              e.merge_classes_of(m1[i], m2[i]);
+        }));
+      for (std::thread& t : team)
+        t.join();
+      watch.stop();
+      total_time += watch.read();
+      classes = e.class_count();
+    }
+    if (threads == 1)
+      one_thread_time = total_time;
+    std::cout << "  threads = " << threads << ": # of classes = " << classes << ", Average time = "
+              << total_time/test_times << ", speedup = " << one_thread_time/total_time << std::endl;
+    if (threads == cores)
+      break;
+  }
+}
+
+
+int main() {
+  try {
+    std::string sizes  = ics::prompt_string("Enter sizes N to test (separated by spaces)","1000 10000 100000");
+    int array_limit    = ics::prompt_int("Enter largest N for ArrayEquivalence (each operation is O(N))",10000);
+    int merge_factor   = ics::prompt_int("Enter factor (for N) for random merges: 5 is good",5);
+    std::string format = ics::prompt_string("Enter output format (csv, json, or none)","csv");
+    std::string file_name;
+    if (format == "csv" || format == "json")
+      file_name = ics::prompt_string("Enter output file name","equivalence_benchmark."+format);
+    bool concurrent    = ics::prompt_bool("Also time concurrent merges on 1, 2, 4, ... threads",true);
+
+    std::vector<Result> results;
+    std::istringstream size_stream(sizes);
+    int N, largest = 0;
+    while (size_stream >> N) {
+      largest = std::max(largest, N);
+      std::cout << "\nN = " << N << std::endl;
+      if (N <= array_limit)
+        measure<ics::ArrayEquivalence<int>>             (results, "ArrayEquivalence",      N, merge_factor);
+      measure<ics::HashEquivalence<int,hash_int>>       (results, "HashEquivalence",       N, merge_factor);
+      measure<ics::InternedEquivalence<int,hash_int>>   (results, "InternedEquivalence",   N, merge_factor);
+      measure<ics::DenseEquivalence>                    (results, "DenseEquivalence",      N, merge_factor);
+      measure<ics::ConcurrentEquivalence>               (results, "ConcurrentEquivalence", N, merge_factor);
+    }
+
+    if (!file_name.empty()) {
+      std::ofstream out_file(file_name);
+      if (format == "csv")
+        write_csv(out_file, results);
+      else
+        write_json(out_file, results);
+      std::cout << "\nWrote " << results.size() << " results to " << file_name << std::endl;
+    }
+
+    if (concurrent && largest > 0)
+      concurrent_merges(largest, merge_factor*largest, 5);
+  } catch (ics::IcsError& e) {
+    std::cout << "  " << e.what() << std::endl;
+  }
+
+  return 0;
 }
@@ -2,9 +2,12 @@
 #define HASH_EQUIVALENCE_HPP_
 
 #include <sstream>
+#include <vector>
+#include <algorithm>
 #include "ics_exceptions.hpp"
 #include "hash_map.hpp"
 #include "hash_set.hpp"
+#include "class_groups.hpp"
 
 
 namespace ics {
@@ -12,6 +15,12 @@ namespace ics {
 
 //HashEquivalence must be instantiated with a legal thash function (there is no default)
 //  The classes() method must use a hash that in instantiated in the template
+//Each value maps to one Node holding its parent, the next value in its class's
+//  ring, its class's size (at a root), and a pointer to its parent's Node; so
+//  one hash probe resolves a value, and finding its root (with compression) and
+//  merging follow pointers with no further probes: a merge costs 2 probes.
+//merge_all/in_same_class_all resolve every value in a batch before changing
+//  anything (so a bad value throws with the Equivalence unchanged).
 template<class T, int (*thash) (const T& a)> class HashEquivalence {
   public:
     //Destructor/Constructors
@@ -31,15 +40,25 @@ template<class T, int (*thash) (const T& a)> class HashEquivalence {
     int                 size          () const;                 // number of values in all Equivalences
     int                 class_count   () const;                 // number of Equivalences
     HashSet<HashSet<T,thash>> classes ();                       // Not const because compression used
+    ClassGroups<T>      class_groups  () const;                 // all classes, O(size())
+    HashSet<T,thash>    class_of      (const T& a) const;       // a's class, O(its size)
+    int                 class_size    (const T& a);             // Not const because compression
+    //Iterable of pairs (.first/.second), e.g., std::vector<pair<T,T>>; answer[i] is for the ith pair
+    template <class Iterable>
+    std::vector<bool>   in_same_class_all (const Iterable& pairs);  // Not const because compression
     std::string str                   () const; //supplies useful debugging information; contrast to operator <<
 
 
     //Commands
     void add_singleton    (const T& a);
     void merge_classes_of (const T& a, const T& b);
+    template <class Iterable>
+    int  merge_all        (const Iterable& pairs);  // returns number of merges that joined 2 classes
 
 
     //Operators
+    HashEquivalence<T,thash>& operator = (const HashEquivalence<T,thash>& rhs);
+
     template<class T2, int (*thash2) (const T2& a)>
     friend std::ostream& operator << (std::ostream& outs, const HashEquivalence<T2,thash2>& e);
 
@@ -50,11 +69,27 @@ template<class T, int (*thash) (const T& a)> class HashEquivalence {
     std::string equivalence_info () const;
 
   private:
-    HashMap<T,T>   parent;
-    HashMap<T,int> root_size;
+    struct Node {
+      T     parent;
+      T     next;             //links the values of each class into a ring
+      int   size = 1;         //meaningful only at roots
+      Node* up   = nullptr;   //parent's Node (this at a root); nodes are never erased
+
+      friend std::ostream& operator << (std::ostream& outs, const Node& n) {
+        return outs << "(" << n.parent << "," << n.next << "," << n.size << ")";
+      }
+    };
+
+    HashMap<T,Node> nodes;
+    int             roots = 0;
 
     //Helper methods
-    T compress_to_root (T a);
+    Node* node_of          (const T& a, const char* where, const char* name);
+    Node* compress_to_root (Node* n);
+    bool  merge_nodes      (Node* a, Node* b);
+    void  link_up          ();
+    template <class Iterable>
+    std::vector<std::pair<Node*,Node*>> resolve_all (const Iterable& pairs, const char* where);
 };
 
 
@@ -74,19 +109,20 @@ HashEquivalence<T,thash>::~HashEquivalence ()
 
 template<class T, int (*thash) (const T& a)>
 HashEquivalence<T,thash>::HashEquivalence(double the_load_threshold)
-: parent(the_load_threshold,thash), root_size(the_load_threshold,thash) {
+: nodes(the_load_threshold,thash) {
 }
 
 
 template<class T, int (*thash) (const T& a)>
 HashEquivalence<T,thash>::HashEquivalence (const HashEquivalence<T,thash>& to_copy, double the_load_threshold)
-: parent(to_copy.parent,the_load_threshold,thash), root_size(to_copy.root_size,the_load_threshold,thash) {
+: nodes(to_copy.nodes,the_load_threshold,thash), roots(to_copy.roots) {
+  link_up();
 }
 
 
 template<class T, int (*thash) (const T& a)>
 HashEquivalence<T,thash>::HashEquivalence (const std::initializer_list<T>& il, double the_load_threshold)
-: parent(the_load_threshold,thash), root_size(the_load_threshold,thash) {
+: nodes(the_load_threshold,thash) {
   for (const T& v : il)
     add_singleton(v);
 }
@@ -95,7 +131,7 @@ HashEquivalence<T,thash>::HashEquivalence (const std::initializer_list<T>& il, d
 template<class T, int (*thash) (const T& a)>
 template <class Iterable>
 HashEquivalence<T,thash>::HashEquivalence (const Iterable& i, double the_load_threshold)
-:  parent(the_load_threshold,thash), root_size(the_load_threshold,thash) {
+:  nodes(the_load_threshold,thash) {
   for (const T& v : i)
     add_singleton(v);
 }
@@ -113,21 +149,9 @@ HashEquivalence<T,thash>::HashEquivalence (const Iterable& i, double the_load_th
 //  is not already a value in the Equivalence (were never added as singletons).
 template<class T, int (*thash) (const T& a)>
 bool HashEquivalence<T,thash>::in_same_class (const T& a, const T& b) {
-    if (!parent.has_key(a)) {
-        std::ostringstream answer;
-        answer << "HashEqivalence::in_same_class a(" << a << ") is not a value in the Equivalence";
-        throw EquivalenceError(answer.str());
-    }
-
-    if (!parent.has_key(b)) {
-        std::ostringstream answer;
-        answer << "HashEqivalence::in_same_class b(" << b << ") is not a value in the Equivalence";
-        throw EquivalenceError(answer.str());
-    }
-
-    T f = compress_to_root(a);
-    T s = compress_to_root(b);
-    return (f == s);
+    Node* f = node_of(a, "in_same_class", "a");
+    Node* s = node_of(b, "in_same_class", "b");
+    return compress_to_root(f) == compress_to_root(s);
 
 //      T next = a;
 //      T next1 = b;
@@ -147,7 +171,7 @@ bool HashEquivalence<T,thash>::in_same_class (const T& a, const T& b) {
 //  d,e are equivalent, size returns 5.
 template<class T, int (*thash) (const T& a)>
 int HashEquivalence<T,thash>::size () const{
-  return parent.size();
+  return nodes.size();
 }
 
 
@@ -155,7 +179,7 @@ int HashEquivalence<T,thash>::size () const{
 //  d,e are equivalent, class_count returns 2.
 template<class T, int (*thash) (const T& a)>
 int HashEquivalence<T,thash>::class_count () const{
-  return root_size.size();
+  return roots;
 }
 
 
@@ -168,16 +192,16 @@ template<class T, int (*thash) (const T& a)>
 HashSet<HashSet<T,thash>> HashEquivalence<T,thash>::classes () {
     typedef HashSet<T, thash> Set;
     HashMap<T, Set> map(1, thash);
-    for (auto i : parent) {
-        auto r = compress_to_root(i.first);
+    for (auto i : nodes) {
+        auto r = compress_to_root(nodes.lookup(i.first))->parent;
         map[r].insert(i.first);
     }
 
     HashSet<HashSet<T,thash>> result(1, []( const HashSet<T,thash> &s) {
-        int total = 1;
+        unsigned total = 1;
         for (auto i : s) {
-            total = total * thash(i);
-        } return total;
+            total = total * unsigned(thash(i));
+        } return int(total);
     });
     for (auto i : map) {
         result.insert(i.second);
@@ -185,12 +209,75 @@ HashSet<HashSet<T,thash>> HashEquivalence<T,thash>::classes () {
 }
 
 
+//Walk the ring of each root (a value that is its own parent), appending its
+//  values as one class; every value is visited once and nothing is compressed.
+template<class T, int (*thash) (const T& a)>
+ClassGroups<T> HashEquivalence<T,thash>::class_groups () const {
+  ClassGroups<T> answer;
+  answer.values.reserve(nodes.size());
+  answer.offsets.reserve(roots+1);
+  for (const pair<T,Node>& r : nodes)
+    if (r.second.parent == r.first) {
+      T v = r.first;
+      do {
+        answer.add(v);
+        v = nodes[v].next;
+      } while (v != r.first);
+      answer.end_class();
+    }
+  return answer;
+}
+
+
+//Walk the ring starting at a, collecting the values in a's class.
+//Throw an EquivalenceError (with a descriptive message) if the parameter a
+//  is not already a value in the Equivalence (was never added as a singleton).
+template<class T, int (*thash) (const T& a)>
+HashSet<T,thash> HashEquivalence<T,thash>::class_of (const T& a) const {
+  const Node* n = nodes.lookup(a);
+  if (n == nullptr) {
+    std::ostringstream answer;
+    answer << "HashEqivalence::class_of a(" << a << ") is not a value in the Equivalence";
+    throw EquivalenceError(answer.str());
+  }
+  HashSet<T,thash> answer;
+  answer.insert(a);
+  for (T v = n->next; v != a; v = nodes[v].next)
+    answer.insert(v);
+  return answer;
+}
+
+
+//Throw an EquivalenceError (with a descriptive message) if the parameter a
+//  is not already a value in the Equivalence (was never added as a singleton).
+template<class T, int (*thash) (const T& a)>
+int HashEquivalence<T,thash>::class_size (const T& a) {
+  return compress_to_root(node_of(a, "class_size", "a"))->size;
+}
+
+
+//Answer for every pair whether its values are in the same class; all values
+//  are resolved (1 probe each) before any is compressed.
+//Throw an EquivalenceError (with a descriptive message) if any value in a pair
+//  is not already a value in the Equivalence (was never added as a singleton).
+template<class T, int (*thash) (const T& a)>
+template <class Iterable>
+std::vector<bool> HashEquivalence<T,thash>::in_same_class_all (const Iterable& pairs) {
+  std::vector<std::pair<Node*,Node*>> resolved = resolve_all(pairs, "in_same_class_all");
+  std::vector<bool> answer;
+  answer.reserve(resolved.size());
+  for (const std::pair<Node*,Node*>& p : resolved)
+    answer.push_back(compress_to_root(p.first) == compress_to_root(p.second));
+  return answer;
+}
+
+
 template<class T, int (*thash) (const T& a)>
 std::string HashEquivalence<T,thash>::str () const {
   std::ostringstream answer;
   answer << "HashEquivalence [" << std::endl;
-  answer << "  parent   : " << parent.str() << std::endl;
-  answer << "  root_size: " << root_size.str() << "]" << std::endl;
+  answer << "  nodes(parent,next,size): " << nodes.str() << std::endl;
+  answer << "  classes: " << roots << "]" << std::endl;
   return answer.str();
 }
 
@@ -204,13 +291,16 @@ std::string HashEquivalence<T,thash>::str () const {
 //  already a value in the Equivalence (was previously added as a singleton).
 template<class T, int (*thash) (const T& a)>
 void HashEquivalence<T,thash>::add_singleton (const T& a) {
-  if (parent.has_key(a)) {
+  if (nodes.has_key(a)) {
       std::ostringstream answer;
       answer << "HashEqivalence::add_singleton a(" << a << ") is already a value in the Equivalence";
       throw EquivalenceError(answer.str());
   } else {
-      parent[a] = a;
-      root_size[a] = 1;
+      Node& n = nodes[a];
+      n.parent = a;
+      n.next   = a;
+      n.up     = &n;
+      ++roots;
   }
 }
 
@@ -218,40 +308,33 @@ void HashEquivalence<T,thash>::add_singleton (const T& a) {
 //Compress a and b to their roots.
 //If they are in different equivalence classes, make the parent of the
 //  root of the smaller-sized equivalence class refer to the root of the larger-
-//  sized equivalence class; update the size of the root of the larger equivalence
-//  class and remove the root of the smaller equivalence class from the root_size
+//  sized equivalence class and update the size of the root of the larger
+//  equivalence class; swapping the next values of the two roots splices their
+//  rings into one ring
 //Throw an EquivalenceError (with a descriptive message) if the parameter a or b
 //  is not already a value in the Equivalence (were never added as singletons)
 template<class T, int (*thash) (const T& a)>
 void HashEquivalence<T,thash>::merge_classes_of (const T& a, const T& b) {
-    if (!parent.has_key(a)) {
-        std::ostringstream answer;
-        answer << "HashEqivalence::merge_classes_of a(" << a << ") is not a value in the Equivalence";
-        throw EquivalenceError(answer.str());
-    } if (!parent.has_key(b)) {
-        std::ostringstream answer;
-        answer << "HashEqivalence::merge_classes_of b(" << b << ") is not a value in the Equivalence";
-        throw EquivalenceError(answer.str());
-    }
-    else {
-        T aParent = compress_to_root(a);
-        T bParent = compress_to_root(b);
-        if (aParent != bParent) {
-            if (root_size[aParent] < root_size[bParent]) {
-                parent[aParent] = bParent;
-                auto total = root_size[bParent] + root_size[aParent];
-                root_size[bParent] = total;
-                root_size.erase(aParent);
-            } else {
-                parent[bParent] = aParent;
-                auto total = root_size[bParent] + root_size[aParent];
-                root_size[aParent] = total;
-                root_size.erase(bParent);
-            }
-        } else {
-            return;
-        }
-    }
+    Node* aNode = node_of(a, "merge_classes_of", "a");
+    Node* bNode = node_of(b, "merge_classes_of", "b");
+    merge_nodes(aNode, bNode);
+}
+
+
+//Resolve every value (1 probe each) before merging anything, then merge the
+//  resolved nodes in the given order: sorting them by address (to visit nodes
+//  in memory order) was measured to cost more than it saved.
+//Throw an EquivalenceError (with a descriptive message) if any value in a pair
+//  is not already a value in the Equivalence (was never added as a singleton);
+//  the Equivalence is then unchanged.
+template<class T, int (*thash) (const T& a)>
+template <class Iterable>
+int HashEquivalence<T,thash>::merge_all (const Iterable& pairs) {
+  std::vector<std::pair<Node*,Node*>> resolved = resolve_all(pairs, "merge_all");
+  int merged = 0;
+  for (const std::pair<Node*,Node*>& p : resolved)
+    merged += merge_nodes(p.first, p.second);
+  return merged;
 }
 
 
@@ -260,11 +343,23 @@ void HashEquivalence<T,thash>::merge_classes_of (const T& a, const T& b) {
 //
 //Operators
 
+//Copy the nodes, then point each node's up at its parent's node in this copy
+template<class T, int (*thash) (const T& a)>
+HashEquivalence<T,thash>& HashEquivalence<T,thash>::operator = (const HashEquivalence<T,thash>& rhs) {
+  if (this == &rhs)
+    return *this;
+  nodes = rhs.nodes;
+  roots = rhs.roots;
+  link_up();
+  return *this;
+}
+
+
 template<class T, int (*thash) (const T& a)>
 std::ostream& operator << (std::ostream& outs, const HashEquivalence<T,thash>& e) {
   outs << "HashEquivalence [" << std::endl;
-  outs << "  parent map   : " << e.parent << std::endl;
-  outs << "  root_size map: " << e.root_size << "]" << std::endl;
+  outs << "  nodes map(parent,next,size): " << e.nodes << std::endl;
+  outs << "  classes: " << e.roots << "]" << std::endl;
   return outs;
 }
 
@@ -273,31 +368,79 @@ std::ostream& operator << (std::ostream& outs, const HashEquivalence<T,thash>& e
 //
 //Helper methods
 
-//Call compress_to_root as a helper method in_same_class and merge_classes_of.
-//When finished, a and all its ancestors (but not descendants) should refer
-//  (in the parent map) directly to the root of a's equivalence class.
+//Return a's node: the only hash probe needed to find a's root or merge its class.
 //Throw an EquivalenceError (with a descriptive message) if the parameter a
 //  is not already a value in the Equivalence (was never added as a singleton).
 template<class T, int (*thash) (const T& a)>
-T HashEquivalence<T,thash>::compress_to_root (T a) {
-      if (!parent.has_key(a)) {
-          std::ostringstream answer;
-          answer << "HashEqivalence::compress_to_root a(" << a << ") is not a value in the Equivalence";
-          throw EquivalenceError(answer.str());
-      } else {
-          HashSet<T> set(1, thash);
-          T next = a;
-          while (parent[next] != next) {
-              set.insert(next);
-              next = parent[next];
-          } //when we break out of while loop. next should be the root
-
-          for (auto i : set) {
-              parent[i] = next; //update all ancestors to have next as it's parent
-          }
-          return next; //return the root value
-      }
+auto HashEquivalence<T,thash>::node_of (const T& a, const char* where, const char* name) -> Node* {
+  Node* n = nodes.lookup(a);
+  if (n == nullptr) {
+    std::ostringstream answer;
+    answer << "HashEqivalence::" << where << " " << name << "(" << a << ") is not a value in the Equivalence";
+    throw EquivalenceError(answer.str());
+  }
+  return n;
+}
 
+
+//Call compress_to_root as a helper method in_same_class and merge_classes_of.
+//When finished, n and all its ancestors (but not descendants) should refer
+//  (by parent and up) directly to the root of n's equivalence class, whose
+//  node is returned. Following up needs no hash probes.
+template<class T, int (*thash) (const T& a)>
+auto HashEquivalence<T,thash>::compress_to_root (Node* n) -> Node* {
+  Node* root = n;
+  while (root->up != root)
+    root = root->up;
+
+  while (n->up != root) {
+    Node* up = n->up;
+    n->parent = root->parent;
+    n->up     = root;
+    n = up;
+  }
+  return root;
+}
+
+
+//Merge the classes of two resolved nodes (see merge_classes_of); return
+//  whether they were in different classes
+template<class T, int (*thash) (const T& a)>
+bool HashEquivalence<T,thash>::merge_nodes (Node* a, Node* b) {
+  a = compress_to_root(a);
+  b = compress_to_root(b);
+  if (a == b)
+    return false;
+  if (a->size < b->size)
+    std::swap(a, b);
+  b->parent = a->parent;
+  b->up     = a;
+  a->size  += b->size;
+  std::swap(a->next, b->next);
+  --roots;
+  return true;
+}
+
+
+//After copying nodes, each up still points into the copied-from map
+template<class T, int (*thash) (const T& a)>
+void HashEquivalence<T,thash>::link_up () {
+  for (const pair<T,Node>& e : nodes) {
+    Node* n = nodes.lookup(e.first);
+    n->up = nodes.lookup(n->parent);
+  }
+}
+
+
+//Resolve both values of every pair, throwing (before any node is changed) for
+//  the first value that is not in the Equivalence
+template<class T, int (*thash) (const T& a)>
+template <class Iterable>
+auto HashEquivalence<T,thash>::resolve_all (const Iterable& pairs, const char* where) -> std::vector<std::pair<Node*,Node*>> {
+  std::vector<std::pair<Node*,Node*>> answer;
+  for (const auto& p : pairs)
+    answer.push_back(std::make_pair(node_of(p.first, where, "a"), node_of(p.second, where, "b")));
+  return answer;
 }
 
 
@@ -323,28 +466,27 @@ HashMap<T,int> HashEquivalence<T,thash>::heights () const {
   //Compute the depth of every node by tracing a path to its root;
   //  update the answer/height of the root if it is larger
   HashMap<T,int> answer(1,thash);
-  for (const pair<T,T>& np : parent) {
-    T e = np.first;
+  for (const pair<T,Node>& np : nodes) {
+    const Node* e = &np.second;
     int depth = 0;
-    while (parent[e] != e) {
-      e = parent[e];
+    while (e->up != e) {
+      e = e->up;
       depth++;
     }
-    if ( answer[e] < depth)
-      answer[e] = depth;
+    if ( answer[e->parent] < depth)
+      answer[e->parent] = depth;
   }
 
   return answer;
 }
 
 
-//Return string containing the parent, root_size, and height maps amd the maximum
+//Return string containing the nodes (parent, next, size) and height maps amd the maximum
 //  height of any equivalence tree
 template<class T, int (*thash) (const T& a)>
 std::string HashEquivalence<T,thash>::equivalence_info () const {
   std::ostringstream answer;
-  answer << "  parent map   : " << parent       << std::endl;
-  answer << "  root_size map: " << root_size    << std::endl;
+  answer << "  nodes map    : " << nodes        << std::endl;
   answer << "  heights map  : " << heights()    << std::endl;
   answer << "  max height   : " << max_height() << std::endl;
 
@@ -44,6 +44,8 @@ template<class KEY,class T, int (*thash)(const KEY& a) = undefinedhash<KEY>> cla
     bool empty      () const;
     int  size       () const;
     bool has_key    (const KEY& key) const;
+    T*       lookup (const KEY& key);       //nullptr if key not in Map: one probe
+    const T* lookup (const KEY& key) const; //  (valid until any key is erased, or the Map cleared/assigned)
     bool has_value  (const T& value) const;
     std::string str () const; //supplies useful debugging information; contrast to operator <<
 
@@ -270,6 +272,23 @@ bool HashMap<KEY,T,thash>::has_key (const KEY& key) const {
 }
 
 
+//Rehashing relinks (doesn't copy) the LNs, so the pointer stays valid as other
+//  keys are put; erase copies the next LN in the bin over the erased one, so
+//  erasing any key may invalidate it
+template<class KEY,class T, int (*thash)(const KEY& a)>
+T* HashMap<KEY,T,thash>::lookup (const KEY& key) {
+  LN* c = find_key(key);
+  return c == nullptr ? nullptr : &c->value.second;
+}
+
+
+template<class KEY,class T, int (*thash)(const KEY& a)>
+const T* HashMap<KEY,T,thash>::lookup (const KEY& key) const {
+  LN* c = find_key(key);
+  return c == nullptr ? nullptr : &c->value.second;
+}
+
+
 template<class KEY,class T, int (*thash)(const KEY& a)>
 bool HashMap<KEY,T,thash>::has_value (const T& value) const {
   for (int b=0; b<bins; ++b)
@@ -0,0 +1,320 @@
+#ifndef ALT_INDEX_HPP_
+#define ALT_INDEX_HPP_
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <limits>
+#include <stdexcept>
+#include "ics_exceptions.hpp"
+#include "ics46goody.hpp"
+#include "hash_map.hpp"
+#include "hash_graph.hpp"
+#include "csr_graph.hpp"
+#include "dijkstra.hpp"
+
+
+namespace ics {
+
+
+//An ALTIndex (A*, Landmarks, Triangle inequality) speeds up repeated
+//  point-to-point queries on a fixed graph. It stores, for each of k
+//  landmark nodes L, the cost d(L,v) from L to every node v and d(v,L) from
+//  every v to L. By the triangle inequality, for any nodes u and t
+//    d(u,t) >= d(L,t) - d(L,u)    and    d(u,t) >= d(u,L) - d(t,L)
+//  so the largest of these over all landmarks is a lower bound on the cost
+//  still to go; A* guided by it settles far fewer nodes than Dijkstra, and
+//  the bound never overestimates, so its answers are still cheapest paths.
+//Landmarks are chosen by farthest-point selection: each next landmark is the
+//  node whose cost from the nearest landmark already chosen is largest, so
+//  they end up spread around the edges of the graph.
+//The index describes the graph it was built from; rebuild it after the graph
+//  changes (queries stay correct only if no edge got cheaper).
+class ALTIndex {
+  public:
+    //The A* heuristic for queries to one stop node: caches the stop node's
+    //  landmark costs, so each call looks up only the current node's
+    class Heuristic {
+      public:
+        Heuristic(const ALTIndex& index, const std::string& stop_node);
+        int operator () (const std::string& node, const std::string& stop_node) const;
+
+      private:
+        const ALTIndex*  index;
+        std::vector<int> from_landmark_to_stop;    //d(L,stop) for each landmark L
+        std::vector<int> from_stop_to_landmark;    //d(stop,L) for each landmark L
+    };
+
+    enum {unreachable = -1};                     //Table entry when there is no path
+
+    //Destructor/Constructors
+    ~ALTIndex();
+    ALTIndex();
+    ALTIndex(const DistGraph& g, int landmark_count);
+
+    //Queries
+    int landmark_count ()                                           const;
+    const std::vector<std::string>& landmarks ()                    const;
+    int lower_bound    (const std::string& node, const std::string& stop_node) const;
+
+    //Same answer as bidirectional_shortest_path(g,start,stop), settling fewer nodes
+    template<class Graph>
+    PathQuery query(const Graph& g, std::string start_node, std::string stop_node) const;
+
+    //Commands
+    void build (const DistGraph& g, int landmark_count);
+    void load  (std::ifstream& in_file,  std::string separator = ";");
+    void store (std::ofstream& out_file, std::string separator = ";") const;
+
+  private:
+    typedef HashMap<std::string, int, DistGraph::hash_str> IdMap;
+
+    std::vector<std::string>      names;              //names[id]: ids are those of the frozen graph
+    IdMap                         ids;
+    std::vector<std::string>      landmark_names;
+    std::vector<std::vector<int>> from_landmark;      //from_landmark[l][id] = d(landmark l, id)
+    std::vector<std::vector<int>> to_landmark;        //to_landmark[l][id]   = d(id, landmark l)
+
+    int  find_id (const std::string& node) const;    //-1 if node is not in the index
+    void reset   ();
+    static int parse_int (const std::string& field, const std::string& what);
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//ALTIndex::Heuristic
+
+ALTIndex::Heuristic::Heuristic(const ALTIndex& index, const std::string& stop_node)
+: index(&index) {
+      int t = index.find_id(stop_node);
+      for (int l = 0; l < index.landmark_count(); ++l) {
+          from_landmark_to_stop.push_back(t == -1 ? unreachable : index.from_landmark[l][t]);
+          from_stop_to_landmark.push_back(t == -1 ? unreachable : index.to_landmark[l][t]);
+      }
+}
+
+
+//A bound is used only when both of its costs exist; each one alone is
+//  consistent along every edge on a path to the stop node, so their maximum is
+int ALTIndex::Heuristic::operator () (const std::string& node, const std::string& /*stop_node*/) const {
+      int u = index->find_id(node);
+      if (u == -1)
+          return 0;
+
+      int bound = 0;
+      for (int l = 0; l < int(from_landmark_to_stop.size()); ++l) {
+          int lu = index->from_landmark[l][u];
+          if (lu != unreachable && from_landmark_to_stop[l] != unreachable && from_landmark_to_stop[l] - lu > bound)
+              bound = from_landmark_to_stop[l] - lu;
+          int ul = index->to_landmark[l][u];
+          if (ul != unreachable && from_stop_to_landmark[l] != unreachable && ul - from_stop_to_landmark[l] > bound)
+              bound = ul - from_stop_to_landmark[l];
+      }
+      return bound;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//ALTIndex: Destructor/Constructors
+
+ALTIndex::~ALTIndex()
+{}
+
+
+ALTIndex::ALTIndex()
+{}
+
+
+ALTIndex::ALTIndex(const DistGraph& g, int landmark_count) {
+      build(g, landmark_count);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//ALTIndex: Queries
+
+int ALTIndex::landmark_count() const {
+      return landmark_names.size();
+}
+
+
+const std::vector<std::string>& ALTIndex::landmarks() const {
+      return landmark_names;
+}
+
+
+int ALTIndex::lower_bound(const std::string& node, const std::string& stop_node) const {
+      return Heuristic(*this, stop_node)(node, stop_node);
+}
+
+
+template<class Graph>
+PathQuery ALTIndex::query(const Graph& g, std::string start_node, std::string stop_node) const {
+      return astar_search(g, start_node, stop_node, Heuristic(*this, stop_node));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//ALTIndex: Commands
+
+//Run csr_dijkstra from each landmark on the frozen graph (costs from it) and on
+//  the frozen graph with every edge reversed (costs to it). The first landmark
+//  is the node farthest from node 0; a node unreachable from every landmark
+//  chosen so far counts as farthest of all.
+void ALTIndex::build(const DistGraph& g, int landmark_count) {
+      reset();
+      CSRGraph<int> forward = g.freeze();
+      int n = forward.node_count();
+      names.reserve(n);
+      for (int id = 0; id < n; ++id) {
+          names.push_back(forward.node_name(id));
+          ids[names[id]] = id;
+      }
+      if (n == 0)
+          return;
+
+      std::vector<int> origins, destinations, values;
+      for (int u = 0; u < n; ++u)
+          for (int e = forward.out_begin(u); e < forward.out_end(u); ++e) {
+              origins.push_back(forward.target(e));
+              destinations.push_back(u);
+              values.push_back(forward.value(e));
+          }
+      CSRGraph<int> backward(names, origins, destinations, values);
+
+      const int infinity = std::numeric_limits<int>::max();
+      std::vector<int> cost, from;
+      csr_dijkstra(forward, 0, cost, from);
+      std::vector<int> nearest(cost);               //Cost from the nearest landmark (or from node 0 at first)
+
+      for (int l = 0; l < landmark_count && l < n; ++l) {
+          int landmark = 0;
+          for (int v = 1; v < n; ++v)
+              if (nearest[v] > nearest[landmark])
+                  landmark = v;
+          if (nearest[landmark] == 0 && l > 0)
+              break;                                //Every node is already a landmark
+
+          landmark_names.push_back(names[landmark]);
+          csr_dijkstra(forward, landmark, cost, from);
+          from_landmark.push_back(cost);
+          csr_dijkstra(backward, landmark, cost, from);
+          to_landmark.push_back(cost);
+
+          for (int v = 0; v < n; ++v) {
+              int& f = from_landmark.back()[v];
+              int& t = to_landmark.back()[v];
+              nearest[v] = (l == 0 ? f : std::min(nearest[v], f));
+              if (f == infinity) f = unreachable;
+              if (t == infinity) t = unreachable;
+          }
+      }
+}
+
+
+//File format (separator between fields):
+//  landmarks;k
+//  k lines, each a landmark name
+//  one line per node: name;d(L0,node);d(node,L0);d(L1,node);d(node,L1);...
+//  where -1 means there is no path
+//A malformed file (bad numbers, duplicate node lines, or a landmark with no
+//  node line) throws GraphError
+void ALTIndex::load(std::ifstream& in_file, std::string separator) {
+      reset();
+      std::string line;
+      if (!getline(in_file, line) || line.find("landmarks" + separator) != 0)
+          throw GraphError("ALTIndex::load: missing landmarks header");
+      int k = parse_int(line.substr(9 + separator.size()), "landmark count");
+      if (k < 0 || k > (std::numeric_limits<int>::max() - 1) / 2)
+          throw GraphError("ALTIndex::load: bad landmark count(" + std::to_string(k) + ")");
+      for (int l = 0; l < k; ++l) {
+          if (!getline(in_file, line))
+              throw GraphError("ALTIndex::load: missing landmark name");
+          landmark_names.push_back(line);
+      }
+
+      from_landmark.assign(k, std::vector<int>());
+      to_landmark.assign(k, std::vector<int>());
+      while (getline(in_file, line)) {
+          std::vector<std::string> fields = ics::split(line, separator);
+          if (int(fields.size()) != 1 + 2*k) {
+              std::ostringstream answer;
+              answer << "ALTIndex::load: line for node(" << fields[0] << ") has " << fields.size() << " fields; expected " << 1 + 2*k;
+              throw GraphError(answer.str());
+          }
+          if (ids.has_key(fields[0]))
+              throw GraphError("ALTIndex::load: duplicate line for node(" + fields[0] + ")");
+          ids[fields[0]] = names.size();
+          names.push_back(fields[0]);
+          for (int f = 1; f < 1 + 2*k; ++f) {
+              int cost = parse_int(fields[f], "cost for node(" + fields[0] + ")");
+              if (cost < unreachable)
+                  throw GraphError("ALTIndex::load: negative cost for node(" + fields[0] + ")");
+              (f % 2 == 1 ? from_landmark : to_landmark)[(f - 1) / 2].push_back(cost);
+          }
+      }
+      for (const std::string& l : landmark_names)
+          if (!ids.has_key(l))
+              throw GraphError("ALTIndex::load: landmark(" + l + ") has no node line");
+}
+
+
+void ALTIndex::store(std::ofstream& out_file, std::string separator) const {
+      out_file << "landmarks" << separator << landmark_count() << std::endl;
+      for (const std::string& l : landmark_names)
+          out_file << l << std::endl;
+
+      for (int id = 0; id < int(names.size()); ++id) {
+          out_file << names[id];
+          for (int l = 0; l < landmark_count(); ++l)
+              out_file << separator << from_landmark[l][id] << separator << to_landmark[l][id];
+          out_file << std::endl;
+      }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//ALTIndex: Private helper methods
+
+int ALTIndex::find_id(const std::string& node) const {
+      return ids.has_key(node) ? ids[node] : -1;
+}
+
+
+//std::stoi, but anything other than a whole int (std::stoi throws
+//  invalid_argument or out_of_range, or stops early) throws GraphError
+int ALTIndex::parse_int(const std::string& field, const std::string& what) {
+      std::size_t used = 0;
+      int value = 0;
+      try {
+          value = std::stoi(field, &used);
+      } catch (std::invalid_argument&) {
+      } catch (std::out_of_range&) {
+      }
+      if (used == 0 || used != field.size())
+          throw GraphError("ALTIndex::load: bad " + what + "(" + field + ")");
+      return value;
+}
+
+
+void ALTIndex::reset() {
+      names.clear();
+      ids.clear();
+      landmark_names.clear();
+      from_landmark.clear();
+      to_landmark.clear();
+}
+
+
+}
+
+#endif /* ALT_INDEX_HPP_ */
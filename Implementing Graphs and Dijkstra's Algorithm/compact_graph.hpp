@@ -0,0 +1,598 @@
+#ifndef COMPACT_GRAPH_HPP_
+#define COMPACT_GRAPH_HPP_
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>                 //std::sort (operator <<)
+#include "ics_exceptions.hpp"
+#include "ics46goody.hpp"
+#include "pair.hpp"
+#include "hash_map.hpp"
+#include "csr_graph.hpp"
+
+
+namespace ics {
+
+
+//A CompactGraph supports the same queries and commands as HashGraph, but each
+//  node keeps just two arrays: its out-edges as (destination,value) and its
+//  in-edges as (origin); the node and edge sets of HashGraph's LocalInfo are
+//  replaced by views over these arrays. Node names are interned as int ids
+//  (the ids of removed nodes are reused), and one map from (origin,destination)
+//  ids to the edge's position in its origin's out array makes has_edge and
+//  edge_value O(1) expected. Every out-entry records the position of its twin
+//  in-entry (and vice versa), so an edge is removed in O(1) by moving the last
+//  entry of each array into its place: add_edge/remove_edge are O(1)
+//  expected and remove_node is O(degree).
+template<class T>
+class CompactGraph {
+  public:
+    //Typedefs
+    typedef std::string              NodeName;
+    typedef pair<NodeName, NodeName> Edge;
+
+    static int hash_str(const NodeName& s) {
+      std::hash<std::string> str_hash;
+      return str_hash(s);
+    }
+
+    //Edge keys pack the origin id (high 32 bits) and destination id (low)
+    static int hash_edge_key(const long long& k) {
+      unsigned long long x = k;
+      x ^= x >> 33;
+      x *= 0xff51afd7ed558ccdULL;
+      x ^= x >> 33;
+      return int(x);
+    }
+
+    typedef HashMap<NodeName, int, hash_str>       IdMap;
+    typedef HashMap<long long, int, hash_edge_key> EdgeIndex;
+
+
+  private:
+    struct OutEntry {
+      int node;      //destination id
+      int mirror;    //position of the matching InEntry in nodes[node].in
+      T   value;
+    };
+
+    struct InEntry {
+      int node;      //origin id
+      int mirror;    //position of the matching OutEntry in nodes[node].out
+    };
+
+    struct NodeInfo {
+      NodeName              name;
+      bool                  used = false;
+      std::vector<OutEntry> out;
+      std::vector<InEntry>  in;
+    };
+
+
+  public:
+    //A NodeView is the set of out_nodes or in_nodes of one node, read directly
+    //  from its adjacency array: iterating yields neighbor names (and the
+    //  Iterator's value() is the value of the edge to/from that neighbor).
+    //  Any command on the graph invalidates it.
+    class NodeView {
+      public:
+        class Iterator {
+          public:
+            const NodeName& operator * () const;
+            const T&        value      () const;
+            Iterator& operator ++ ()                       {++index; return *this;}
+            bool operator == (const Iterator& rhs) const {return index == rhs.index;}
+            bool operator != (const Iterator& rhs) const {return index != rhs.index;}
+
+          private:
+            friend class NodeView;
+            Iterator(const CompactGraph<T>* g, int id, bool outgoing, int index)
+            : graph(g), id(id), outgoing(outgoing), index(index) {}
+
+            const CompactGraph<T>* graph;
+            int                    id;
+            bool                   outgoing;
+            int                    index;
+        };
+
+        int      size  () const;
+        bool     empty () const {return size() == 0;}
+        bool     has   (const NodeName& node_name) const;
+        Iterator begin () const {return Iterator(graph, id, outgoing, 0);}
+        Iterator end   () const {return Iterator(graph, id, outgoing, size());}
+
+        friend std::ostream& operator << (std::ostream& outs, const NodeView& v) {
+          outs << "set[";
+          int printed = 0;
+          for (const NodeName& n : v)
+            outs << (printed++ == 0 ? "" : ",") << n;
+          outs << "]";
+          return outs;
+        }
+
+      private:
+        friend class CompactGraph<T>;
+        NodeView(const CompactGraph<T>* g, int id, bool outgoing) : graph(g), id(id), outgoing(outgoing) {}
+
+        const CompactGraph<T>* graph;
+        int                    id;
+        bool                   outgoing;
+    };
+
+
+    //Destructor/Constructors
+    ~CompactGraph();
+    CompactGraph();
+    CompactGraph(const CompactGraph<T>& g);
+
+    //Queries
+    bool empty      ()                                     const;
+    int  node_count ()                                     const;
+    int  edge_count ()                                     const;
+    bool has_node  (NodeName node_name)                    const;
+    bool has_edge  (NodeName origin, NodeName destination) const;
+    T    edge_value(NodeName origin, NodeName destination) const;
+    int  in_degree (NodeName node_name)                    const;
+    int  out_degree(NodeName node_name)                    const;
+    int  degree    (NodeName node_name)                    const;
+
+    std::vector<NodeName> all_node_names()       const;
+    NodeView out_nodes(NodeName node_name)       const;
+    NodeView in_nodes (NodeName node_name)       const;
+
+    //Immutable snapshot with dense int node ids (see csr_graph.hpp)
+    CSRGraph<T> freeze() const;
+
+    //Commands
+    void add_node   (NodeName node_name);
+    void add_edge   (NodeName origin, NodeName destination, T value);
+    void remove_node(NodeName node_name);
+    void remove_edge(NodeName origin, NodeName destination);
+    void clear      ();
+    void load       (std::ifstream& in_file,  std::string separator = ";");
+    void store      (std::ofstream& out_file, std::string separator = ";");
+
+    //Operators
+    CompactGraph<T>& operator = (const CompactGraph<T>& rhs);
+    bool operator == (const CompactGraph<T>& rhs) const;
+    bool operator != (const CompactGraph<T>& rhs) const;
+
+    template<class T2>
+    friend std::ostream& operator<<(std::ostream& outs, const CompactGraph<T2>& g);
+
+
+  private:
+    std::vector<NodeInfo> nodes;         //Indexed by id; nodes[id].used is false for free ids
+    std::vector<int>      free_ids;      //Ids of removed nodes, reused by add_node
+    IdMap                 ids;           //ids[nodes[id].name] == id for every used id
+    EdgeIndex             edge_index;    //edge_key(o,d) -> position of the edge in nodes[o].out
+    int                   edges = 0;
+
+    //Helper methods
+    static long long edge_key(int origin, int destination);
+    int  id_of         (const NodeName& node_name, const std::string& where) const; //GraphError if absent
+    int  intern        (const NodeName& node_name);                              //Adds node if absent
+    void remove_out_at (int origin, int position);                               //Removes both entries of an edge
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//NodeView: definitions
+
+template<class T>
+auto CompactGraph<T>::NodeView::Iterator::operator * () const -> const NodeName& {
+      const NodeInfo& info = graph->nodes[id];
+      return graph->nodes[outgoing ? info.out[index].node : info.in[index].node].name;
+}
+
+
+template<class T>
+const T& CompactGraph<T>::NodeView::Iterator::value () const {
+      const NodeInfo& info = graph->nodes[id];
+      if (outgoing)
+          return info.out[index].value;
+      const InEntry& e = info.in[index];
+      return graph->nodes[e.node].out[e.mirror].value;
+}
+
+
+template<class T>
+int CompactGraph<T>::NodeView::size () const {
+      const NodeInfo& info = graph->nodes[id];
+      return outgoing ? info.out.size() : info.in.size();
+}
+
+
+template<class T>
+bool CompactGraph<T>::NodeView::has (const NodeName& node_name) const {
+      if (!graph->ids.has_key(node_name))
+          return false;
+      int other = graph->ids[node_name];
+      return graph->edge_index.has_key(outgoing ? edge_key(id, other) : edge_key(other, id));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//CompactGraph: the class and related definitions
+
+//Destructor/Constructors
+
+template<class T>
+CompactGraph<T>::~CompactGraph ()
+{}
+
+
+template<class T>
+CompactGraph<T>::CompactGraph ()
+{}
+
+
+template<class T>
+CompactGraph<T>::CompactGraph (const CompactGraph& g)
+: nodes(g.nodes), free_ids(g.free_ids), ids(g.ids), edge_index(g.edge_index), edges(g.edges)
+{}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class T>
+bool CompactGraph<T>::empty() const {
+      return ids.empty();
+}
+
+
+template<class T>
+int CompactGraph<T>::node_count() const {
+      return ids.size();
+}
+
+
+template<class T>
+int CompactGraph<T>::edge_count() const {
+      return edges;
+}
+
+
+template<class T>
+bool CompactGraph<T>::has_node(NodeName node_name) const {
+      return ids.has_key(node_name);
+}
+
+
+template<class T>
+bool CompactGraph<T>::has_edge(NodeName origin, NodeName destination) const {
+      return ids.has_key(origin) && ids.has_key(destination) &&
+             edge_index.has_key(edge_key(ids[origin], ids[destination]));
+}
+
+
+template<class T>
+T CompactGraph<T>::edge_value(NodeName origin, NodeName destination) const {
+      if (!has_edge(origin, destination)) {
+           std::ostringstream answer;
+           answer << "GraphError::edge_value: key(" << origin << "," << destination << ") not in Map";
+           throw GraphError(answer.str());
+      }
+      int o = ids[origin];
+      return nodes[o].out[edge_index[edge_key(o, ids[destination])]].value;
+}
+
+
+template<class T>
+int CompactGraph<T>::in_degree(NodeName node_name) const {
+      return nodes[id_of(node_name, "in_degree")].in.size();
+}
+
+
+template<class T>
+int CompactGraph<T>::out_degree(NodeName node_name) const {
+      return nodes[id_of(node_name, "out_degree")].out.size();
+}
+
+
+template<class T>
+int CompactGraph<T>::degree(NodeName node_name) const {
+      const NodeInfo& info = nodes[id_of(node_name, "degree")];
+      return info.in.size() + info.out.size();
+}
+
+
+template<class T>
+auto CompactGraph<T>::all_node_names() const -> std::vector<NodeName> {
+      std::vector<NodeName> answer;
+      answer.reserve(node_count());
+      for (const NodeInfo& info : nodes)
+          if (info.used)
+              answer.push_back(info.name);
+      return answer;
+}
+
+
+template<class T>
+auto CompactGraph<T>::out_nodes(NodeName node_name) const -> NodeView {
+      return NodeView(this, id_of(node_name, "out_nodes"), true);
+}
+
+
+template<class T>
+auto CompactGraph<T>::in_nodes(NodeName node_name) const -> NodeView {
+      return NodeView(this, id_of(node_name, "in_nodes"), false);
+}
+
+
+//Free ids are skipped, so the snapshot's ids are dense
+template<class T>
+CSRGraph<T> CompactGraph<T>::freeze() const {
+      std::vector<int> dense(nodes.size(), -1);
+      std::vector<NodeName> names;
+      names.reserve(node_count());
+      for (int id = 0; id < int(nodes.size()); ++id)
+          if (nodes[id].used) {
+              dense[id] = names.size();
+              names.push_back(nodes[id].name);
+          }
+
+      std::vector<int> origins, destinations;
+      std::vector<T>   values;
+      origins.reserve(edges);
+      destinations.reserve(edges);
+      values.reserve(edges);
+      for (int id = 0; id < int(nodes.size()); ++id)
+          for (const OutEntry& e : nodes[id].out) {
+              origins.push_back(dense[id]);
+              destinations.push_back(dense[e.node]);
+              values.push_back(e.value);
+          }
+      return CSRGraph<T>(names, origins, destinations, values);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class T>
+void CompactGraph<T>::add_node (NodeName node_name) {
+      intern(node_name);
+}
+
+
+//An existing edge just gets its new value
+template<class T>
+void CompactGraph<T>::add_edge (NodeName origin, NodeName destination, T value) {
+      int o = intern(origin);
+      int d = intern(destination);
+      long long key = edge_key(o, d);
+      if (edge_index.has_key(key)) {
+          nodes[o].out[edge_index[key]].value = value;
+          return;
+      }
+
+      std::vector<OutEntry>& out = nodes[o].out;
+      std::vector<InEntry>&  in  = nodes[d].in;
+      edge_index[key] = out.size();
+      out.push_back(OutEntry{d, int(in.size()), value});
+      in.push_back(InEntry{o, int(out.size())-1});
+      ++edges;
+}
+
+
+//Removing each edge moves another into its place, so always remove the last
+template<class T>
+void CompactGraph<T>::remove_node (NodeName node_name){
+      if (!has_node(node_name))
+          return;
+
+      int id = ids[node_name];
+      NodeInfo& info = nodes[id];
+      while (!info.out.empty())
+          remove_out_at(id, info.out.size()-1);
+      while (!info.in.empty()) {
+          InEntry e = info.in.back();
+          remove_out_at(e.node, e.mirror);
+      }
+
+      ids.erase(node_name);
+      info = NodeInfo();              //Releases the name and the arrays' storage
+      free_ids.push_back(id);
+}
+
+
+template<class T>
+void CompactGraph<T>::remove_edge (NodeName origin, NodeName destination) {
+      if (!has_edge(origin, destination))
+          return;
+
+      int o = ids[origin];
+      remove_out_at(o, edge_index[edge_key(o, ids[destination])]);
+}
+
+
+template<class T>
+void CompactGraph<T>::clear() {
+      nodes.clear();
+      free_ids.clear();
+      ids.clear();
+      edge_index.clear();
+      edges = 0;
+}
+
+
+//Same file format as HashGraph::load: a node name per line, or
+//  origin/destination/value separated by separator
+template<class T>
+void CompactGraph<T>::load (std::ifstream& in_file, std::string separator) {
+      for (std::string line; getline(in_file, line);) {
+         if (line.find(separator) == std::string::npos) {
+            add_node(line);
+         } else {
+            std::vector<std::string> array = ics::split(line, separator);
+            std::istringstream value_in(array[2]);
+            T value;
+            value_in >> value;
+            add_edge(array[0], array[1], value);
+         }
+      }
+}
+
+
+template<class T>
+void CompactGraph<T>::store(std::ofstream& out_file, std::string separator) {
+       for (const NodeInfo& info : nodes)
+          if (info.used)
+             out_file << info.name << std::endl;
+
+       for (const NodeInfo& info : nodes)
+          for (const OutEntry& e : info.out)
+             out_file << info.name << separator << nodes[e.node].name << separator << e.value << std::endl;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class T>
+CompactGraph<T>& CompactGraph<T>::operator = (const CompactGraph<T>& rhs){
+       if (this == &rhs)
+          return *this;
+       nodes      = rhs.nodes;
+       free_ids   = rhs.free_ids;
+       ids        = rhs.ids;
+       edge_index = rhs.edge_index;
+       edges      = rhs.edges;
+       return *this;
+}
+
+
+//Same node names and same edges with the same values (ids may differ)
+template<class T>
+bool CompactGraph<T>::operator == (const CompactGraph<T>& rhs) const{
+      if (this == &rhs)
+          return true;
+      if (node_count() != rhs.node_count() || edge_count() != rhs.edge_count())
+          return false;
+
+      for (const NodeInfo& info : nodes) {
+          if (!info.used)
+              continue;
+          if (!rhs.has_node(info.name))
+              return false;
+          for (const OutEntry& e : info.out)
+              if (!rhs.has_edge(info.name, nodes[e.node].name) || !(rhs.edge_value(info.name, nodes[e.node].name) == e.value))
+                  return false;
+      }
+      return true;
+}
+
+
+template<class T>
+bool CompactGraph<T>::operator != (const CompactGraph<T>& rhs) const{
+      return !(*this == rhs);
+}
+
+
+//Nodes in alphabetical order (as for HashGraph)
+template<class T>
+std::ostream& operator<<(std::ostream& outs, const CompactGraph<T>& g) {
+   outs << "graph[" << std::endl;
+   std::vector<std::string> names = g.all_node_names();
+   std::sort(names.begin(), names.end());
+   for (const std::string& n : names) {
+      typename CompactGraph<T>::NodeView out = g.out_nodes(n);
+      typename CompactGraph<T>::NodeView in  = g.in_nodes(n);
+      outs << "  " << n << " -> out[";
+      for (auto i = out.begin(); i != out.end(); ++i)
+         outs << (i == out.begin() ? "" : ",") << *i << "(" << i.value() << ")";
+      outs << "] in[";
+      for (auto i = in.begin(); i != in.end(); ++i)
+         outs << (i == in.begin() ? "" : ",") << *i << "(" << i.value() << ")";
+      outs << "]" << std::endl;
+   }
+   outs << "]" << std::endl;
+   return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+template<class T>
+long long CompactGraph<T>::edge_key(int origin, int destination) {
+      return (static_cast<long long>(origin) << 32) | static_cast<unsigned int>(destination);
+}
+
+
+template<class T>
+int CompactGraph<T>::id_of(const NodeName& node_name, const std::string& where) const {
+      if (!ids.has_key(node_name)) {
+           std::ostringstream answer;
+           answer << "GraphError::" << where << ": key(" << node_name << ") not in Map";
+           throw GraphError(answer.str());
+      }
+      return ids[node_name];
+}
+
+
+template<class T>
+int CompactGraph<T>::intern(const NodeName& node_name) {
+      if (ids.has_key(node_name))
+          return ids[node_name];
+
+      int id;
+      if (free_ids.empty()) {
+          id = nodes.size();
+          nodes.push_back(NodeInfo());
+      } else {
+          id = free_ids.back();
+          free_ids.pop_back();
+      }
+      nodes[id].name = node_name;
+      nodes[id].used = true;
+      ids[node_name] = id;
+      return id;
+}
+
+
+//Remove out-edge position of origin and its twin in-entry; the last entry of
+//  each array moves into the hole, so update the mirror of its twin (and, for
+//  an out-entry, its position in edge_index)
+template<class T>
+void CompactGraph<T>::remove_out_at(int origin, int position) {
+      std::vector<OutEntry>& out = nodes[origin].out;
+      int destination = out[position].node;
+      int in_position = out[position].mirror;
+      edge_index.erase(edge_key(origin, destination));
+
+      if (position != int(out.size())-1) {
+          out[position] = out.back();
+          const OutEntry& moved = out[position];
+          nodes[moved.node].in[moved.mirror].mirror = position;
+          edge_index[edge_key(origin, moved.node)] = position;
+      }
+      out.pop_back();
+
+      std::vector<InEntry>& in = nodes[destination].in;
+      if (in_position != int(in.size())-1) {
+          in[in_position] = in.back();
+          const InEntry& moved = in[in_position];
+          nodes[moved.node].out[moved.mirror].mirror = in_position;
+      }
+      in.pop_back();
+      --edges;
+}
+
+
+}
+
+#endif /* COMPACT_GRAPH_HPP_ */
@@ -0,0 +1,202 @@
+#ifndef CONNECTIVITY_INDEX_HPP_
+#define CONNECTIVITY_INDEX_HPP_
+
+#include <string>
+#include <sstream>
+#include "ics_exceptions.hpp"
+#include "hash_map.hpp"
+#include "hash_graph.hpp"
+#include "disjoint_sets.hpp"
+
+
+namespace ics {
+
+
+//A ConnectivityIndex answers "are a and b connected?" (ignoring the direction
+//  of edges) and "how many connected components are there?" for a HashGraph
+//  while it changes. It subscribes to the graph, which must outlive it.
+//  - Adding a node adds a singleton to a DisjointSets over interned node ids;
+//    adding an edge unites the sets of its ends. Both take near constant time.
+//  - Union-find cannot split sets, so removing an edge or node (or clear, =)
+//    just marks the index stale; the next query rebuilds it from the graph in
+//    one pass over its nodes and edges, so a batch of removals costs one
+//    rebuild. Removing an edge whose reverse edge remains, or an isolated
+//    node, changes no component and is handled without a rebuild.
+//Queries are const; a rebuild they trigger changes only the index.
+template<class T>
+class ConnectivityIndex : public HashGraph<T>::Observer {
+  public:
+    //Destructor/Constructors
+    ~ConnectivityIndex();
+    explicit ConnectivityIndex(HashGraph<T>& g);
+    ConnectivityIndex(const ConnectivityIndex<T>& c)                 = delete;
+    ConnectivityIndex<T>& operator = (const ConnectivityIndex<T>& c) = delete;
+
+    //Queries
+    bool connected      (const std::string& a, const std::string& b) const;
+    int  component_count() const;
+    int  component_size (const std::string& a) const;
+    int  rebuild_count  () const;               //Rebuilds so far (including the first)
+    bool stale          () const;
+
+    //HashGraph<T>::Observer: called by the graph
+    void node_added  (const std::string& node_name);
+    void node_removed(const std::string& node_name);
+    void edge_added  (const std::string& origin, const std::string& destination, const T& value);
+    void edge_removed(const std::string& origin, const std::string& destination, const T& old_value);
+    void graph_reset ();
+
+  private:
+    HashGraph<T>* graph;
+    mutable HashMap<std::string, int, HashGraph<T>::hash_str> ids;
+    mutable DisjointSets components;
+    mutable int          isolated_removed = 0;   //Removed singletons still counted in components
+    mutable bool         is_stale = true;
+    mutable int          rebuilds = 0;
+
+    //Helper methods
+    void rebuild () const;
+    int  find_id (const std::string& node_name, const std::string& where) const;
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//ConnectivityIndex: Destructor/Constructors
+
+template<class T>
+ConnectivityIndex<T>::~ConnectivityIndex() {
+      graph->unsubscribe(this);
+}
+
+
+template<class T>
+ConnectivityIndex<T>::ConnectivityIndex(HashGraph<T>& g)
+: graph(&g) {
+      rebuild();
+      g.subscribe(this);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//ConnectivityIndex: Queries
+
+template<class T>
+bool ConnectivityIndex<T>::connected(const std::string& a, const std::string& b) const {
+      int ia = find_id(a, "connected");
+      int ib = find_id(b, "connected");
+      return components.find(ia) == components.find(ib);
+}
+
+
+template<class T>
+int ConnectivityIndex<T>::component_count() const {
+      if (is_stale)
+        rebuild();
+      return components.set_count() - isolated_removed;
+}
+
+
+template<class T>
+int ConnectivityIndex<T>::component_size(const std::string& a) const {
+      return components.set_size(find_id(a, "component_size"));
+}
+
+
+template<class T>
+int ConnectivityIndex<T>::rebuild_count() const {
+      return rebuilds;
+}
+
+
+template<class T>
+bool ConnectivityIndex<T>::stale() const {
+      return is_stale;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//ConnectivityIndex: HashGraph<T>::Observer
+
+//While stale, changes are ignored: the rebuild will see them in the graph
+template<class T>
+void ConnectivityIndex<T>::node_added(const std::string& node_name) {
+      if (!is_stale)
+        ids[node_name] = components.add();
+}
+
+
+//A node removed with no edges left was a singleton: forget it, but its id
+//  remains a set in components, so it is subtracted from the count
+template<class T>
+void ConnectivityIndex<T>::node_removed(const std::string& node_name) {
+      if (!is_stale) {
+        if (components.set_size(ids[node_name]) == 1) {
+          ids.erase(node_name);
+          ++isolated_removed;
+        } else
+          is_stale = true;
+      }
+}
+
+
+template<class T>
+void ConnectivityIndex<T>::edge_added(const std::string& origin, const std::string& destination, const T& /*value*/) {
+      if (!is_stale)
+        components.unite(ids[origin], ids[destination]);
+}
+
+
+template<class T>
+void ConnectivityIndex<T>::edge_removed(const std::string& origin, const std::string& destination, const T& /*old_value*/) {
+      if (!graph->has_edge(destination, origin))
+        is_stale = true;
+}
+
+
+template<class T>
+void ConnectivityIndex<T>::graph_reset() {
+      is_stale = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//ConnectivityIndex: Helper methods
+
+template<class T>
+void ConnectivityIndex<T>::rebuild() const {
+      ids.clear();
+      components.reset(graph->node_count());
+      isolated_removed = 0;
+      int id = 0;
+      for (const typename HashGraph<T>::NodeMapEntry& n : graph->all_nodes())
+        ids[n.first] = id++;
+      for (const typename HashGraph<T>::EdgeMapEntry& e : graph->all_edges())
+        components.unite(ids[e.first.first], ids[e.first.second]);
+      is_stale = false;
+      ++rebuilds;
+}
+
+
+//Rebuild first if stale, so the id refers to the current graph
+template<class T>
+int ConnectivityIndex<T>::find_id(const std::string& node_name, const std::string& where) const {
+      if (is_stale)
+        rebuild();
+      if (!ids.has_key(node_name)) {
+        std::ostringstream answer;
+        answer << "GraphError::ConnectivityIndex::" << where << ": node(" << node_name << ") not in graph";
+        throw GraphError(answer.str());
+      }
+      return ids[node_name];
+}
+
+
+}
+
+#endif /* CONNECTIVITY_INDEX_HPP_ */
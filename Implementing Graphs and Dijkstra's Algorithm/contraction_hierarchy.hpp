@@ -0,0 +1,443 @@
+#ifndef CONTRACTION_HIERARCHY_HPP_
+#define CONTRACTION_HIERARCHY_HPP_
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <sstream>
+#include <limits>
+#include "ics_exceptions.hpp"
+#include "array_queue.hpp"
+#include "heap_priority_queue.hpp"
+#include "hash_graph.hpp"
+#include "csr_graph.hpp"
+#include "dijkstra.hpp"
+
+
+namespace ics {
+
+
+//A ContractionHierarchy answers point-to-point queries on a fixed graph by
+//  searching only "upward" in a precomputed node order.
+//Preprocessing contracts the nodes one at a time, least important first:
+//  contracting v removes it from the remaining graph, adding a shortcut u->w
+//  (cost c(u,v)+c(v,w), remembering v as its middle node) for each pair of
+//  remaining neighbors whose cheapest path might go through v; a bounded
+//  Dijkstra from u that avoids v (a witness search) finds the pairs with an
+//  equally cheap path elsewhere, which need no shortcut. The next node to
+//  contract is the one with the smallest edge difference (shortcuts it would
+//  add minus edges it would remove) plus its number of contracted neighbors,
+//  which spreads contraction evenly; priorities are recomputed lazily when a
+//  node reaches the front of the queue.
+//A query runs Dijkstra forward from start and backward from stop, each using
+//  only edges and shortcuts to higher-ranked (later contracted) nodes; the
+//  cheapest path meets at its highest-ranked node, so both searches stay
+//  small. Shortcuts are unpacked through their middle nodes to recover the
+//  path in the graph.
+//Queries share workspace arrays, so one object must answer one query at a time.
+class ContractionHierarchy {
+  public:
+    //Destructor/Constructors
+    ~ContractionHierarchy();
+    ContractionHierarchy();
+    explicit ContractionHierarchy(const DistGraph& g);
+    explicit ContractionHierarchy(const CSRGraph<int>& g);
+
+    //Queries
+    int node_count     () const;
+    int shortcut_count () const;
+    int rank           (const std::string& node) const;     //Contraction order: 0 is contracted first
+    PathQuery query    (std::string start_node, std::string stop_node, bool unpack_path = true) const;
+
+    //Commands
+    void build (const CSRGraph<int>& g);
+
+  private:
+    struct Arc {
+      int node;        //The other end of the edge or shortcut
+      int cost;
+      int middle;      //Node a shortcut bypasses; -1 for an edge of the graph
+    };
+
+    enum {witness_settle_limit = 500};     //Larger finds more witnesses (fewer shortcuts) but is slower
+
+    std::vector<std::string>      names;
+    HashMap<std::string, int, DistGraph::hash_str> ids;
+    std::vector<std::vector<Arc>> out_arcs;        //All edges and shortcuts leaving each node
+    std::vector<int>              ranks;
+    int                           shortcuts = 0;
+
+    //Upward graphs in compressed form: up_out holds arcs u->w with ranks[w] > ranks[u]
+    //  (forward search); up_in holds arcs w->u with ranks[w] > ranks[u] (backward search)
+    std::vector<int> up_out_offsets, up_out_nodes, up_out_costs;
+    std::vector<int> up_in_offsets,  up_in_nodes,  up_in_costs;
+
+    //Workspace: costs are reset through the touched lists after each search
+    mutable std::vector<int> forward_cost, backward_cost, forward_parent, backward_parent, witness_cost;
+    mutable std::vector<int> touched;
+
+    //Helper methods (contraction uses in_arcs, a mirror of out_arcs, and contracted)
+    int  find_id      (const std::string& node, const std::string& where) const;
+    void add_arc      (std::vector<std::vector<Arc>>& in_arcs, int from, int to, int cost, int middle);
+    int  contract     (std::vector<std::vector<Arc>>& in_arcs, const std::vector<bool>& contracted,
+                       int v, bool add_shortcuts);                 //Returns # of shortcuts needed
+    void witness_search(const std::vector<bool>& contracted, int source, int avoid, int max_cost) const;
+    int  middle_of    (int from, int to, int cost) const;
+    void unpack       (int from, int to, int cost, ArrayQueue<std::string>& path) const;
+    void build_upward (const std::vector<std::vector<Arc>>& in_arcs);
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//ContractionHierarchy: Destructor/Constructors
+
+ContractionHierarchy::~ContractionHierarchy()
+{}
+
+
+ContractionHierarchy::ContractionHierarchy()
+{}
+
+
+ContractionHierarchy::ContractionHierarchy(const DistGraph& g) {
+      build(g.freeze());
+}
+
+
+ContractionHierarchy::ContractionHierarchy(const CSRGraph<int>& g) {
+      build(g);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//ContractionHierarchy: Queries
+
+int ContractionHierarchy::node_count() const {
+      return names.size();
+}
+
+
+int ContractionHierarchy::shortcut_count() const {
+      return shortcuts;
+}
+
+
+int ContractionHierarchy::rank(const std::string& node) const {
+      return ranks[find_id(node, "ContractionHierarchy::rank")];
+}
+
+
+//Each side stops when its cheapest queued cost reaches the best meeting cost
+PathQuery ContractionHierarchy::query(std::string start_node, std::string stop_node, bool unpack_path) const {
+      int s = find_id(start_node, "ContractionHierarchy::query");
+      int t = find_id(stop_node,  "ContractionHierarchy::query");
+      const int infinity = std::numeric_limits<int>::max();
+
+      PathQuery answer;
+      NodeCostPQ forward_pq, backward_pq;
+      forward_cost[s] = 0;
+      forward_parent[s] = -1;
+      backward_cost[t] = 0;
+      backward_parent[t] = -1;
+      touched.push_back(s);
+      touched.push_back(t);
+      forward_pq.enqueue(NodeCost(0, s));
+      backward_pq.enqueue(NodeCost(0, t));
+
+      int best = infinity, meet = -1;
+      bool forward = true;
+      for (;;) {
+          if (!forward_pq.empty() && forward_pq.peek().first >= best)
+              forward_pq.clear();
+          if (!backward_pq.empty() && backward_pq.peek().first >= best)
+              backward_pq.clear();
+          if (forward_pq.empty() && backward_pq.empty())
+              break;
+          if (forward_pq.empty() || (!backward_pq.empty() && !forward))
+              forward = false;
+          else
+              forward = true;
+
+          NodeCostPQ& pq               = (forward ? forward_pq      : backward_pq);
+          std::vector<int>& cost       = (forward ? forward_cost    : backward_cost);
+          std::vector<int>& parent     = (forward ? forward_parent  : backward_parent);
+          const std::vector<int>& other        = (forward ? backward_cost   : forward_cost);
+          const std::vector<int>& offsets      = (forward ? up_out_offsets  : up_in_offsets);
+          const std::vector<int>& arc_nodes    = (forward ? up_out_nodes    : up_in_nodes);
+          const std::vector<int>& arc_costs    = (forward ? up_out_costs    : up_in_costs);
+          forward = !forward;                       //Alternate sides
+
+          NodeCost next = pq.dequeue();
+          int u = next.second;
+          if (next.first > cost[u])
+              continue;
+          ++answer.settled;
+          if (other[u] != infinity && (long long)cost[u] + other[u] < best) {
+              best = cost[u] + other[u];
+              meet = u;
+          }
+
+          for (int a = offsets[u]; a < offsets[u+1]; ++a) {
+              int v = arc_nodes[a];
+              int c = cost[u] + arc_costs[a];
+              if (c < cost[v]) {
+                  if (forward_cost[v] == infinity && backward_cost[v] == infinity)
+                      touched.push_back(v);
+                  cost[v] = c;
+                  parent[v] = u;
+                  pq.enqueue(NodeCost(c, v));
+              }
+          }
+      }
+
+      if (meet != -1) {
+          answer.found = true;
+          answer.cost  = best;
+          if (unpack_path) {
+              std::vector<int> up;                  //meet back to start along forward parents
+              for (int x = meet; x != -1; x = forward_parent[x])
+                  up.push_back(x);
+              answer.path.enqueue(names[s]);
+              for (int i = int(up.size())-1; i > 0; --i)
+                  unpack(up[i], up[i-1], forward_cost[up[i-1]] - forward_cost[up[i]], answer.path);
+              for (int x = meet; backward_parent[x] != -1; x = backward_parent[x])
+                  unpack(x, backward_parent[x], backward_cost[x] - backward_cost[backward_parent[x]], answer.path);
+          }
+      }
+
+      for (int v : touched)
+          forward_cost[v] = backward_cost[v] = infinity;
+      touched.clear();
+      return answer;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//ContractionHierarchy: Commands
+
+void ContractionHierarchy::build(const CSRGraph<int>& g) {
+      const int infinity = std::numeric_limits<int>::max();
+      int n = g.node_count();
+      names.clear();
+      ids.clear();
+      out_arcs.assign(n, std::vector<Arc>());
+      ranks.assign(n, -1);
+      shortcuts = 0;
+
+      std::vector<std::vector<Arc>> in_arcs(n);
+      for (int u = 0; u < n; ++u) {
+          names.push_back(g.node_name(u));
+          ids[names[u]] = u;
+          for (int e = g.out_begin(u); e < g.out_end(u); ++e)
+              if (g.target(e) != u)                 //Self-loops are never on a cheapest path
+                  add_arc(in_arcs, u, g.target(e), g.value(e), -1);
+      }
+      forward_cost.assign(n, infinity);
+      backward_cost.assign(n, infinity);
+      forward_parent.assign(n, -1);
+      backward_parent.assign(n, -1);
+      witness_cost.assign(n, infinity);
+
+      //Priority: edge difference plus contracted neighbors, recomputed when popped
+      std::vector<bool> contracted(n, false);
+      std::vector<int>  contracted_neighbors(n, 0);
+      auto priority = [&] (int v) {
+          int removed = 0;
+          for (const Arc& a : out_arcs[v]) removed += !contracted[a.node];
+          for (const Arc& a : in_arcs[v])  removed += !contracted[a.node];
+          return contract(in_arcs, contracted, v, false) - removed + contracted_neighbors[v];
+      };
+
+      NodeCostPQ order;
+      for (int v = 0; v < n; ++v)
+          order.enqueue(NodeCost(priority(v), v));
+
+      int next_rank = 0;
+      while (!order.empty()) {
+          int v = order.dequeue().second;
+          int p = priority(v);
+          if (!order.empty() && p > order.peek().first) {
+              order.enqueue(NodeCost(p, v));
+              continue;
+          }
+
+          shortcuts += contract(in_arcs, contracted, v, true);
+          contracted[v] = true;
+          ranks[v] = next_rank++;
+          for (const Arc& a : out_arcs[v]) ++contracted_neighbors[a.node];
+          for (const Arc& a : in_arcs[v])  ++contracted_neighbors[a.node];
+      }
+
+      build_upward(in_arcs);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//ContractionHierarchy: Private helper methods
+
+int ContractionHierarchy::find_id(const std::string& node, const std::string& where) const {
+      if (!ids.has_key(node)) {
+          std::ostringstream answer;
+          answer << "GraphError::" << where << ": key(" << node << ") not in Map";
+          throw GraphError(answer.str());
+      }
+      return ids[node];
+}
+
+
+//Keep only the cheapest arc between two nodes
+void ContractionHierarchy::add_arc(std::vector<std::vector<Arc>>& in_arcs, int from, int to, int cost, int middle) {
+      for (Arc& a : out_arcs[from])
+          if (a.node == to) {
+              if (cost < a.cost) {
+                  a.cost = cost;
+                  a.middle = middle;
+                  for (Arc& b : in_arcs[to])
+                      if (b.node == from) {
+                          b.cost = cost;
+                          b.middle = middle;
+                      }
+              }
+              return;
+          }
+      out_arcs[from].push_back(Arc{to, cost, middle});
+      in_arcs[to].push_back(Arc{from, cost, middle});
+}
+
+
+//For each remaining in-neighbor u of v, a witness search from u (avoiding v)
+//  bounded by the costliest path u->v->w decides which w need a shortcut
+int ContractionHierarchy::contract(std::vector<std::vector<Arc>>& in_arcs, const std::vector<bool>& contracted,
+                                   int v, bool add_shortcuts) {
+      int needed = 0;
+      std::vector<Arc> ins, outs;                   //Copies: add_arc may reallocate the arrays
+      for (const Arc& a : in_arcs[v])
+          if (!contracted[a.node])
+              ins.push_back(a);
+      for (const Arc& a : out_arcs[v])
+          if (!contracted[a.node])
+              outs.push_back(a);
+      if (ins.empty() || outs.empty())
+          return 0;
+
+      int max_out = 0;
+      for (const Arc& w : outs)
+          max_out = std::max(max_out, w.cost);
+
+      for (const Arc& u : ins) {
+          witness_search(contracted, u.node, v, u.cost + max_out);
+          for (const Arc& w : outs) {
+              if (w.node == u.node)
+                  continue;
+              int via = u.cost + w.cost;
+              if (witness_cost[w.node] > via) {
+                  ++needed;
+                  if (add_shortcuts)
+                      add_arc(in_arcs, u.node, w.node, via, v);
+              }
+          }
+          for (int x : touched)
+              witness_cost[x] = std::numeric_limits<int>::max();
+          touched.clear();
+      }
+      return needed;
+}
+
+
+//Dijkstra from source over uncontracted nodes other than avoid, stopping at
+//  max_cost or after witness_settle_limit nodes; leaves costs in witness_cost
+void ContractionHierarchy::witness_search(const std::vector<bool>& contracted, int source, int avoid, int max_cost) const {
+      NodeCostPQ pq;
+      witness_cost[source] = 0;
+      touched.push_back(source);
+      pq.enqueue(NodeCost(0, source));
+      int settled = 0;
+      while (!pq.empty() && settled < witness_settle_limit) {
+          NodeCost next = pq.dequeue();
+          int u = next.second;
+          if (next.first > witness_cost[u])
+              continue;
+          if (next.first > max_cost)
+              break;
+          ++settled;
+          for (const Arc& a : out_arcs[u]) {
+              if (a.node == avoid || contracted[a.node])
+                  continue;
+              int c = next.first + a.cost;
+              if (c < witness_cost[a.node]) {
+                  if (witness_cost[a.node] == std::numeric_limits<int>::max())
+                      touched.push_back(a.node);
+                  witness_cost[a.node] = c;
+                  pq.enqueue(NodeCost(c, a.node));
+              }
+          }
+      }
+}
+
+
+int ContractionHierarchy::middle_of(int from, int to, int cost) const {
+      for (const Arc& a : out_arcs[from])
+          if (a.node == to && a.cost == cost)
+              return a.middle;
+      return -1;
+}
+
+
+//Append the nodes after from, up to and including to, replacing each
+//  shortcut by its two halves (an explicit stack: hierarchies can be deep)
+void ContractionHierarchy::unpack(int from, int to, int cost, ArrayQueue<std::string>& path) const {
+      struct Piece {int from, to, cost;};
+      std::vector<Piece> stack;
+      stack.push_back(Piece{from, to, cost});
+      while (!stack.empty()) {
+          Piece p = stack.back();
+          stack.pop_back();
+          int m = middle_of(p.from, p.to, p.cost);
+          if (m == -1) {
+              path.enqueue(names[p.to]);
+              continue;
+          }
+          int first_cost = 0;
+          for (const Arc& a : out_arcs[p.from])
+              if (a.node == m)
+                  first_cost = a.cost;
+          stack.push_back(Piece{m, p.to, p.cost - first_cost});
+          stack.push_back(Piece{p.from, m, first_cost});
+      }
+}
+
+
+void ContractionHierarchy::build_upward(const std::vector<std::vector<Arc>>& in_arcs) {
+      int n = names.size();
+      up_out_offsets.assign(1, 0);
+      up_in_offsets.assign(1, 0);
+      up_out_nodes.clear();
+      up_out_costs.clear();
+      up_in_nodes.clear();
+      up_in_costs.clear();
+      for (int u = 0; u < n; ++u) {
+          for (const Arc& a : out_arcs[u])
+              if (ranks[a.node] > ranks[u]) {
+                  up_out_nodes.push_back(a.node);
+                  up_out_costs.push_back(a.cost);
+              }
+          for (const Arc& a : in_arcs[u])
+              if (ranks[a.node] > ranks[u]) {
+                  up_in_nodes.push_back(a.node);
+                  up_in_costs.push_back(a.cost);
+              }
+          up_out_offsets.push_back(up_out_nodes.size());
+          up_in_offsets.push_back(up_in_nodes.size());
+      }
+}
+
+
+}
+
+#endif /* CONTRACTION_HIERARCHY_HPP_ */
@@ -0,0 +1,405 @@
+#ifndef CSR_GRAPH_HPP_
+#define CSR_GRAPH_HPP_
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <sstream>
+#include <algorithm>                 //std::lower_bound
+#include "ics_exceptions.hpp"
+#include "hash_map.hpp"
+
+
+namespace ics {
+
+
+//A CSRGraph is an immutable snapshot of a graph (see HashGraph::freeze) in
+//  compressed sparse row form. Each node name is interned once as a dense int
+//  id (0 to node_count()-1); the out-edges of node id are the positions
+//  out_begin(id) to out_end(id)-1 of two parallel arrays holding their
+//  destination ids (in increasing order) and values; the in-edges are stored
+//  the same way. Following an edge is an array access instead of string
+//  hashing, and the whole graph is a few contiguous arrays instead of four
+//  hash sets per node plus a map keyed by pairs of strings.
+template<class T>
+class CSRGraph {
+  public:
+    //Typedefs
+    typedef std::string NodeName;
+
+    static int hash_str(const NodeName& s) {
+      std::hash<std::string> str_hash;
+      return str_hash(s);
+    }
+
+    typedef HashMap<NodeName, int, hash_str> IdMap;
+
+
+    //Destructor/Constructors
+    ~CSRGraph();
+    CSRGraph();
+
+    //Edge i goes from node origins[i] to node destinations[i] (indexes into
+    //  node_names) with value values[i]; if an edge appears more than once, its
+    //  last value is used; node_names must be distinct
+    CSRGraph(const std::vector<NodeName>& node_names, const std::vector<int>& origins,
+             const std::vector<int>& destinations, const std::vector<T>& values);
+
+    //Snapshot of any graph supplying all_nodes() and all_edges() like HashGraph
+    template<class Graph>
+    explicit CSRGraph(const Graph& g);
+
+
+    //Queries (by name, matching HashGraph)
+    bool empty      ()                                     const;
+    int  node_count ()                                     const;
+    int  edge_count ()                                     const;
+    bool has_node  (const NodeName& node_name)                           const;
+    bool has_edge  (const NodeName& origin, const NodeName& destination) const;
+    T    edge_value(const NodeName& origin, const NodeName& destination) const;
+    int  in_degree (const NodeName& node_name)                           const;
+    int  out_degree(const NodeName& node_name)                           const;
+    int  degree    (const NodeName& node_name)                           const;
+
+    //Queries (by id)
+    int             node_id  (const NodeName& node_name) const;   //GraphError if not in graph
+    int             find_id  (const NodeName& node_name) const;   //-1 if not in graph
+    const NodeName& node_name(int id)                    const;
+    int             edge_index(int origin, int destination) const; //Position among out-edges, or -1
+
+    int      out_begin (int id) const {return out_offsets[id];}
+    int      out_end   (int id) const {return out_offsets[id+1];}
+    int      target    (int e)  const {return out_targets[e];}   //Destination id of out-edge e
+    const T& value     (int e)  const {return out_values[e];}    //Value of out-edge e
+    int      in_begin  (int id) const {return in_offsets[id];}
+    int      in_end    (int id) const {return in_offsets[id+1];}
+    int      source    (int i)  const {return in_sources[i];}    //Origin id of in-edge i
+    const T& in_value  (int i)  const {return in_values[i];}     //Value of in-edge i
+
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+
+    //Operators
+    bool operator == (const CSRGraph<T>& rhs) const;
+    bool operator != (const CSRGraph<T>& rhs) const;
+
+    template<class T2>
+    friend std::ostream& operator<<(std::ostream& outs, const CSRGraph<T2>& g);
+
+
+  private:
+    std::vector<NodeName> names;         //names[id] is the name of node id
+    IdMap                 ids;           //ids[names[id]] == id
+    std::vector<int>      out_offsets;   //node_count()+1 entries: out-edges of id are [out_offsets[id],out_offsets[id+1])
+    std::vector<int>      out_targets;
+    std::vector<T>        out_values;
+    std::vector<int>      in_offsets;    //Same layout for in-edges
+    std::vector<int>      in_sources;
+    std::vector<T>        in_values;
+
+    //Helper methods
+    void build(const std::vector<int>& origins, const std::vector<int>& destinations, const std::vector<T>& values);
+    static void counting_sort(const std::vector<int>& keys, int key_count,
+                              const std::vector<int>& order, std::vector<int>& sorted);
+    void not_in_graph(const std::string& where, const NodeName& node_name) const;
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//CSRGraph: the class and related definitions
+
+//Destructor/Constructors
+
+template<class T>
+CSRGraph<T>::~CSRGraph ()
+{}
+
+
+template<class T>
+CSRGraph<T>::CSRGraph ()
+: out_offsets(1,0), in_offsets(1,0)
+{}
+
+
+template<class T>
+CSRGraph<T>::CSRGraph (const std::vector<NodeName>& node_names, const std::vector<int>& origins,
+                       const std::vector<int>& destinations, const std::vector<T>& values)
+: names(node_names), ids(int(node_names.size()) + 1) {
+      for (int id = 0; id < int(names.size()); ++id)
+          ids[names[id]] = id;
+      build(origins, destinations, values);
+}
+
+
+//Intern the nodes (in the order all_nodes iterates over them), then the edges
+template<class T>
+template<class Graph>
+CSRGraph<T>::CSRGraph (const Graph& g)
+: ids(g.node_count() + 1) {
+      names.reserve(g.node_count());
+      for (const auto& n : g.all_nodes()) {
+          ids[n.first] = names.size();
+          names.push_back(n.first);
+      }
+
+      std::vector<int> origins, destinations;
+      std::vector<T>   values;
+      origins.reserve(g.edge_count());
+      destinations.reserve(g.edge_count());
+      values.reserve(g.edge_count());
+      for (const auto& e : g.all_edges()) {
+          origins.push_back(ids[e.first.first]);
+          destinations.push_back(ids[e.first.second]);
+          values.push_back(e.second);
+      }
+      build(origins, destinations, values);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class T>
+bool CSRGraph<T>::empty() const {
+      return names.empty();
+}
+
+
+template<class T>
+int CSRGraph<T>::node_count() const {
+      return names.size();
+}
+
+
+template<class T>
+int CSRGraph<T>::edge_count() const {
+      return out_targets.size();
+}
+
+
+template<class T>
+bool CSRGraph<T>::has_node(const NodeName& node_name) const {
+      return ids.has_key(node_name);
+}
+
+
+template<class T>
+bool CSRGraph<T>::has_edge(const NodeName& origin, const NodeName& destination) const {
+      int o = find_id(origin);
+      int d = find_id(destination);
+      return o != -1 && d != -1 && edge_index(o, d) != -1;
+}
+
+
+template<class T>
+T CSRGraph<T>::edge_value(const NodeName& origin, const NodeName& destination) const {
+      int o = find_id(origin);
+      int d = find_id(destination);
+      int e = (o == -1 || d == -1 ? -1 : edge_index(o, d));
+      if (e == -1) {
+          std::ostringstream answer;
+          answer << "GraphError::edge_value: key(" << origin << "," << destination << ") not in Map";
+          throw GraphError(answer.str());
+      }
+      return out_values[e];
+}
+
+
+template<class T>
+int CSRGraph<T>::in_degree(const NodeName& node_name) const {
+      int id = find_id(node_name);
+      if (id == -1)
+          not_in_graph("in_degree", node_name);
+      return in_end(id) - in_begin(id);
+}
+
+
+template<class T>
+int CSRGraph<T>::out_degree(const NodeName& node_name) const {
+      int id = find_id(node_name);
+      if (id == -1)
+          not_in_graph("out_degree", node_name);
+      return out_end(id) - out_begin(id);
+}
+
+
+template<class T>
+int CSRGraph<T>::degree(const NodeName& node_name) const {
+      return in_degree(node_name) + out_degree(node_name);
+}
+
+
+template<class T>
+int CSRGraph<T>::node_id(const NodeName& node_name) const {
+      int id = find_id(node_name);
+      if (id == -1)
+          not_in_graph("node_id", node_name);
+      return id;
+}
+
+
+template<class T>
+int CSRGraph<T>::find_id(const NodeName& node_name) const {
+      return ids.has_key(node_name) ? ids[node_name] : -1;
+}
+
+
+template<class T>
+auto CSRGraph<T>::node_name(int id) const -> const NodeName& {
+      return names[id];
+}
+
+
+//Each node's out-edges are sorted by destination id: binary search them
+template<class T>
+int CSRGraph<T>::edge_index(int origin, int destination) const {
+      auto first = out_targets.begin() + out_offsets[origin];
+      auto last  = out_targets.begin() + out_offsets[origin+1];
+      auto e = std::lower_bound(first, last, destination);
+      return (e != last && *e == destination ? int(e - out_targets.begin()) : -1);
+}
+
+
+template<class T>
+std::string CSRGraph<T>::str() const {
+      std::ostringstream answer;
+      answer << "CSRGraph[nodes=" << node_count() << ",edges=" << edge_count() << "]";
+      return answer.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+//Same node names and same edges (ids may differ between the graphs)
+template<class T>
+bool CSRGraph<T>::operator == (const CSRGraph<T>& rhs) const {
+      if (this == &rhs)
+          return true;
+      if (node_count() != rhs.node_count() || edge_count() != rhs.edge_count())
+          return false;
+
+      for (int id = 0; id < node_count(); ++id) {
+          int rhs_id = rhs.find_id(names[id]);
+          if (rhs_id == -1 || out_end(id) - out_begin(id) != rhs.out_end(rhs_id) - rhs.out_begin(rhs_id))
+              return false;
+          for (int e = out_begin(id); e < out_end(id); ++e) {
+              int rhs_e = rhs.edge_index(rhs_id, rhs.find_id(names[out_targets[e]]));
+              if (rhs_e == -1 || !(rhs.out_values[rhs_e] == out_values[e]))
+                  return false;
+          }
+      }
+      return true;
+}
+
+
+template<class T>
+bool CSRGraph<T>::operator != (const CSRGraph<T>& rhs) const {
+      return !(*this == rhs);
+}
+
+
+template<class T>
+std::ostream& operator<<(std::ostream& outs, const CSRGraph<T>& g) {
+   outs << "csr_graph[" << std::endl;
+   for (int id = 0; id < g.node_count(); ++id) {
+       outs << "  " << g.names[id] << " -> out[";
+       for (int e = g.out_begin(id); e < g.out_end(id); ++e)
+           outs << (e == g.out_begin(id) ? "" : ",") << g.names[g.out_targets[e]] << "(" << g.out_values[e] << ")";
+       outs << "]" << std::endl;
+   }
+   outs << "]" << std::endl;
+   return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+//Stable counting sort of the edge indexes in order by keys[index] (each in
+//  [0,key_count)): O(edges + nodes)
+template<class T>
+void CSRGraph<T>::counting_sort(const std::vector<int>& keys, int key_count,
+                                const std::vector<int>& order, std::vector<int>& sorted) {
+      std::vector<int> start(key_count+1, 0);
+      for (int i : order)
+          ++start[keys[i]+1];
+      for (int k = 0; k < key_count; ++k)
+          start[k+1] += start[k];
+      sorted.resize(order.size());
+      for (int i : order)
+          sorted[start[keys[i]]++] = i;
+}
+
+
+//Two stable counting sorts (by destination, then by origin) order the edges
+//  by (origin,destination) keeping duplicates in input order, so the last of
+//  each run of duplicates wins; the in-edges are then a stable counting sort
+//  of the kept out-edges by destination, so each in-list is sorted by origin
+template<class T>
+void CSRGraph<T>::build(const std::vector<int>& origins, const std::vector<int>& destinations, const std::vector<T>& values) {
+      int n = names.size();
+      int m = origins.size();
+      std::vector<int> order(m), by_destination, by_edge;
+      for (int i = 0; i < m; ++i)
+          order[i] = i;
+      counting_sort(destinations, n, order, by_destination);
+      counting_sort(origins, n, by_destination, by_edge);
+
+      std::vector<int> kept;
+      kept.reserve(m);
+      for (int j = 0; j < m; ++j) {
+          int i = by_edge[j];
+          if (!kept.empty() && origins[kept.back()] == origins[i] && destinations[kept.back()] == destinations[i])
+              kept.back() = i;
+          else
+              kept.push_back(i);
+      }
+
+      out_offsets.assign(n+1, 0);
+      out_targets.clear();
+      out_values.clear();
+      out_targets.reserve(kept.size());
+      out_values.reserve(kept.size());
+      for (int i : kept) {
+          ++out_offsets[origins[i]+1];
+          out_targets.push_back(destinations[i]);
+          out_values.push_back(values[i]);
+      }
+      for (int id = 0; id < n; ++id)
+          out_offsets[id+1] += out_offsets[id];
+
+      std::vector<int> in_order;
+      counting_sort(destinations, n, kept, in_order);
+      in_offsets.assign(n+1, 0);
+      in_sources.clear();
+      in_values.clear();
+      in_sources.reserve(kept.size());
+      in_values.reserve(kept.size());
+      for (int i : in_order) {
+          ++in_offsets[destinations[i]+1];
+          in_sources.push_back(origins[i]);
+          in_values.push_back(values[i]);
+      }
+      for (int id = 0; id < n; ++id)
+          in_offsets[id+1] += in_offsets[id];
+}
+
+
+template<class T>
+void CSRGraph<T>::not_in_graph(const std::string& where, const NodeName& node_name) const {
+      std::ostringstream answer;
+      answer << "GraphError::" << where << ": key(" << node_name << ") not in Map";
+      throw GraphError(answer.str());
+}
+
+
+}
+
+#endif /* CSR_GRAPH_HPP_ */
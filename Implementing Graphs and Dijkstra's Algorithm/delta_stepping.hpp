@@ -0,0 +1,290 @@
+#ifndef DELTA_STEPPING_HPP_
+#define DELTA_STEPPING_HPP_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <limits>
+#include <sstream>
+#include "ics_exceptions.hpp"
+#include "hash_graph.hpp"
+#include "csr_graph.hpp"
+#include "dijkstra.hpp"
+#include "parallel_for.hpp"
+
+
+namespace ics {
+
+
+//Delta-stepping (Meyer and Sanders) computes the same costs as Dijkstra but
+//  settles many nodes at once, so threads can share the work. Nodes wait in
+//  buckets of width delta by tentative cost. The smallest non-empty bucket is
+//  emptied in phases: all its nodes relax their light edges (value <= delta)
+//  in parallel, which may refill the same bucket, until it stays empty; then
+//  every node removed from it relaxes its heavy edges (value > delta), which
+//  can only reach later buckets. Small delta approaches Dijkstra (little
+//  parallelism); large delta approaches Bellman-Ford (much re-relaxation).
+//Threads lower costs with an atomic compare-and-swap minimum and record the
+//  nodes they improved in their own buffers; between phases thread 0 moves
+//  those into buckets and builds the next frontier. Only non-empty buckets
+//  are stored (in a map by bucket index), so a small delta with a large edge
+//  value costs no memory or time for the empty buckets between them.
+//Afterwards from[v] is chosen as a node u with cost[u] + value(u,v) ==
+//  cost[v]: first through positive edges (which cannot form a cycle), then
+//  by a search along zero-valued edges for the rest.
+//Edge values must not be negative. delta = 0 uses the average edge value;
+//  threads = 0 uses one per hardware thread. Compile with -pthread.
+
+
+//Threads wait at a Barrier until all of them have arrived
+class Barrier {
+  public:
+    explicit Barrier(int threads) : threads(threads) {}
+
+    void wait() {
+      std::unique_lock<std::mutex> guard(lock);
+      int arriving = generation;
+      if (++waiting == threads) {
+        waiting = 0;
+        ++generation;
+        all_arrived.notify_all();
+      } else
+        all_arrived.wait(guard, [&] () {return generation != arriving;});
+    }
+
+  private:
+    int                     threads;
+    int                     waiting    = 0;
+    int                     generation = 0;
+    std::mutex              lock;
+    std::condition_variable all_arrived;
+};
+
+
+//Lower cost to c if that is smaller; true if it was
+bool atomic_min(std::atomic<int> &cost, int c) {
+       int old = cost.load(std::memory_order_relaxed);
+       while (c < old)
+          if (cost.compare_exchange_weak(old, c, std::memory_order_relaxed))
+             return true;
+       return false;
+}
+
+
+//Each node's out-edges copied from g with the light ones first: node u's
+//  light edges are [g.out_begin(u), heavy_begin[u]) and its heavy edges are
+//  [heavy_begin[u], g.out_end(u))
+class LightHeavyEdges {
+  public:
+    LightHeavyEdges(const CSRGraph<int> &g, int delta, int threads)
+    : heavy_begin(g.node_count()), targets(g.edge_count()), values(g.edge_count()) {
+      const int chunk = 1024;
+      parallel_for((g.node_count()+chunk-1)/chunk, threads, [&] (int c, int) {
+        for (int u = c*chunk; u < std::min(g.node_count(), (c+1)*chunk); ++u) {
+          int light = g.out_begin(u), heavy = g.out_end(u);
+          for (int e = g.out_begin(u); e < g.out_end(u); ++e) {
+            if (g.value(e) < 0) {
+              std::ostringstream answer;
+              answer << "GraphError::delta_stepping: edge(" << g.node_name(u) << "->" << g.node_name(g.target(e))
+                     << ") has negative value(" << g.value(e) << ")";
+              throw GraphError(answer.str());
+            }
+            int i = (g.value(e) <= delta ? light++ : --heavy);
+            targets[i] = g.target(e);
+            values[i]  = g.value(e);
+          }
+          heavy_begin[u] = light;
+        }
+      });
+    }
+
+    std::vector<int> heavy_begin, targets, values;
+};
+
+
+void delta_stepping(const CSRGraph<int> &g, int start, int delta, std::vector<int> &cost, std::vector<int> &from,
+                    int threads = 0) {
+       const int infinity = std::numeric_limits<int>::max();
+       int n = g.node_count();
+       long long value_sum = 0;
+       for (int e = 0; e < g.edge_count(); ++e)
+          value_sum += g.value(e);
+       if (delta <= 0)
+          delta = std::max<long long>(1, g.edge_count() == 0 ? 1 : value_sum / g.edge_count());
+       threads = thread_count(threads);
+
+       LightHeavyEdges edges(g, delta, threads);
+       std::vector<std::atomic<int>> tentative(n);
+       for (std::atomic<int> &c : tentative)
+          c.store(infinity, std::memory_order_relaxed);
+       tentative[start].store(0, std::memory_order_relaxed);
+
+       //buckets[i] holds nodes whose cost was lowered into [i*delta, (i+1)*delta);
+       //  an entry is stale if the node's cost was lowered again since
+       std::map<int, std::vector<int>> buckets;
+       struct Improved {                            //Padded: threads write neighboring buffers
+         std::vector<int> nodes;
+         char             padding[64];
+       };
+       std::vector<Improved> improved(threads);
+       std::vector<int>  frontier(1, start), removed(1, start);
+       std::vector<char> in_frontier(n, 0), in_removed(n, 0);
+       in_removed[start] = 1;
+       int  current      = 0;
+       bool light_phase  = true;
+       bool done         = false;
+       std::atomic<int> next_chunk(0);
+       Barrier barrier(threads);
+       const int chunk = 64;
+
+       //Move improved nodes into buckets, then pick the next frontier: the
+       //  current bucket's live entries (light phase), or the removed nodes
+       //  once it stays empty (heavy phase), or the next non-empty bucket
+       auto next_phase = [&] () {
+         std::vector<int>* last = nullptr;          //Consecutive nodes often share a bucket
+         int last_index = -1;
+         for (Improved &buffer : improved) {
+           for (int v : buffer.nodes) {
+             int i = tentative[v].load(std::memory_order_relaxed)/delta;
+             if (i != last_index) {
+               last       = &buckets[i];
+               last_index = i;
+             }
+             last->push_back(v);
+           }
+           buffer.nodes.clear();
+         }
+
+         for (;;) {
+           auto bucket = buckets.find(current);
+           if (light_phase && bucket != buckets.end()) {
+             frontier.clear();
+             for (int v : bucket->second)
+               if (tentative[v].load(std::memory_order_relaxed)/delta == current && !in_frontier[v]) {
+                 in_frontier[v] = 1;
+                 frontier.push_back(v);
+                 if (!in_removed[v]) {
+                   in_removed[v] = 1;
+                   removed.push_back(v);
+                 }
+               }
+             buckets.erase(bucket);
+             for (int v : frontier)
+               in_frontier[v] = 0;
+             if (!frontier.empty()) {
+               light_phase = true;
+               return;
+             }
+           }
+           if (!removed.empty()) {
+             frontier.swap(removed);
+             removed.clear();
+             for (int v : frontier)
+               in_removed[v] = 0;
+             light_phase = false;
+             return;
+           }
+
+           if (buckets.empty()) {
+             done = true;
+             return;
+           }
+           current = buckets.begin()->first;
+           light_phase = true;
+         }
+       };
+
+       parallel_for(threads, threads, [&] (int thread, int) {
+         for (;;) {
+           barrier.wait();
+           if (done)
+             break;
+           for (int c = next_chunk.fetch_add(chunk); c < int(frontier.size()); c = next_chunk.fetch_add(chunk))
+             for (int i = c; i < std::min<int>(frontier.size(), c+chunk); ++i) {
+               int u  = frontier[i];
+               int cu = tentative[u].load(std::memory_order_relaxed);
+               int begin = (light_phase ? g.out_begin(u)          : edges.heavy_begin[u]);
+               int end   = (light_phase ? edges.heavy_begin[u]    : g.out_end(u));
+               for (int e = begin; e < end; ++e)
+                 if (atomic_min(tentative[edges.targets[e]], cu + edges.values[e]))
+                   improved[thread].nodes.push_back(edges.targets[e]);
+             }
+           barrier.wait();
+           if (thread == 0) {
+             next_phase();
+             next_chunk = 0;
+           }
+         }
+       });
+
+       cost.resize(n);
+       for (int v = 0; v < n; ++v)
+          cost[v] = tentative[v].load(std::memory_order_relaxed);
+
+       //Predecessors through positive edges in parallel; nodes reached only
+       //  through zero-valued edges are left for the search below
+       from.assign(n, -1);
+       std::vector<int> unresolved;
+       std::mutex unresolved_lock;
+       const int from_chunk = 1024;
+       parallel_for((n+from_chunk-1)/from_chunk, threads, [&] (int c, int) {
+         std::vector<int> local;
+         for (int v = c*from_chunk; v < std::min(n, (c+1)*from_chunk); ++v) {
+           if (v == start || cost[v] == infinity)
+             continue;
+           for (int e = g.in_begin(v); e < g.in_end(v) && from[v] == -1; ++e)
+             if (g.in_value(e) > 0 && cost[g.source(e)] != infinity && cost[g.source(e)] + g.in_value(e) == cost[v])
+               from[v] = g.source(e);
+           if (from[v] == -1)
+             local.push_back(v);
+         }
+         std::lock_guard<std::mutex> guard(unresolved_lock);
+         unresolved.insert(unresolved.end(), local.begin(), local.end());
+       });
+
+       std::vector<char> resolved(n, 1);
+       for (int v : unresolved)
+          resolved[v] = 0;
+       std::vector<int> reached;
+       for (int v : unresolved)
+          for (int e = g.in_begin(v); e < g.in_end(v) && !resolved[v]; ++e)
+             if (g.in_value(e) == 0 && resolved[g.source(e)] && cost[g.source(e)] == cost[v]) {
+                from[v] = g.source(e);
+                resolved[v] = 1;
+                reached.push_back(v);
+             }
+       while (!reached.empty()) {
+          int u = reached.back();
+          reached.pop_back();
+          for (int e = g.out_begin(u); e < g.out_end(u); ++e) {
+             int v = g.target(e);
+             if (!resolved[v] && g.value(e) == 0 && cost[v] == cost[u]) {
+                from[v] = u;
+                resolved[v] = 1;
+                reached.push_back(v);
+             }
+          }
+       }
+}
+
+
+//Same answer as extended_dijkstra (except for which of several equally
+//  cheap predecessors each from names)
+CostMap delta_stepping(const CSRGraph<int> &g, std::string start_node, int delta = 0, int threads = 0) {
+       std::vector<int> cost, from;
+       delta_stepping(g, g.node_id(start_node), delta, cost, from, threads);
+       return cost_map(g, cost, from);
+}
+
+
+CostMap delta_stepping(const DistGraph &g, std::string start_node, int delta = 0, int threads = 0) {
+       return delta_stepping(g.freeze(), start_node, delta, threads);
+}
+
+
+}
+
+#endif /* DELTA_STEPPING_HPP_ */
@@ -5,6 +5,7 @@
 #include "array_queue.hpp"
 #include "hash_graph.hpp"
 #include "dijkstra.hpp"
+#include "alt_index.hpp"
 
 
 
@@ -31,6 +32,27 @@ int main() {
 
      std::string start_node = get_node_in_graph(hashGraph, "Enter start node", false);
 
+     //Point-to-point mode: search only as far as each stop node needs, guided
+     //  by an ALT index if landmarks are requested
+     if (ics::prompt_bool("Answer each stop node with a point-to-point query", false)) {
+        int landmarks = ics::prompt_int("Enter number of ALT landmarks (0 for bidirectional Dijkstra)", 0);
+        ics::ALTIndex alt;
+        if (landmarks > 0)
+           alt.build(hashGraph, landmarks);
+        for (;;) {
+           std::string stop_node = get_node_in_graph(hashGraph, "Enter stop node", true);
+           if (stop_node == "QUIT")
+              return 0;
+           ics::PathQuery query = (landmarks > 0 ? alt.query(hashGraph, start_node, stop_node)
+                                                 : ics::bidirectional_shortest_path(hashGraph, start_node, stop_node));
+           if (query.found)
+              std::cout << "Cost is " << query.cost << "; path is " << query.path;
+           else
+              std::cout << stop_node << " is unreachable";
+           std::cout << "; settled " << query.settled << " of " << hashGraph.node_count() << " nodes" << std::endl << std::endl;
+        }
+     }
+
      ics::CostMap shortest_path_map = extended_dijkstra(hashGraph, start_node);
      std::cout << shortest_path_map << std::endl << std::endl;
 
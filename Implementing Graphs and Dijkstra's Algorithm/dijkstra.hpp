@@ -5,11 +5,13 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <vector>
 #include <limits>                    //Biggest int: std::numeric_limits<int>::max()
 #include "array_queue.hpp"
 #include "array_stack.hpp"
 #include "heap_priority_queue.hpp"
 #include "hash_graph.hpp"
+#include "csr_graph.hpp"
 
 
 namespace ics {
@@ -92,6 +94,87 @@ CostMap extended_dijkstra(const DistGraph &g, std::string start_node) {
 }
 
 
+//Priority queue entries for Dijkstra over node ids: (cost, node id)
+  typedef ics::pair<int, int> NodeCost;
+  bool gt_node_cost(const NodeCost &a, const NodeCost &b) { return a.first < b.first; }
+  typedef ics::HeapPriorityQueue<NodeCost, gt_node_cost> NodeCostPQ;
+
+
+//Arrays reused by repeated csr_dijkstra calls: keep one per thread when
+//  searching from many start nodes in parallel
+class DijkstraWorkspace {
+  public:
+    std::vector<int> cost;
+    std::vector<int> from;
+    NodeCostPQ       pq;
+};
+
+
+//Dijkstra over the int ids of a CSRGraph: afterwards w.cost[v] is the cost of
+//  the cheapest path from start to v (max int if there is none) and w.from[v]
+//  is v's predecessor on it (-1 for start and unreachable nodes). Stale queue
+//  entries (whose cost is above the node's current cost) are skipped when
+//  dequeued; with non-negative edge values no settled node's cost can drop.
+void csr_dijkstra(const CSRGraph<int> &g, int start, DijkstraWorkspace &w) {
+       int n = g.node_count();
+       w.cost.assign(n, std::numeric_limits<int>::max());
+       w.from.assign(n, -1);
+       w.pq.clear();
+
+       w.cost[start] = 0;
+       w.pq.enqueue(NodeCost(0, start));
+       while (!w.pq.empty()) {
+            NodeCost next = w.pq.dequeue();
+            int u = next.second;
+            if (next.first > w.cost[u])
+               continue;
+
+            for (int e = g.out_begin(u); e < g.out_end(u); ++e) {
+               int v = g.target(e);
+               int c = w.cost[u] + g.value(e);
+               if (c < w.cost[v]) {
+                  w.cost[v] = c;
+                  w.from[v] = u;
+                  w.pq.enqueue(NodeCost(c, v));
+               }
+            }
+       }
+}
+
+
+void csr_dijkstra(const CSRGraph<int> &g, int start, std::vector<int> &cost, std::vector<int> &from) {
+       DijkstraWorkspace w;
+       csr_dijkstra(g, start, w);
+       cost.swap(w.cost);
+       from.swap(w.from);
+}
+
+
+//Convert csr_dijkstra's arrays to the map extended_dijkstra returns: only
+//  reachable nodes are in it
+CostMap cost_map(const CSRGraph<int> &g, const std::vector<int> &cost, const std::vector<int> &from) {
+       CostMap answer_map;
+       for (int v = 0; v < g.node_count(); ++v) {
+          if (cost[v] != std::numeric_limits<int>::max()) {
+             Info info(g.node_name(v));
+             info.cost = cost[v];
+             if (from[v] != -1)
+                info.from = g.node_name(from[v]);
+             answer_map.put(info.node, info);
+          }
+       }
+       return answer_map;
+}
+
+
+//Same answer as extended_dijkstra on the HashGraph that g was frozen from
+CostMap extended_dijkstra(const CSRGraph<int> &g, std::string start_node) {
+       DijkstraWorkspace w;
+       csr_dijkstra(g, g.node_id(start_node), w);
+       return cost_map(g, w.cost, w.from);
+}
+
+
 //Return a queue whose front is the start node (implicit in answer_map) and whose
 //  rear is the end node
 ArrayQueue <std::string> recover_path(const CostMap &answer_map, std::string end_node) {
@@ -116,6 +199,198 @@ ArrayQueue <std::string> recover_path(const CostMap &answer_map, std::string end
 }
 
 
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Point-to-point queries: each returns the cost of the cheapest path from start
+//  to stop, the path itself (front is start, rear is stop), and the number of
+//  nodes it settled (its search space; extended_dijkstra settles every node
+//  reachable from start). They work on any graph with has_node, out_nodes,
+//  in_nodes (bidirectional only) and edge_value, like HashGraph or CompactGraph.
+
+class PathQuery {
+  public:
+    bool found   = false;                           //false: stop is unreachable
+    int  cost    = std::numeric_limits<int>::max();
+    ArrayQueue<std::string> path;
+    int  settled = 0;
+
+    friend std::ostream &operator<<(std::ostream &outs, const PathQuery &q) {
+      outs << "PathQuery[";
+      if (q.found)
+        outs << "cost=" << q.cost << ",path=" << q.path;
+      else
+        outs << "unreachable";
+      outs << ",settled=" << q.settled << "]";
+      return outs;
+    }
+  };
+
+
+  typedef ics::pair<int, std::string> NodePriority;   //(priority, node name)
+  bool gt_node_priority(const NodePriority &a, const NodePriority &b) { return a.first < b.first; }
+  typedef ics::HeapPriorityQueue<NodePriority, gt_node_priority> NodePriorityPQ;
+  typedef ics::HashSet<std::string, DistGraph::hash_str> NameSet;
+
+  typedef int (*PathHeuristic)(const std::string &node, const std::string &stop);
+  int zero_heuristic(const std::string &/*node*/, const std::string &/*stop*/) { return 0; }
+
+
+template<class Graph>
+void check_query_nodes(const Graph &g, const std::string &where, const std::string &start, const std::string &stop) {
+       for (const std::string &n : {start, stop})
+          if (!g.has_node(n)) {
+             std::ostringstream answer;
+             answer << "GraphError::" << where << ": key(" << n << ") not in Map";
+             throw GraphError(answer.str());
+          }
+}
+
+
+//A* search (Dijkstra ordered by cost + h(node,stop)), stopping when stop is
+//  settled. h must never overestimate the remaining cost and must satisfy
+//  h(u,stop) <= edge_value(u,v) + h(v,stop) for every edge, so that settled
+//  nodes are never improved; zero_heuristic gives plain Dijkstra.
+//  Heuristic is anything callable as h(node,stop): a PathHeuristic, or an
+//  object holding precomputed data (see alt_index.hpp).
+template<class Graph, class Heuristic>
+PathQuery astar_search(const Graph &g, std::string start_node, std::string stop_node, Heuristic h) {
+       check_query_nodes(g, "astar_search", start_node, stop_node);
+       PathQuery answer;
+       CostMap info_map;
+       NameSet settled;
+       NodePriorityPQ info_pq;
+
+       info_map[start_node] = Info(start_node);
+       info_map[start_node].cost = 0;
+       info_pq.enqueue(NodePriority(h(start_node, stop_node), start_node));
+
+       while (!info_pq.empty()) {
+            std::string min_node = info_pq.dequeue().second;
+            if (settled.contains(min_node))
+               continue;
+            settled.insert(min_node);
+            ++answer.settled;
+
+            int min_cost = info_map[min_node].cost;
+            if (min_node == stop_node) {
+               answer.found = true;
+               answer.cost  = min_cost;
+               answer.path  = recover_path(info_map, stop_node);
+               return answer;
+            }
+
+            for (const std::string &destination : g.out_nodes(min_node)) {
+               if (settled.contains(destination))
+                  continue;
+               int c = min_cost + g.edge_value(min_node, destination);
+               if (!info_map.has_key(destination) || c < info_map[destination].cost) {
+                  info_map[destination] = Info(destination);
+                  info_map[destination].cost = c;
+                  info_map[destination].from = min_node;
+                  info_pq.enqueue(NodePriority(c + h(destination, stop_node), destination));
+               }
+            }
+       }
+       return answer;
+}
+
+
+//Dijkstra from start_node that stops as soon as stop_node is settled
+template<class Graph>
+PathQuery shortest_path(const Graph &g, std::string start_node, std::string stop_node) {
+       return astar_search(g, start_node, stop_node, zero_heuristic);
+}
+
+
+template<class Graph>
+PathQuery astar_shortest_path(const Graph &g, std::string start_node, std::string stop_node, PathHeuristic h) {
+       return astar_search(g, start_node, stop_node, h);
+}
+
+
+//Settle the cheapest node on one side of a bidirectional search. Each edge
+//  relaxed that reaches a node the other side has also reached gives a
+//  candidate path cost; best/meet record the cheapest one found.
+template<class Graph>
+void bidirectional_step(const Graph &g, bool forward, NodePriorityPQ &pq, CostMap &this_map, NameSet &this_settled,
+                        const CostMap &other_map, int &best, std::string &meet, int &settled_count) {
+       std::string min_node = pq.dequeue().second;
+       if (this_settled.contains(min_node))
+          return;
+       this_settled.insert(min_node);
+       ++settled_count;
+
+       int min_cost = this_map[min_node].cost;
+       for (const std::string &neighbor : (forward ? g.out_nodes(min_node) : g.in_nodes(min_node))) {
+          int c = min_cost + (forward ? g.edge_value(min_node, neighbor) : g.edge_value(neighbor, min_node));
+          if (!this_settled.contains(neighbor) && (!this_map.has_key(neighbor) || c < this_map[neighbor].cost)) {
+             this_map[neighbor] = Info(neighbor);
+             this_map[neighbor].cost = c;
+             this_map[neighbor].from = min_node;
+             pq.enqueue(NodePriority(c, neighbor));
+          }
+          if (other_map.has_key(neighbor)) {
+             long long total = (long long)c + other_map[neighbor].cost;
+             if (total < best) {
+                best = total;
+                meet = neighbor;
+             }
+          }
+       }
+}
+
+
+//Dijkstra forward from start_node (along out_nodes) and backward from
+//  stop_node (along in_nodes), expanding the side with the smaller queue. It
+//  stops when the two cheapest queued costs add up to at least the best path
+//  found through a node reached from both sides. In the backward map, from is
+//  the next node toward stop_node.
+template<class Graph>
+PathQuery bidirectional_shortest_path(const Graph &g, std::string start_node, std::string stop_node) {
+       check_query_nodes(g, "bidirectional_shortest_path", start_node, stop_node);
+       PathQuery answer;
+       if (start_node == stop_node) {
+          answer.found   = true;
+          answer.cost    = 0;
+          answer.settled = 1;
+          answer.path.enqueue(start_node);
+          return answer;
+       }
+
+       CostMap forward_map, backward_map;
+       NameSet forward_settled, backward_settled;
+       NodePriorityPQ forward_pq, backward_pq;
+       forward_map[start_node] = Info(start_node);
+       forward_map[start_node].cost = 0;
+       forward_pq.enqueue(NodePriority(0, start_node));
+       backward_map[stop_node] = Info(stop_node);
+       backward_map[stop_node].cost = 0;
+       backward_pq.enqueue(NodePriority(0, stop_node));
+
+       int best = std::numeric_limits<int>::max();
+       std::string meet;
+       while (!forward_pq.empty() && !backward_pq.empty()) {
+            if ((long long)forward_pq.peek().first + backward_pq.peek().first >= best)
+               break;
+            if (forward_pq.size() <= backward_pq.size())
+               bidirectional_step(g, true,  forward_pq,  forward_map,  forward_settled,  backward_map, best, meet, answer.settled);
+            else
+               bidirectional_step(g, false, backward_pq, backward_map, backward_settled, forward_map,  best, meet, answer.settled);
+       }
+
+       if (best == std::numeric_limits<int>::max())
+          return answer;
+       answer.found = true;
+       answer.cost  = best;
+       answer.path  = recover_path(forward_map, meet);
+       for (std::string next = backward_map[meet].from; next != "?"; next = backward_map[next].from)
+          answer.path.enqueue(next);
+       return answer;
+}
+
+
 }
 
 #endif /* DIJKSTRA_HPP_ */
@@ -0,0 +1,120 @@
+#ifndef DISJOINT_SETS_HPP_
+#define DISJOINT_SETS_HPP_
+
+#include <vector>
+#include <algorithm>
+
+
+namespace ics {
+
+
+//DisjointSets is a union-find over the ids 0 to size()-1, stored in two
+//  contiguous arrays: find uses path halving (every other node on the path is
+//  made to refer to its grandparent) and unite links the smaller set's root
+//  under the larger's, so both take near constant time. Graph algorithms use
+//  it after interning node names as ids (see CSRGraph, EdgeList).
+class DisjointSets {
+  public:
+    //Destructor/Constructors
+    ~DisjointSets();
+    explicit DisjointSets(int n = 0);              //Singletons 0 to n-1
+
+    //Queries
+    int size     () const;                         //Number of ids
+    int set_count() const;                         //Number of disjoint sets
+
+    //Commands (find compresses paths)
+    void reset   (int n);                          //Singletons 0 to n-1
+    int  add     ();                               //Add a singleton; returns its id
+    int  find    (int a);                          //Root of a's set
+    bool unite   (int a, int b);                   //False if already in the same set
+    int  set_size(int a);
+
+  private:
+    std::vector<int> parent;
+    std::vector<int> root_size;                    //Meaningful only at roots
+    int              sets = 0;
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//DisjointSets: Destructor/Constructors
+
+DisjointSets::~DisjointSets()
+{}
+
+
+DisjointSets::DisjointSets(int n) {
+      reset(n);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//DisjointSets: Queries
+
+int DisjointSets::size() const {
+      return parent.size();
+}
+
+
+int DisjointSets::set_count() const {
+      return sets;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//DisjointSets: Commands
+
+void DisjointSets::reset(int n) {
+      parent.resize(n);
+      root_size.assign(n, 1);
+      for (int i = 0; i < n; ++i)
+        parent[i] = i;
+      sets = n;
+}
+
+
+int DisjointSets::add() {
+      parent.push_back(parent.size());
+      root_size.push_back(1);
+      ++sets;
+      return parent.size() - 1;
+}
+
+
+int DisjointSets::find(int a) {
+      while (parent[a] != a) {
+        parent[a] = parent[parent[a]];
+        a = parent[a];
+      }
+      return a;
+}
+
+
+bool DisjointSets::unite(int a, int b) {
+      a = find(a);
+      b = find(b);
+      if (a == b)
+        return false;
+      if (root_size[a] < root_size[b])
+        std::swap(a, b);
+      parent[b]     = a;
+      root_size[a] += root_size[b];
+      --sets;
+      return true;
+}
+
+
+int DisjointSets::set_size(int a) {
+      return root_size[find(a)];
+}
+
+
+}
+
+#endif /* DISJOINT_SETS_HPP_ */
@@ -0,0 +1,251 @@
+#ifndef DYNAMIC_DIJKSTRA_HPP_
+#define DYNAMIC_DIJKSTRA_HPP_
+
+#include <string>
+#include <vector>
+#include <limits>
+#include "ics_exceptions.hpp"
+#include "hash_graph.hpp"
+#include "dijkstra.hpp"
+
+
+namespace ics {
+
+
+//A DynamicDijkstra keeps extended_dijkstra(g, start_node) up to date while g
+//  changes, repairing only the part of the answer a change affects (in the
+//  style of Ramalingam and Reps). It subscribes to g, which must outlive it.
+//  - A cheaper or new edge o->d that lowers d's cost starts a Dijkstra search
+//    from d that goes only as far as costs keep dropping.
+//  - A costlier or removed edge o->d matters only if it is d's from edge:
+//    then every node whose cheapest path runs through it (d's subtree in the
+//    tree of from edges) is invalidated; each gets a tentative cost from its
+//    in-edges from valid nodes, and a Dijkstra search among the invalidated
+//    nodes settles them (those it cannot reach become unreachable).
+//  - clear or = recompute everything.
+//The answer has the same form as extended_dijkstra's: only reachable nodes
+//  are in it, so recover_path can use it.
+class DynamicDijkstra : public DistGraph::Observer {
+  public:
+    //Destructor/Constructors
+    ~DynamicDijkstra();
+    DynamicDijkstra(DistGraph& g, std::string start_node);
+    DynamicDijkstra(const DynamicDijkstra& d)             = delete;
+    DynamicDijkstra& operator = (const DynamicDijkstra& d) = delete;
+
+    //Queries
+    const CostMap&     costs       () const;
+    const std::string& start_node  () const;
+    int                last_affected() const;     //Nodes whose Info the last change rewrote
+
+    //DistGraph::Observer: called by the graph
+    void node_added  (const std::string& node_name);
+    void node_removed(const std::string& node_name);
+    void edge_added  (const std::string& origin, const std::string& destination, const int& value);
+    void edge_changed(const std::string& origin, const std::string& destination, const int& old_value, const int& value);
+    void edge_removed(const std::string& origin, const std::string& destination, const int& old_value);
+    void graph_reset ();
+
+  private:
+    DistGraph*  graph;
+    std::string start;
+    CostMap     answer_map;
+    int         affected = 0;
+
+    //Helper methods
+    void cost_decreased(const std::string& origin, const std::string& destination, int value);
+    void cost_increased(const std::string& origin, const std::string& destination);
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//DynamicDijkstra: Destructor/Constructors
+
+DynamicDijkstra::~DynamicDijkstra() {
+      graph->unsubscribe(this);
+}
+
+
+DynamicDijkstra::DynamicDijkstra(DistGraph& g, std::string start_node)
+: graph(&g), start(start_node) {
+      if (!g.has_node(start_node)) {
+          std::ostringstream answer;
+          answer << "GraphError::DynamicDijkstra: key(" << start_node << ") not in Map";
+          throw GraphError(answer.str());
+      }
+      answer_map = extended_dijkstra(g, start_node);
+      g.subscribe(this);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//DynamicDijkstra: Queries
+
+const CostMap& DynamicDijkstra::costs() const {
+      return answer_map;
+}
+
+
+const std::string& DynamicDijkstra::start_node() const {
+      return start;
+}
+
+
+int DynamicDijkstra::last_affected() const {
+      return affected;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//DynamicDijkstra: DistGraph::Observer
+
+//A start node removed and then added back is reachable again (from itself)
+void DynamicDijkstra::node_added(const std::string& node_name) {
+      affected = 0;
+      if (node_name == start) {
+          Info info(start);
+          info.cost = 0;
+          answer_map[start] = info;
+          affected = 1;
+      }
+}
+
+
+//Its edges are already gone (so it heads no subtree): just forget it
+void DynamicDijkstra::node_removed(const std::string& node_name) {
+      affected = 0;
+      if (answer_map.has_key(node_name)) {
+          answer_map.erase(node_name);
+          affected = 1;
+      }
+}
+
+
+void DynamicDijkstra::edge_added(const std::string& origin, const std::string& destination, const int& value) {
+      affected = 0;
+      cost_decreased(origin, destination, value);
+}
+
+
+void DynamicDijkstra::edge_changed(const std::string& origin, const std::string& destination, const int& old_value,
+                                   const int& value) {
+      affected = 0;
+      if (value < old_value)
+          cost_decreased(origin, destination, value);
+      else if (value > old_value)
+          cost_increased(origin, destination);
+}
+
+
+void DynamicDijkstra::edge_removed(const std::string& origin, const std::string& destination, const int& /*old_value*/) {
+      affected = 0;
+      cost_increased(origin, destination);
+}
+
+
+void DynamicDijkstra::graph_reset() {
+      answer_map = (graph->has_node(start) ? extended_dijkstra(*graph, start) : CostMap());
+      affected = answer_map.size();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//DynamicDijkstra: Private helper methods
+
+void DynamicDijkstra::cost_decreased(const std::string& origin, const std::string& destination, int value) {
+      if (!answer_map.has_key(origin))
+          return;
+      int c = answer_map[origin].cost + value;
+      if (answer_map.has_key(destination) && answer_map[destination].cost <= c)
+          return;
+
+      Info info(destination);
+      info.cost = c;
+      info.from = origin;
+      answer_map[destination] = info;
+      NodePriorityPQ pq;
+      pq.enqueue(NodePriority(c, destination));
+      while (!pq.empty()) {
+          NodePriority next = pq.dequeue();
+          if (next.first > answer_map[next.second].cost)
+              continue;
+          ++affected;
+          for (const std::string& d : graph->out_nodes(next.second)) {
+              int dc = next.first + graph->edge_value(next.second, d);
+              if (!answer_map.has_key(d) || dc < answer_map[d].cost) {
+                  Info better(d);
+                  better.cost = dc;
+                  better.from = next.second;
+                  answer_map[d] = better;
+                  pq.enqueue(NodePriority(dc, d));
+              }
+          }
+      }
+}
+
+
+void DynamicDijkstra::cost_increased(const std::string& origin, const std::string& destination) {
+      if (!answer_map.has_key(destination) || answer_map[destination].from != origin)
+          return;
+
+      //Invalidate the subtree of from edges below destination
+      NameSet invalid;
+      std::vector<std::string> subtree(1, destination);
+      invalid.insert(destination);
+      for (int i = 0; i < int(subtree.size()); ++i)
+          for (const std::string& d : graph->out_nodes(subtree[i]))
+              if (!invalid.contains(d) && answer_map.has_key(d) && answer_map[d].from == subtree[i]) {
+                  invalid.insert(d);
+                  subtree.push_back(d);
+              }
+      for (const std::string& n : subtree)
+          answer_map.erase(n);
+      affected = subtree.size();
+
+      //Cheapest way into each invalid node from a valid one, then Dijkstra
+      //  among the invalid nodes; nodes never dequeued stay unreachable
+      NodePriorityPQ pq;
+      for (const std::string& n : subtree) {
+          Info best(n);
+          for (const std::string& p : graph->in_nodes(n))
+              if (!invalid.contains(p) && answer_map.has_key(p)) {
+                  int c = answer_map[p].cost + graph->edge_value(p, n);
+                  if (c < best.cost) {
+                      best.cost = c;
+                      best.from = p;
+                  }
+              }
+          if (best.cost != std::numeric_limits<int>::max()) {
+              answer_map[n] = best;
+              pq.enqueue(NodePriority(best.cost, n));
+          }
+      }
+      while (!pq.empty()) {
+          NodePriority next = pq.dequeue();
+          if (next.first > answer_map[next.second].cost)
+              continue;
+          for (const std::string& d : graph->out_nodes(next.second)) {
+              if (!invalid.contains(d))
+                  continue;
+              int dc = next.first + graph->edge_value(next.second, d);
+              if (!answer_map.has_key(d) || dc < answer_map[d].cost) {
+                  Info better(d);
+                  better.cost = dc;
+                  better.from = next.second;
+                  answer_map[d] = better;
+                  pq.enqueue(NodePriority(dc, d));
+              }
+          }
+      }
+}
+
+
+}
+
+#endif /* DYNAMIC_DIJKSTRA_HPP_ */
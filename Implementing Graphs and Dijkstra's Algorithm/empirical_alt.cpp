@@ -0,0 +1,89 @@
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <random>
+#include "ics46goody.hpp"
+#include "stopwatch.hpp"
+#include "hash_graph.hpp"
+#include "dijkstra.hpp"
+#include "alt_index.hpp"
+
+
+//Compare the search space (average nodes settled per query) and time of
+//  early-stopping Dijkstra, bidirectional Dijkstra, and ALT-guided A* on a
+//  road-like graph: a square grid of two-way streets with random costs.
+
+std::string node_name(int x, int y) {
+  std::ostringstream name;
+  name << x << "," << y;
+  return name.str();
+}
+
+
+template<class Query>
+void time_queries(const std::string& title, const std::vector<std::pair<std::string,std::string>>& queries,
+                  Query query, long long& cost_sum) {
+  ics::Stopwatch watch;
+  long long settled = 0;
+  watch.start();
+  for (const auto& q : queries) {
+    ics::PathQuery answer = query(q.first, q.second);
+    settled  += answer.settled;
+    cost_sum += answer.cost;
+  }
+  watch.stop();
+  std::cout << "  " << title << ": average settled = " << double(settled)/queries.size()
+            << ", time = " << watch.read() << std::endl;
+}
+
+
+int main() {
+  try {
+    int side      = ics::prompt_int("Enter grid side length",60);
+    int landmarks = ics::prompt_int("Enter number of landmarks",16);
+    int count     = ics::prompt_int("Enter number of queries",100);
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<int> cost_distribution(10,20);
+    std::uniform_int_distribution<int> coordinate(0,side-1);
+    ics::DistGraph g;
+    for (int x=0; x<side; ++x)
+      for (int y=0; y<side; ++y) {
+        if (x+1 < side) {
+          int c = cost_distribution(generator);
+          g.add_edge(node_name(x,y), node_name(x+1,y), c);
+          g.add_edge(node_name(x+1,y), node_name(x,y), c);
+        }
+        if (y+1 < side) {
+          int c = cost_distribution(generator);
+          g.add_edge(node_name(x,y), node_name(x,y+1), c);
+          g.add_edge(node_name(x,y+1), node_name(x,y), c);
+        }
+      }
+
+    std::vector<std::pair<std::string,std::string>> queries;
+    for (int i=0; i<count; ++i)
+      queries.push_back(std::make_pair(node_name(coordinate(generator),coordinate(generator)),
+                                       node_name(coordinate(generator),coordinate(generator))));
+
+    ics::Stopwatch watch;
+    watch.start();
+    ics::ALTIndex alt(g, landmarks);
+    watch.stop();
+    std::cout << "ALT preprocessing (" << alt.landmark_count() << " landmarks) time = " << watch.read() << std::endl;
+
+    long long sums[3] = {0,0,0};
+    std::cout << std::endl << count << " queries on a " << side << "x" << side << " grid (" << g.node_count() << " nodes)" << std::endl;
+    time_queries("Dijkstra (early stop)", queries,
+                 [&g] (const std::string& s, const std::string& t) {return ics::shortest_path(g,s,t);}, sums[0]);
+    time_queries("bidirectional Dijkstra", queries,
+                 [&g] (const std::string& s, const std::string& t) {return ics::bidirectional_shortest_path(g,s,t);}, sums[1]);
+    time_queries("ALT A*", queries,
+                 [&g,&alt] (const std::string& s, const std::string& t) {return alt.query(g,s,t);}, sums[2]);
+    std::cout << "  (cost sums " << sums[0] << "/" << sums[1] << "/" << sums[2] << " should agree)" << std::endl;
+  } catch (ics::IcsError& e) {
+    std::cout << "  " << e.what() << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,106 @@
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <random>
+#include <cstdlib>                   //std::malloc, std::free
+#include <cstddef>                   //std::max_align_t
+#include <new>                       //std::bad_alloc
+#include "ics46goody.hpp"
+#include "stopwatch.hpp"
+#include "hash_graph.hpp"
+#include "compact_graph.hpp"
+
+
+//Compare HashGraph and CompactGraph on a sparse random graph (each node has a
+//  handful of edges): heap bytes in use after building, and the time to add
+//  the edges and then to remove a tenth of the nodes.
+
+//Count the heap bytes in use: every allocation in this program goes through
+//  these, which store each block's size just before the block
+static long long heap_in_use = 0;
+
+void* operator new(std::size_t size) {
+  std::size_t* block = static_cast<std::size_t*>(std::malloc(size + sizeof(std::max_align_t)));
+  if (block == nullptr)
+    throw std::bad_alloc();
+  *block = size;
+  heap_in_use += size;
+  return reinterpret_cast<char*>(block) + sizeof(std::max_align_t);
+}
+
+void operator delete(void* p) noexcept {
+  if (p == nullptr)
+    return;
+  std::size_t* block = reinterpret_cast<std::size_t*>(static_cast<char*>(p) - sizeof(std::max_align_t));
+  heap_in_use -= *block;
+  std::free(block);
+}
+
+void* operator new[](std::size_t size)   {return operator new(size);}
+void  operator delete[](void* p) noexcept {operator delete(p);}
+
+//The sized forms (C++14) ignore the size: the block header already holds it
+void  operator delete  (void* p, std::size_t) noexcept {operator delete(p);}
+void  operator delete[](void* p, std::size_t) noexcept {operator delete(p);}
+
+
+std::string node_name(int i) {
+  std::ostringstream name;
+  name << "n" << i;
+  return name.str();
+}
+
+
+template<class Graph>
+void time_graph(const std::string& title, int nodes, const std::vector<int>& origins,
+                const std::vector<int>& destinations, const std::vector<int>& removed) {
+  long long heap_before = heap_in_use;
+  ics::Stopwatch watch;
+  {
+    Graph g;
+    watch.start();
+    for (int i=0; i<nodes; ++i)
+      g.add_node(node_name(i));
+    for (int i=0; i<int(origins.size()); ++i)
+      g.add_edge(node_name(origins[i]), node_name(destinations[i]), i);
+    watch.stop();
+    long long bytes = heap_in_use - heap_before;
+    std::cout << title << std::endl;
+    std::cout << "  add_node/add_edge time = " << watch.read() << std::endl;
+    std::cout << "  heap bytes             = " << bytes << " (" << double(bytes)/origins.size() << " per edge)" << std::endl;
+
+    watch.reset();
+    watch.start();
+    for (int n : removed)
+      g.remove_node(node_name(n));
+    watch.stop();
+    std::cout << "  remove_node time       = " << watch.read() << " (" << g.edge_count() << " edges left)" << std::endl;
+  }
+}
+
+
+int main() {
+  try {
+    int nodes        = ics::prompt_int("Enter number of nodes",100000);
+    int edges_per    = ics::prompt_int("Enter average out-degree",4);
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<int> node_distribution(0,nodes-1);
+    std::vector<int> origins, destinations, removed;
+    for (int i=0; i<nodes*edges_per; ++i) {
+      origins.push_back(node_distribution(generator));
+      destinations.push_back(node_distribution(generator));
+    }
+    for (int i=0; i<nodes/10; ++i)
+      removed.push_back(node_distribution(generator));
+
+    std::cout << nodes << " nodes, " << origins.size() << " edges added, " << removed.size() << " removals" << std::endl;
+    time_graph<ics::HashGraph<int>>   ("HashGraph",   nodes, origins, destinations, removed);
+    time_graph<ics::CompactGraph<int>>("CompactGraph",nodes, origins, destinations, removed);
+  } catch (ics::IcsError& e) {
+    std::cout << "  " << e.what() << std::endl;
+  }
+
+  return 0;
+}
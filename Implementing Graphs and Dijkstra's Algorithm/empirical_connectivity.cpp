@@ -0,0 +1,138 @@
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <random>
+#include "ics46goody.hpp"
+#include "stopwatch.hpp"
+#include "hash_set.hpp"
+#include "array_queue.hpp"
+#include "hash_graph.hpp"
+#include "connectivity_index.hpp"
+
+
+//Run a random stream of operations on an undirected HashGraph (each edge
+//  added both ways): mostly edge additions, some "are a and b connected?"
+//  queries, and a few edge removals. Answer the queries with a
+//  ConnectivityIndex subscribed to the graph, and then (on the same stream,
+//  replayed on a new graph) with a breadth-first traversal for every
+//  sample_every-th query; compare the average time per query and check that
+//  the answers agree.
+
+std::string node_name(int i) {
+  std::ostringstream name;
+  name << "n" << i;
+  return name.str();
+}
+
+
+struct Operation {
+  char kind;           //'a'dd edge, 'r'emove edge, 'q'uery
+  int  a, b;
+};
+
+
+bool traversal_connected(const ics::HashGraph<int>& g, const std::string& a, const std::string& b) {
+  ics::HashSet<std::string, ics::HashGraph<int>::hash_str> visited;
+  ics::ArrayQueue<std::string> queue;
+  visited.insert(a);
+  queue.enqueue(a);
+  while (!queue.empty()) {
+    std::string n = queue.dequeue();
+    if (n == b)
+      return true;
+    for (const std::string& m : g.out_nodes(n))
+      if (visited.insert(m))
+        queue.enqueue(m);
+  }
+  return false;
+}
+
+
+int main() {
+  try {
+    int nodes          = ics::prompt_int("Enter number of nodes",5000);
+    int operations     = ics::prompt_int("Enter number of operations",50000);
+    int query_percent  = ics::prompt_int("Enter percent of operations that are queries",30);
+    int remove_percent = ics::prompt_int("Enter percent of operations that remove an edge",1);
+    int sample_every   = ics::prompt_int("Time a traversal for every how many queries",1000);
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<int> node_distribution(0,nodes-1);
+    std::uniform_int_distribution<int> percent_distribution(0,99);
+    std::vector<Operation> stream;
+    std::vector<std::pair<int,int>> edges;
+    for (int i=0; i<operations; ++i) {
+      int p = percent_distribution(generator);
+      Operation o;
+      if (p < query_percent)
+        o = Operation{'q', node_distribution(generator), node_distribution(generator)};
+      else if (p < query_percent+remove_percent && !edges.empty()) {
+        std::uniform_int_distribution<int> edge_distribution(0,edges.size()-1);
+        std::pair<int,int> e = edges[edge_distribution(generator)];
+        o = Operation{'r', e.first, e.second};
+      } else {
+        o = Operation{'a', node_distribution(generator), node_distribution(generator)};
+        edges.push_back(std::make_pair(o.a, o.b));
+      }
+      stream.push_back(o);
+    }
+
+    ics::HashGraph<int> g;
+    for (int i=0; i<nodes; ++i)
+      g.add_node(node_name(i));
+    ics::ConnectivityIndex<int> index(g);
+    ics::Stopwatch update_watch, query_watch;
+    std::vector<bool> answers;
+    for (const Operation& o : stream)
+      if (o.kind == 'q') {
+        query_watch.start();
+        answers.push_back(index.connected(node_name(o.a), node_name(o.b)));
+        query_watch.stop();
+      } else {
+        update_watch.start();
+        if (o.kind == 'a') {
+          g.add_edge(node_name(o.a), node_name(o.b), 1);
+          g.add_edge(node_name(o.b), node_name(o.a), 1);
+        } else {
+          g.remove_edge(node_name(o.a), node_name(o.b));
+          g.remove_edge(node_name(o.b), node_name(o.a));
+        }
+        update_watch.stop();
+      }
+    int queries = answers.size();
+    std::cout << nodes << " nodes, " << operations << " operations (" << queries << " queries), "
+              << g.edge_count()/2 << " edges at the end, " << index.component_count() << " components" << std::endl;
+    std::cout << "  ConnectivityIndex: updates time = " << update_watch.read() << ", average query time = "
+              << query_watch.read()/queries << " (" << index.rebuild_count() << " rebuilds)" << std::endl;
+
+    ics::HashGraph<int> h;
+    for (int i=0; i<nodes; ++i)
+      h.add_node(node_name(i));
+    ics::Stopwatch traversal_watch;
+    int q = 0, sampled = 0, agree = 0;
+    for (const Operation& o : stream)
+      if (o.kind == 'q') {
+        if (q % sample_every == 0) {
+          traversal_watch.start();
+          bool answer = traversal_connected(h, node_name(o.a), node_name(o.b));
+          traversal_watch.stop();
+          ++sampled;
+          agree += answer == answers[q];
+        }
+        ++q;
+      } else if (o.kind == 'a') {
+        h.add_edge(node_name(o.a), node_name(o.b), 1);
+        h.add_edge(node_name(o.b), node_name(o.a), 1);
+      } else {
+        h.remove_edge(node_name(o.a), node_name(o.b));
+        h.remove_edge(node_name(o.b), node_name(o.a));
+      }
+    std::cout << "  traversal:         average query time = " << traversal_watch.read()/sampled
+              << " (" << sampled << " sampled queries, " << agree << " answers agree)" << std::endl;
+  } catch (ics::IcsError& e) {
+    std::cout << "  " << e.what() << std::endl;
+  }
+
+  return 0;
+}
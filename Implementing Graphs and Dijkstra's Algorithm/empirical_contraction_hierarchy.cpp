@@ -0,0 +1,115 @@
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <random>
+#include "ics46goody.hpp"
+#include "stopwatch.hpp"
+#include "hash_graph.hpp"
+#include "csr_graph.hpp"
+#include "dijkstra.hpp"
+#include "contraction_hierarchy.hpp"
+
+
+//Time contraction hierarchy preprocessing and compare its queries (average
+//  nodes settled and time) with bidirectional Dijkstra on two generated
+//  graphs: a square grid of two-way streets with random costs, and a
+//  road-like grid where a fifth of the streets are missing and every tenth
+//  row and column is a highway whose edges cost a third as much.
+
+std::string node_name(int x, int y) {
+  std::ostringstream name;
+  name << x << "," << y;
+  return name.str();
+}
+
+
+void add_street(ics::DistGraph& g, int x1, int y1, int x2, int y2, int c) {
+  g.add_edge(node_name(x1,y1), node_name(x2,y2), c);
+  g.add_edge(node_name(x2,y2), node_name(x1,y1), c);
+}
+
+
+ics::DistGraph make_graph(int side, bool road_like, std::default_random_engine& generator) {
+  std::uniform_int_distribution<int> cost_distribution(10,20);
+  std::bernoulli_distribution missing(road_like ? 0.2 : 0.0);
+  ics::DistGraph g;
+  for (int x=0; x<side; ++x)
+    for (int y=0; y<side; ++y) {
+      g.add_node(node_name(x,y));
+      if (x+1 < side) {
+        bool highway = road_like && y%10 == 0;
+        int c = cost_distribution(generator);
+        if (highway || !missing(generator))
+          add_street(g, x, y, x+1, y, highway ? c/3 : c);
+      }
+      if (y+1 < side) {
+        bool highway = road_like && x%10 == 0;
+        int c = cost_distribution(generator);
+        if (highway || !missing(generator))
+          add_street(g, x, y, x, y+1, highway ? c/3 : c);
+      }
+    }
+  return g;
+}
+
+
+void compare(const std::string& title, const ics::DistGraph& g, int side, int count,
+             std::default_random_engine& generator) {
+  std::uniform_int_distribution<int> coordinate(0,side-1);
+  std::vector<std::pair<std::string,std::string>> queries;
+  for (int i=0; i<count; ++i)
+    queries.push_back(std::make_pair(node_name(coordinate(generator),coordinate(generator)),
+                                     node_name(coordinate(generator),coordinate(generator))));
+
+  std::cout << std::endl << title << ": " << g.node_count() << " nodes, " << g.edge_count() << " edges" << std::endl;
+  ics::Stopwatch watch;
+  watch.start();
+  ics::ContractionHierarchy ch(g);
+  watch.stop();
+  std::cout << "  preprocessing time = " << watch.read() << " (" << ch.shortcut_count() << " shortcuts)" << std::endl;
+
+  long long settled[2] = {0,0}, cost_sum[2] = {0,0};
+  double    seconds[2];
+  watch.reset();
+  watch.start();
+  for (const auto& q : queries) {
+    ics::PathQuery answer = ics::bidirectional_shortest_path(g, q.first, q.second);
+    settled[0]  += answer.settled;
+    cost_sum[0] += answer.cost;
+  }
+  watch.stop();
+  seconds[0] = watch.read();
+
+  watch.reset();
+  watch.start();
+  for (const auto& q : queries) {
+    ics::PathQuery answer = ch.query(q.first, q.second);
+    settled[1]  += answer.settled;
+    cost_sum[1] += answer.cost;
+  }
+  watch.stop();
+  seconds[1] = watch.read();
+
+  std::cout << "  bidirectional Dijkstra: average settled = " << double(settled[0])/count
+            << ", average query time = " << seconds[0]/count << std::endl;
+  std::cout << "  contraction hierarchy:  average settled = " << double(settled[1])/count
+            << ", average query time = " << seconds[1]/count << std::endl;
+  std::cout << "  (cost sums " << cost_sum[0] << "/" << cost_sum[1] << " should agree)" << std::endl;
+}
+
+
+int main() {
+  try {
+    int side  = ics::prompt_int("Enter grid side length",100);
+    int count = ics::prompt_int("Enter number of queries",100);
+
+    std::default_random_engine generator;
+    compare("Grid",      make_graph(side, false, generator), side, count, generator);
+    compare("Road-like", make_graph(side, true,  generator), side, count, generator);
+  } catch (ics::IcsError& e) {
+    std::cout << "  " << e.what() << std::endl;
+  }
+
+  return 0;
+}
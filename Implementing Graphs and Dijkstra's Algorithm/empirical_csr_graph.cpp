@@ -0,0 +1,79 @@
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <random>
+#include "ics46goody.hpp"
+#include "stopwatch.hpp"
+#include "hash_graph.hpp"
+#include "csr_graph.hpp"
+#include "dijkstra.hpp"
+
+
+//Time extended_dijkstra on a random HashGraph and on its CSRGraph snapshot
+//  (HashGraph::freeze), checking that both find the same costs
+
+std::string node_name(int i) {
+  std::ostringstream name;
+  name << "n" << i;
+  return name.str();
+}
+
+
+int main() {
+  try {
+    int nodes = ics::prompt_int("Enter number of nodes",100000);
+    int edges = ics::prompt_int("Enter number of edges",1000000);
+    int runs  = ics::prompt_int("Enter number of start nodes to time",3);
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<int> node_distribution(0,nodes-1);
+    std::uniform_int_distribution<int> cost_distribution(1,1000);
+
+    ics::Stopwatch watch;
+    watch.start();
+    ics::DistGraph g;
+    for (int i=0; i<nodes; ++i)
+      g.add_node(node_name(i));
+    for (int i=0; i<edges; ++i)
+      g.add_edge(node_name(node_distribution(generator)), node_name(node_distribution(generator)), cost_distribution(generator));
+    watch.stop();
+    std::cout << "HashGraph build time = " << watch.read() << std::endl;
+
+    watch.reset();
+    watch.start();
+    ics::CSRGraph<int> csr = g.freeze();
+    watch.stop();
+    std::cout << "freeze time          = " << watch.read() << std::endl;
+
+    double hash_time = 0, csr_time = 0;
+    for (int r=0; r<runs; ++r) {
+      std::string start = node_name(node_distribution(generator));
+
+      watch.reset();
+      watch.start();
+      ics::CostMap hash_answer = extended_dijkstra(g, start);
+      watch.stop();
+      hash_time += watch.read();
+
+      watch.reset();
+      watch.start();
+      ics::CostMap csr_answer = extended_dijkstra(csr, start);
+      watch.stop();
+      csr_time += watch.read();
+
+      bool same = hash_answer.size() == csr_answer.size();
+      for (auto kv : hash_answer)
+        same = same && csr_answer.has_key(kv.first) && csr_answer[kv.first].cost == kv.second.cost;
+      std::cout << "  start " << start << ": " << hash_answer.size() << " reached, costs "
+                << (same ? "agree" : "DISAGREE") << std::endl;
+    }
+
+    std::cout << std::endl << "extended_dijkstra average time over " << runs << " start nodes" << std::endl;
+    std::cout << "  HashGraph = " << hash_time/runs << std::endl;
+    std::cout << "  CSRGraph  = " << csr_time/runs << std::endl;
+  } catch (ics::IcsError& e) {
+    std::cout << "  " << e.what() << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,104 @@
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <random>
+#include "ics46goody.hpp"
+#include "stopwatch.hpp"
+#include "csr_graph.hpp"
+#include "dijkstra.hpp"
+#include "delta_stepping.hpp"
+
+
+//Compare sequential csr_dijkstra with delta_stepping (several deltas, and 1,
+//  2, 4, ... threads up to twice the hardware threads) on two synthetic
+//  graphs with over a million edges: a random graph with random costs, and a
+//  square grid of two-way streets. Every run must compute the same costs.
+//Then check a small graph with delta = 1 and one edge of value 10^9, whose
+//  buckets would number 10^9 if the empty ones were stored too.
+//Compile with -pthread.
+
+std::string node_name(int i) {
+  std::ostringstream name;
+  name << "n" << i;
+  return name.str();
+}
+
+
+void compare(const std::string& title, const ics::CSRGraph<int>& g, int start) {
+  std::cout << std::endl << title << ": " << g.node_count() << " nodes, " << g.edge_count() << " edges" << std::endl;
+  ics::Stopwatch watch;
+  std::vector<int> expected, cost, from;
+  watch.start();
+  ics::csr_dijkstra(g, start, expected, from);
+  watch.stop();
+  double sequential = watch.read();
+  std::cout << "  csr_dijkstra: time = " << sequential << std::endl;
+
+  for (int delta : {0, 10, 50, 200})
+    for (int threads=1; threads<=2*ics::thread_count(0); threads*=2) {
+      watch.reset();
+      watch.start();
+      ics::delta_stepping(g, start, delta, cost, from, threads);
+      watch.stop();
+      std::cout << "  delta_stepping(delta = " << (delta == 0 ? "average" : std::to_string(delta)) << ", threads = "
+                << threads << "): time = " << watch.read() << ", speedup = " << sequential/watch.read()
+                << (cost == expected ? "" : " (DIFFERENT COSTS)") << std::endl;
+    }
+}
+
+
+int main() {
+  try {
+    int nodes = ics::prompt_int("Enter number of random-graph nodes (5 edges each)",250000);
+    int side  = ics::prompt_int("Enter grid side length",600);
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<int> cost_distribution(1,100);
+    std::vector<std::string> names;
+    std::vector<int> origins, destinations, values;
+
+    std::uniform_int_distribution<int> node_distribution(0,nodes-1);
+    for (int i=0; i<nodes; ++i) {
+      names.push_back(node_name(i));
+      for (int j=0; j<5; ++j) {
+        origins.push_back(i);
+        destinations.push_back(node_distribution(generator));
+        values.push_back(cost_distribution(generator));
+      }
+    }
+    compare("Random graph", ics::CSRGraph<int>(names, origins, destinations, values), 0);
+
+    names.clear();
+    origins.clear();
+    destinations.clear();
+    values.clear();
+    for (int i=0; i<side*side; ++i) {
+      names.push_back(node_name(i));
+      int x = i%side, y = i/side;
+      for (int neighbor : {x+1 < side ? i+1 : -1, y+1 < side ? i+side : -1})
+        if (neighbor != -1) {
+          int c = cost_distribution(generator);
+          origins.push_back(i);      destinations.push_back(neighbor); values.push_back(c);
+          origins.push_back(neighbor); destinations.push_back(i);      values.push_back(c);
+        }
+    }
+    compare("Grid", ics::CSRGraph<int>(names, origins, destinations, values), side*side/2 + side/2);
+
+    names   = {"a", "b", "c", "d"};
+    origins = {0, 0, 1, 2}; destinations = {1, 2, 3, 3}; values = {1, 1000000000, 2, 1};
+    ics::CSRGraph<int> huge_edge(names, origins, destinations, values);
+    std::vector<int> expected, cost, from;
+    ics::csr_dijkstra(huge_edge, 0, expected, from);
+    ics::Stopwatch watch;
+    watch.start();
+    ics::delta_stepping(huge_edge, 0, 1, cost, from, 2);
+    watch.stop();
+    std::cout << std::endl << "delta = 1 with an edge of value 10^9: time = " << watch.read()
+              << (cost == expected ? "" : " (DIFFERENT COSTS)") << std::endl;
+  } catch (ics::IcsError& e) {
+    std::cout << "  " << e.what() << std::endl;
+  }
+
+  return 0;
+}
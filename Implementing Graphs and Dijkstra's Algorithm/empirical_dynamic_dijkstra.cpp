@@ -0,0 +1,94 @@
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <random>
+#include "ics46goody.hpp"
+#include "stopwatch.hpp"
+#include "hash_graph.hpp"
+#include "dijkstra.hpp"
+#include "dynamic_dijkstra.hpp"
+
+
+//Apply a random stream of updates (add an edge, change an edge's value, or
+//  remove an edge) to a sparse random graph, and compare the time for a
+//  DynamicDijkstra to repair its answer after each one with the time to
+//  rerun extended_dijkstra after each one. Both answers must agree at the end.
+
+std::string node_name(int i) {
+  std::ostringstream name;
+  name << "n" << i;
+  return name.str();
+}
+
+
+int main() {
+  try {
+    int nodes     = ics::prompt_int("Enter number of nodes",5000);
+    int edges_per = ics::prompt_int("Enter average out-degree",4);
+    int updates   = ics::prompt_int("Enter number of updates",200);
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<int> node_distribution(0,nodes-1);
+    std::uniform_int_distribution<int> cost_distribution(1,100);
+    std::uniform_int_distribution<int> kind_distribution(0,2);
+    ics::DistGraph g;
+    std::vector<std::pair<int,int>> edges;
+    for (int i=0; i<nodes; ++i)
+      g.add_node(node_name(i));
+    for (int i=0; i<nodes*edges_per; ++i) {
+      edges.push_back(std::make_pair(node_distribution(generator), node_distribution(generator)));
+      g.add_edge(node_name(edges.back().first), node_name(edges.back().second), cost_distribution(generator));
+    }
+
+    ics::DistGraph copy(g);
+    ics::DynamicDijkstra dynamic(g, node_name(0));
+    ics::Stopwatch dynamic_watch, full_watch;
+    long long affected = 0;
+    ics::CostMap full;
+    for (int u=0; u<updates; ++u) {
+      int kind = kind_distribution(generator);
+      std::uniform_int_distribution<int> edge_distribution(0,edges.size()-1);
+      int e = edge_distribution(generator);
+      std::string origin, destination;
+      if (kind == 0) {
+        edges.push_back(std::make_pair(node_distribution(generator), node_distribution(generator)));
+        e = edges.size()-1;
+      }
+      origin      = node_name(edges[e].first);
+      destination = node_name(edges[e].second);
+      int value   = cost_distribution(generator);
+
+      dynamic_watch.start();
+      if (kind == 2)
+        g.remove_edge(origin, destination);
+      else
+        g.add_edge(origin, destination, value);
+      dynamic_watch.stop();
+      affected += dynamic.last_affected();
+
+      if (kind == 2)
+        copy.remove_edge(origin, destination);
+      else
+        copy.add_edge(origin, destination, value);
+      full_watch.start();
+      full = ics::extended_dijkstra(copy, node_name(0));
+      full_watch.stop();
+    }
+
+    bool agree = full.size() == dynamic.costs().size();
+    for (const ics::CostMapEntry& e : full)
+      agree = agree && dynamic.costs().has_key(e.first) && dynamic.costs()[e.first].cost == e.second.cost;
+
+    std::cout << nodes << " nodes, " << g.edge_count() << " edges, " << updates << " updates" << std::endl;
+    std::cout << "  DynamicDijkstra repairs:   time = " << dynamic_watch.read()
+              << " (average " << double(affected)/updates << " nodes affected per update)" << std::endl;
+    std::cout << "  extended_dijkstra reruns:  time = " << full_watch.read()
+              << " (" << full.size() << " nodes reachable)" << std::endl;
+    std::cout << "  answers " << (agree ? "agree" : "DIFFER") << std::endl;
+  } catch (ics::IcsError& e) {
+    std::cout << "  " << e.what() << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,87 @@
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <random>
+#include "ics46goody.hpp"
+#include "stopwatch.hpp"
+#include "hash_graph.hpp"
+#include "csr_graph.hpp"
+#include "graph_loader.hpp"
+
+
+//Write a large random graph in the text format of HashGraph::store, then time
+//  loading it with HashGraph::load (optional: slow and memory hungry), with
+//  load_graph_file using 1, 2, 4, ... threads, and from the binary format.
+//Compile with -pthread.
+
+std::string node_name(int i) {
+  std::ostringstream name;
+  name << "city" << i;
+  return name.str();
+}
+
+
+int main() {
+  try {
+    int nodes          = ics::prompt_int("Enter number of nodes",500000);
+    int edges          = ics::prompt_int("Enter number of edges",4000000);
+    bool use_hashgraph = ics::prompt_bool("Also time HashGraph::load",false);
+    std::string text_name   = ics::prompt_string("Enter text file name","empirical_graph.txt");
+    std::string binary_name = ics::prompt_string("Enter binary file name","empirical_graph.bin");
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<int> node_distribution(0,nodes-1);
+    std::uniform_int_distribution<int> cost_distribution(1,1000);
+    {
+      std::ofstream out_file(text_name);
+      for (int i=0; i<nodes; ++i)
+        out_file << node_name(i) << "\n";
+      for (int i=0; i<edges; ++i)
+        out_file << node_name(node_distribution(generator)) << ";" << node_name(node_distribution(generator))
+                 << ";" << cost_distribution(generator) << "\n";
+    }
+
+    ics::Stopwatch watch;
+    if (use_hashgraph) {
+      ics::HashGraph<int> g;
+      std::ifstream in_file(text_name);
+      watch.start();
+      g.load(in_file);
+      watch.stop();
+      std::cout << "HashGraph::load: time = " << watch.read() << " (" << g.edge_count() << " edges)" << std::endl;
+    }
+
+    ics::CSRGraph<int> first;
+    for (int threads=1; threads<=2*ics::thread_count(0); threads*=2) {
+      watch.reset();
+      watch.start();
+      ics::CSRGraph<int> g = ics::load_graph_file(text_name, ";", threads);
+      watch.stop();
+      std::cout << "load_graph_file(threads = " << threads << "): time = " << watch.read()
+                << " (" << g.edge_count() << " edges)" << std::endl;
+      if (threads == 1)
+        first = g;
+    }
+
+    {
+      std::ofstream out_file(binary_name, std::ios::binary);
+      watch.reset();
+      watch.start();
+      ics::store_binary(first, out_file);
+      watch.stop();
+      std::cout << "store_binary: time = " << watch.read() << std::endl;
+    }
+    std::ifstream in_file(binary_name, std::ios::binary);
+    watch.reset();
+    watch.start();
+    ics::CSRGraph<int> g = ics::load_binary(in_file);
+    watch.stop();
+    std::cout << "load_binary: time = " << watch.read() << (g == first ? "" : " (DIFFERENT GRAPH)") << std::endl;
+  } catch (ics::IcsError& e) {
+    std::cout << "  " << e.what() << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <random>
+#include "ics46goody.hpp"
+#include "stopwatch.hpp"
+#include "hash_graph.hpp"
+#include "minimum_spanning_forest.hpp"
+
+
+//Time MinimumSpanningForest with each method (sort, radix, filter) on a sparse
+//  random graph and a dense random graph, each with millions of edges built
+//  directly as an EdgeList; optionally also time extracting the EdgeList from
+//  a (smaller) HashGraph<int> with graph_edges. Every method must find a forest
+//  with the same total value.
+
+std::string node_name(int i) {
+  std::ostringstream name;
+  name << "n" << i;
+  return name.str();
+}
+
+
+ics::EdgeList random_edges(int nodes, int edges, std::default_random_engine& generator) {
+  std::uniform_int_distribution<int> node_distribution(0,nodes-1);
+  std::uniform_int_distribution<int> value_distribution(1,1000000);
+  ics::EdgeList answer;
+  for (int i=0; i<nodes; ++i)
+    answer.names.push_back(node_name(i));
+  for (int i=0; i<edges; ++i) {
+    int origin = node_distribution(generator);
+    answer.add_edge(origin, node_distribution(generator), value_distribution(generator));
+  }
+  return answer;
+}
+
+
+void compare(const std::string& title, const ics::EdgeList& edges) {
+  const char* method_names[] = {"sort", "radix", "filter"};
+  std::cout << title << ": " << edges.node_count() << " nodes, " << edges.edge_count() << " edges" << std::endl;
+  long long first_value = 0;
+  for (int m=0; m<3; ++m) {
+    ics::Stopwatch watch;
+    watch.start();
+    ics::MinimumSpanningForest f(edges, ics::MinimumSpanningForest::Method(m));
+    watch.stop();
+    if (m == 0)
+      first_value = f.total_value();
+    std::cout << "  " << method_names[m] << ": time = " << watch.read() << " (" << f.component_count()
+              << " trees, total value " << f.total_value();
+    if (m == ics::MinimumSpanningForest::filter)
+      std::cout << ", " << f.filtered_count() << " edges filtered unsorted";
+    std::cout << ")" << (f.total_value() == first_value ? "" : " DIFFERENT TOTAL") << std::endl;
+  }
+}
+
+
+int main() {
+  try {
+    int sparse_nodes = ics::prompt_int("Enter number of nodes (sparse graph)",200000);
+    int sparse_edges = ics::prompt_int("Enter number of edges (sparse graph)",2000000);
+    int dense_nodes  = ics::prompt_int("Enter number of nodes (dense graph)",2000);
+    int dense_edges  = ics::prompt_int("Enter number of edges (dense graph)",2000000);
+    int hash_edges   = ics::prompt_int("Enter number of edges for HashGraph (0 to skip)",100000);
+
+    std::default_random_engine generator;
+    compare("Sparse random graph", random_edges(sparse_nodes, sparse_edges, generator));
+    compare("Dense random graph",  random_edges(dense_nodes, dense_edges, generator));
+
+    if (hash_edges > 0) {
+      ics::EdgeList edges = random_edges(hash_edges/10, hash_edges, generator);
+      ics::HashGraph<int> g;
+      for (int i=0; i<edges.edge_count(); ++i)
+        g.add_edge(edges.names[edges.origins[i]], edges.names[edges.destinations[i]], edges.values[i]);
+      ics::Stopwatch watch;
+      watch.start();
+      ics::EdgeList extracted = ics::graph_edges(g);
+      watch.stop();
+      std::cout << "graph_edges(HashGraph): time = " << watch.read() << std::endl;
+      compare("HashGraph", extracted);
+    }
+  } catch (ics::IcsError& e) {
+    std::cout << "  " << e.what() << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,64 @@
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <random>
+#include "ics46goody.hpp"
+#include "stopwatch.hpp"
+#include "hash_graph.hpp"
+#include "csr_graph.hpp"
+#include "dijkstra.hpp"
+#include "multi_source_dijkstra.hpp"
+
+
+//Time the all-pairs cost matrix of a random flight-like graph (each city has
+//  flights to a few random others) using 1, 2, 4, ... threads, up to twice the
+//  hardware threads, and check that every run computes the same matrix.
+//Compile with -pthread.
+
+std::string node_name(int i) {
+  std::ostringstream name;
+  name << "city" << i;
+  return name.str();
+}
+
+
+int main() {
+  try {
+    int nodes     = ics::prompt_int("Enter number of cities",2000);
+    int edges_per = ics::prompt_int("Enter flights per city",8);
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<int> node_distribution(0,nodes-1);
+    std::uniform_int_distribution<int> cost_distribution(50,500);
+    ics::DistGraph g;
+    for (int i=0; i<nodes; ++i) {
+      g.add_node(node_name(i));
+      for (int j=0; j<edges_per; ++j)
+        g.add_edge(node_name(i), node_name(node_distribution(generator)), cost_distribution(generator));
+    }
+    ics::CSRGraph<int> csr = g.freeze();
+    std::cout << nodes << " cities, " << csr.edge_count() << " flights, "
+              << ics::thread_count(0) << " hardware threads" << std::endl;
+
+    ics::Stopwatch watch;
+    double one_thread = 0;
+    ics::CostMatrix first;
+    for (int threads=1; threads<=2*ics::thread_count(0); threads*=2) {
+      watch.reset();
+      watch.start();
+      ics::CostMatrix costs = ics::all_pairs_costs(csr, threads);
+      watch.stop();
+      if (threads == 1) {
+        one_thread = watch.read();
+        first = costs;
+      }
+      std::cout << "  " << threads << " thread(s): time = " << watch.read() << ", speedup = " << one_thread/watch.read()
+                << (costs == first ? "" : " (DIFFERENT MATRIX)") << std::endl;
+    }
+  } catch (ics::IcsError& e) {
+    std::cout << "  " << e.what() << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,386 @@
+#ifndef GRAPH_LOADER_HPP_
+#define GRAPH_LOADER_HPP_
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include "ics_exceptions.hpp"
+#include "csr_graph.hpp"
+#include "parallel_for.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define ICS_GRAPH_LOADER_MMAP
+#endif
+
+
+namespace ics {
+
+
+//Fast loading of large graphs into a CSRGraph<int>, in two forms:
+//  - load_graph_file reads the text format of HashGraph::load/store (a node
+//    name per line, or origin;destination;value per line). The file is
+//    memory-mapped (read into one buffer where mmap is unavailable) and cut
+//    at line ends into chunks that threads parse in parallel. Names are
+//    (pointer,length) views into the file, never copied strings: each chunk
+//    interns its own names into ids, then the chunks' names are merged into
+//    one table and each chunk renumbers its edges. Only the final table of
+//    distinct names is copied into strings.
+//  - store_binary/load_binary write and read a binary file: a header, a
+//    string table, and the packed CSR offset/target/value arrays, with no
+//    parsing or hashing of edges. Its ints are in the byte order of the
+//    machine that wrote it; open the streams with std::ios::binary.
+//threads = 0 uses one per hardware thread; compile with -pthread.
+
+
+//A node name inside the file's bytes
+struct NameView {
+    const char* begin;
+    int         length;
+    unsigned    hash;
+};
+
+
+unsigned hash_name(const char* begin, int length) {
+      unsigned h = 2166136261u;                  //FNV-1a
+      for (int i = 0; i < length; ++i)
+          h = (h ^ (unsigned char)begin[i]) * 16777619u;
+      return h;
+}
+
+
+//Open-addressing table interning NameViews as ids 0, 1, 2, ...; slots keep
+//  each name's hash, so most mismatches are rejected without touching it
+class NameTable {
+  public:
+    NameTable() : slots(16, Slot{0, -1}) {}
+
+    int intern(const NameView& n) {
+      if (2*(names.size()+1) > slots.size())
+          grow();
+      for (unsigned s = n.hash & (slots.size()-1);; s = (s+1) & (slots.size()-1)) {
+          if (slots[s].id == -1) {
+              slots[s] = Slot{n.hash, int(names.size())};
+              names.push_back(n);
+              return slots[s].id;
+          }
+          if (slots[s].hash == n.hash) {
+              const NameView& m = names[slots[s].id];
+              if (m.length == n.length && std::memcmp(m.begin, n.begin, n.length) == 0)
+                  return slots[s].id;
+          }
+      }
+    }
+
+    std::vector<NameView> names;
+
+  private:
+    struct Slot {
+      unsigned hash;
+      int      id;                               //-1 if empty
+    };
+    std::vector<Slot> slots;                     //Size is a power of 2
+
+    void grow() {
+      slots.assign(2*slots.size(), Slot{0, -1});
+      for (int id = 0; id < int(names.size()); ++id) {
+          unsigned s = names[id].hash & (slots.size()-1);
+          while (slots[s].id != -1)
+              s = (s+1) & (slots.size()-1);
+          slots[s] = Slot{names[id].hash, id};
+      }
+    }
+};
+
+
+//The bytes of a file, memory-mapped when possible
+class MappedFile {
+  public:
+    explicit MappedFile(const std::string& file_name) {
+#ifdef ICS_GRAPH_LOADER_MMAP
+      int fd = ::open(file_name.c_str(), O_RDONLY);
+      struct stat info;
+      if (fd == -1 || ::fstat(fd, &info) == -1) {
+          if (fd != -1)
+              ::close(fd);
+          throw GraphError("GraphError::load_graph_file: cannot open file(" + file_name + ")");
+      }
+      length = info.st_size;
+      if (length > 0) {
+          void* p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+          ::close(fd);
+          if (p == MAP_FAILED)
+              throw GraphError("GraphError::load_graph_file: cannot map file(" + file_name + ")");
+          ::madvise(p, length, MADV_SEQUENTIAL);
+          bytes = static_cast<const char*>(p);
+      } else
+          ::close(fd);
+#else
+      std::ifstream in_file(file_name, std::ios::binary);
+      if (!in_file)
+          throw GraphError("GraphError::load_graph_file: cannot open file(" + file_name + ")");
+      std::ostringstream contents;
+      contents << in_file.rdbuf();
+      buffer = contents.str();
+      bytes  = buffer.data();
+      length = buffer.size();
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef ICS_GRAPH_LOADER_MMAP
+      if (length > 0)
+          ::munmap(const_cast<char*>(bytes), length);
+#endif
+    }
+
+    MappedFile(const MappedFile& f)              = delete;
+    MappedFile& operator = (const MappedFile& f) = delete;
+
+    const char* data() const {return bytes;}
+    size_t      size() const {return length;}
+
+  private:
+    const char* bytes  = nullptr;
+    size_t      length = 0;
+#ifndef ICS_GRAPH_LOADER_MMAP
+    std::string buffer;
+#endif
+};
+
+
+//What one thread parses from one chunk of lines: node ids are local to the chunk
+class ParsedChunk {
+  public:
+    NameTable        names;
+    std::vector<int> origins, destinations, values;
+    std::vector<int> global_id;              //global_id[local id], filled in when merging
+
+    //Parse the lines in [begin,end); end is at a line end or the file's end
+    void parse(const char* begin, const char* end, const std::string& separator) {
+      for (const char* line = begin; line < end;) {
+          const char* line_end = static_cast<const char*>(std::memchr(line, '\n', end - line));
+          if (line_end == nullptr)
+              line_end = end;
+          const char* content_end = line_end;
+          if (content_end > line && content_end[-1] == '\r')
+              --content_end;
+          if (content_end > line)
+              parse_line(line, content_end, separator);
+          line = line_end + 1;
+      }
+    }
+
+  private:
+    NameView view(const char* begin, const char* end) {
+      return NameView{begin, int(end - begin), hash_name(begin, end - begin)};
+    }
+
+    const char* find_separator(const char* begin, const char* end, const std::string& separator) {
+      if (separator.size() == 1) {
+          const char* s = static_cast<const char*>(std::memchr(begin, separator[0], end - begin));
+          return s == nullptr ? end : s;
+      }
+      return std::search(begin, end, separator.begin(), separator.end());
+    }
+
+    void parse_line(const char* begin, const char* end, const std::string& separator) {
+      const char* first = find_separator(begin, end, separator);
+      if (first == end) {
+          names.intern(view(begin, end));
+          return;
+      }
+      const char* second = find_separator(first + separator.size(), end, separator);
+      if (second == end)
+          bad_line(begin, end, "expected origin;destination;value");
+      const char* digits = second + separator.size();
+      const char* digits_end = find_separator(digits, end, separator);
+
+      long long value = 0;
+      bool negative = (digits < digits_end && *digits == '-');
+      const char* d = digits + (negative || (digits < digits_end && *digits == '+'));
+      if (d == digits_end)
+          bad_line(begin, end, "missing value");
+      for (; d < digits_end; ++d) {
+          if (*d < '0' || *d > '9' || value > 2147483648LL)
+              bad_line(begin, end, "bad value");
+          value = 10*value + (*d - '0');
+      }
+      if (negative)
+          value = -value;
+      if (value > 2147483647LL || value < -2147483648LL)
+          bad_line(begin, end, "bad value");
+
+      origins.push_back(names.intern(view(begin, first)));
+      destinations.push_back(names.intern(view(first + separator.size(), second)));
+      values.push_back(int(value));
+    }
+
+    void bad_line(const char* begin, const char* end, const std::string& problem) {
+      std::ostringstream answer;
+      answer << "GraphError::load_graph_file: " << problem << " in line(" << std::string(begin, end) << ")";
+      throw GraphError(answer.str());
+    }
+};
+
+
+CSRGraph<int> load_graph_file(const std::string& file_name, std::string separator = ";", int threads = 0) {
+       MappedFile file(file_name);
+       const char* bytes = file.data();
+       size_t      size  = file.size();
+
+       //Cut into chunks of at least 1MB, each ending at a line end
+       threads = thread_count(threads);
+       size_t target = std::max<size_t>(size/(4*threads) + 1, 1 << 20);
+       std::vector<size_t> cuts(1, 0);
+       while (cuts.back() < size) {
+           size_t cut = std::min(size, cuts.back() + target);
+           const char* newline = (cut == size ? nullptr : static_cast<const char*>(std::memchr(bytes + cut, '\n', size - cut)));
+           cuts.push_back(newline == nullptr ? size : newline - bytes + 1);
+       }
+       int chunk_count = cuts.size() - 1;
+
+       std::vector<ParsedChunk> chunks(chunk_count);
+       parallel_for(chunk_count, threads, [&] (int c, int) {
+         chunks[c].parse(bytes + cuts[c], bytes + cuts[c+1], separator);
+       });
+
+       //Merge the chunk name tables in file order, so node ids follow first appearance
+       NameTable all;
+       for (ParsedChunk& c : chunks) {
+           c.global_id.resize(c.names.names.size());
+           for (int id = 0; id < int(c.names.names.size()); ++id)
+               c.global_id[id] = all.intern(c.names.names[id]);
+       }
+
+       std::vector<size_t> first_edge(chunk_count + 1, 0);
+       for (int c = 0; c < chunk_count; ++c)
+           first_edge[c+1] = first_edge[c] + chunks[c].origins.size();
+       std::vector<int> origins(first_edge.back()), destinations(first_edge.back()), values(first_edge.back());
+       std::vector<std::string> node_names(all.names.size());
+       parallel_for(chunk_count, threads, [&] (int c, int) {
+         const ParsedChunk& chunk = chunks[c];
+         for (size_t i = 0; i < chunk.origins.size(); ++i) {
+             origins[first_edge[c] + i]      = chunk.global_id[chunk.origins[i]];
+             destinations[first_edge[c] + i] = chunk.global_id[chunk.destinations[i]];
+             values[first_edge[c] + i]       = chunk.values[i];
+         }
+         for (size_t id = c; id < node_names.size(); id += chunk_count)
+             node_names[id].assign(all.names[id].begin, all.names[id].length);
+       });
+
+       return CSRGraph<int>(node_names, origins, destinations, values);
+}
+
+
+//Binary file layout (all ints are 32 bits):
+//  "ICSCSR1\n", node count, edge count
+//  node count name lengths, then all the names' bytes
+//  node count+1 out-edge offsets, edge count targets, edge count values
+void store_binary(const CSRGraph<int>& g, std::ofstream& out_file) {
+       auto write_ints = [&out_file] (const std::vector<int32_t>& ints) {
+         out_file.write(reinterpret_cast<const char*>(ints.data()), ints.size()*sizeof(int32_t));
+       };
+
+       out_file.write("ICSCSR1\n", 8);
+       write_ints(std::vector<int32_t>{g.node_count(), g.edge_count()});
+       std::vector<int32_t> lengths;
+       for (int id = 0; id < g.node_count(); ++id)
+           lengths.push_back(g.node_name(id).size());
+       write_ints(lengths);
+       for (int id = 0; id < g.node_count(); ++id)
+           out_file.write(g.node_name(id).data(), g.node_name(id).size());
+
+       std::vector<int32_t> offsets, targets, values;
+       for (int id = 0; id <= g.node_count(); ++id)
+           offsets.push_back(id == g.node_count() ? g.edge_count() : g.out_begin(id));
+       for (int e = 0; e < g.edge_count(); ++e) {
+           targets.push_back(g.target(e));
+           values.push_back(g.value(e));
+       }
+       write_ints(offsets);
+       write_ints(targets);
+       write_ints(values);
+}
+
+
+//Every count and length is checked against the bytes left in the file
+//  before anything is allocated for it, so a corrupt file throws GraphError
+//  (never length_error or bad_alloc)
+CSRGraph<int> load_binary(std::ifstream& in_file) {
+       std::streampos start = in_file.tellg();
+       in_file.seekg(0, std::ios::end);
+       long long remaining = in_file.tellg() - start;
+       in_file.seekg(start);
+       if (!in_file || start == std::streampos(-1) || remaining < 0)
+           throw GraphError("GraphError::load_binary: cannot find file size");
+
+       auto read_bytes = [&in_file, &remaining] (char* bytes, long long count) {
+         if (count > remaining || !in_file.read(bytes, count))
+           throw GraphError("GraphError::load_binary: file is truncated");
+         remaining -= count;
+       };
+       auto read_ints = [&read_bytes, &remaining] (std::vector<int32_t>& ints, long long count) {
+         if (count*(long long)sizeof(int32_t) > remaining)
+           throw GraphError("GraphError::load_binary: file is truncated");
+         ints.resize(count);
+         read_bytes(reinterpret_cast<char*>(ints.data()), count*sizeof(int32_t));
+       };
+
+       char magic[8];
+       if (remaining < 8 || !in_file.read(magic, 8) || std::memcmp(magic, "ICSCSR1\n", 8) != 0)
+           throw GraphError("GraphError::load_binary: not a binary graph file");
+       remaining -= 8;
+       std::vector<int32_t> counts, lengths, offsets, targets, values;
+       read_ints(counts, 2);
+       long long nodes = counts[0], edges = counts[1];
+       //Lengths, offsets, targets, and values take 4*nodes + 4*(nodes+1) + 8*edges bytes
+       if (nodes < 0 || edges < 0 || 8*nodes + 4 + 8*edges > remaining)
+           throw GraphError("GraphError::load_binary: bad node or edge count");
+
+       read_ints(lengths, nodes);
+       long long name_bytes = 0;
+       for (int32_t length : lengths) {
+           if (length < 0)
+               throw GraphError("GraphError::load_binary: bad name length");
+           name_bytes += length;
+       }
+       if (name_bytes > remaining - (4*(nodes + 1) + 8*edges))
+           throw GraphError("GraphError::load_binary: file is truncated");
+       std::vector<std::string> node_names(nodes);
+       for (int id = 0; id < nodes; ++id) {
+           node_names[id].resize(lengths[id]);
+           read_bytes(&node_names[id][0], lengths[id]);
+       }
+
+       read_ints(offsets, nodes + 1);
+       read_ints(targets, edges);
+       read_ints(values, edges);
+       if (offsets[0] != 0 || offsets[nodes] != edges)
+           throw GraphError("GraphError::load_binary: bad edge offsets");
+       std::vector<int> origins(edges);
+       for (int id = 0; id < nodes; ++id) {
+           if (offsets[id] < 0 || offsets[id] > offsets[id+1] || offsets[id+1] > edges)
+               throw GraphError("GraphError::load_binary: bad edge offsets");
+           for (int e = offsets[id]; e < offsets[id+1]; ++e)
+               origins[e] = id;
+       }
+       for (int t : targets)
+           if (t < 0 || t >= nodes)
+               throw GraphError("GraphError::load_binary: bad edge target");
+       return CSRGraph<int>(node_names, origins, std::vector<int>(targets.begin(), targets.end()),
+                            std::vector<int>(values.begin(), values.end()));
+}
+
+
+}
+
+#endif /* GRAPH_LOADER_HPP_ */
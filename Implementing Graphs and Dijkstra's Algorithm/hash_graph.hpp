@@ -13,6 +13,7 @@
 #include "heap_priority_queue.hpp"
 #include "hash_set.hpp"
 #include "hash_map.hpp"
+#include "csr_graph.hpp"
 
 
 namespace ics {
@@ -55,6 +56,22 @@ namespace ics {
     typedef HashSet<Edge, hash_pair_str>            EdgeSet;
 
 
+    //An Observer subscribed to a graph is told about each change to it, after
+    //  the change is made (so it can query the graph's new state). remove_node
+    //  reports removing each of the node's edges before removing the node;
+    //  clear and = report only graph_reset. Override just the ones needed.
+    class Observer {
+      public:
+        virtual ~Observer() {}
+        virtual void node_added  (const NodeName& /*node_name*/) {}
+        virtual void node_removed(const NodeName& /*node_name*/) {}
+        virtual void edge_added  (const NodeName& /*origin*/, const NodeName& /*destination*/, const T& /*value*/) {}
+        virtual void edge_changed(const NodeName& /*origin*/, const NodeName& /*destination*/, const T& /*old_value*/, const T& /*value*/) {}
+        virtual void edge_removed(const NodeName& /*origin*/, const NodeName& /*destination*/, const T& /*old_value*/) {}
+        virtual void graph_reset () {}
+    };
+
+
     //Destructor/Constructors
     ~HashGraph();
     HashGraph();
@@ -78,7 +95,12 @@ namespace ics {
     const EdgeSet& out_edges(NodeName node_name) const;
     const EdgeSet& in_edges (NodeName node_name) const;
 
+    //Immutable snapshot with int node ids and contiguous edge arrays (see csr_graph.hpp)
+    CSRGraph<T> freeze() const;
+
     //Commands
+    void subscribe  (Observer* o);                 //Copies of a graph start with no observers
+    void unsubscribe(Observer* o);
     void add_node   (NodeName node_name);
     void add_edge   (NodeName origin, NodeName destination, T value);
     void remove_node(NodeName node_name);
@@ -143,9 +165,10 @@ namespace ics {
       return outs;
     }
 
-    //HashGraph<T> class two instance variables
+    //HashGraph<T> class instance variables
     NodeMap node_values;
     EdgeMap edge_values;
+    std::vector<Observer*> observers;
   };
 
 
@@ -351,10 +374,35 @@ auto HashGraph<T>::in_edges(NodeName node_name) const -> const EdgeSet& {
 }
 
 
+//Returns a CSRGraph holding the same nodes and edges; later changes to this
+//  graph do not affect it
+template<class T>
+CSRGraph<T> HashGraph<T>::freeze() const {
+      return CSRGraph<T>(*this);
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Commands
 
+//Observers are not owned: unsubscribe one before destroying it
+template<class T>
+void HashGraph<T>::subscribe (Observer* o) {
+      observers.push_back(o);
+}
+
+
+template<class T>
+void HashGraph<T>::unsubscribe (Observer* o) {
+      for (int i = 0; i < int(observers.size()); ++i)
+          if (observers[i] == o) {
+              observers.erase(observers.begin() + i);
+              return;
+          }
+}
+
+
 //Add node_name to the graph if it is not already there.
 //Ensure that its associated LocalInfo has a from_graph refers to this graph.
 template<class T>
@@ -364,6 +412,8 @@ void HashGraph<T>::add_node (NodeName node_name) {
       } else {
           node_values[node_name].connect(this);
 //          LocalInfo(node_values);
+          for (Observer* o : observers)
+              o->node_added(node_name);
       }
 }
 
@@ -375,11 +425,18 @@ void HashGraph<T>::add_edge (NodeName origin, NodeName destination, T value) {
       add_node(origin);
       add_node(destination);
       auto pair = Edge(origin, destination);
+      bool existed = edge_values.has_key(pair);
+      T old_value  = (existed ? edge_values[pair] : value);
       edge_values[pair] = value;
       node_values[origin].out_nodes.insert(destination);
       node_values[destination].in_nodes.insert(origin);
       node_values[origin].out_edges.insert(pair);
       node_values[destination].in_edges.insert(pair);
+      for (Observer* o : observers)
+          if (existed)
+              o->edge_changed(origin, destination, old_value, value);
+          else
+              o->edge_added(origin, destination, value);
 }
 
 
@@ -388,28 +445,22 @@ void HashGraph<T>::add_edge (NodeName origin, NodeName destination, T value) {
 //If the node_name is not in the graph, do nothing
 //Hint: you cannot iterate over a sets that you are changing:, so you might have
 // to copy a set and then iterate over it while removing values from the original set
+//Each edge goes through remove_edge, so observers see one change at a time
 template<class T>
 void HashGraph<T>::remove_node (NodeName node_name){
       if (has_node(node_name)) {
 
-          auto &copyLocalInfo = node_values[node_name];
-          auto &incoming = copyLocalInfo.in_nodes;
-          auto &outgoing = copyLocalInfo.out_nodes;
+          NodeSet incoming = node_values[node_name].in_nodes;
+          NodeSet outgoing = node_values[node_name].out_nodes;
 
-          for (NodeName i : incoming) {
-              auto pair = Edge(i, node_name);
-              edge_values.erase(pair);
-              node_values[i].out_nodes.erase(node_name);
-              node_values[i].out_edges.erase(pair);
-          }
-          for (NodeName o : outgoing) {
-              auto pair = Edge(node_name, o);
-              edge_values.erase(pair);
-              node_values[o].in_nodes.erase(node_name);
-              node_values[o].in_edges.erase(pair);
-          }
+          for (NodeName i : incoming)
+              remove_edge(i, node_name);
+          for (NodeName o : outgoing)
+              remove_edge(node_name, o);
 
          node_values.erase(node_name);
+         for (Observer* o : observers)
+             o->node_removed(node_name);
 
       } else {
           return;
@@ -433,7 +484,9 @@ void HashGraph<T>::remove_edge (NodeName origin, NodeName destination) {
           incoming.in_edges.erase(pair);
           outgoing.out_nodes.erase(destination);
           outgoing.out_edges.erase(pair);
-          edge_values.erase(pair);
+          T old_value = edge_values.erase(pair);
+          for (Observer* o : observers)
+              o->edge_removed(origin, destination, old_value);
       } else {
           return;
       }
@@ -445,6 +498,8 @@ template<class T>
 void HashGraph<T>::clear() {
       node_values.clear();
       edge_values.clear();
+      for (Observer* o : observers)
+          o->graph_reset();
 }
 
 
@@ -505,6 +560,9 @@ HashGraph<T>& HashGraph<T>::operator = (const HashGraph<T>& rhs){
        for (auto i : node_values) {
           i.second.connect(this);
        }
+       for (Observer* o : observers)
+          o->graph_reset();
+       return *this;
 }
 
 
@@ -591,7 +591,7 @@ void HashMap<KEY,T,thash>::ensure_load_threshold(int new_used) {
                 p = p->next;
             }
         }
-        delete new_map;
+        delete_hash_table(new_map, b);
     }
     else return;
 }
@@ -601,12 +601,12 @@ template<class KEY,class T, int (*thash)(const KEY& a)>
 void HashMap<KEY,T,thash>::delete_hash_table (LN**& ht, int bins) {
     for (int i = 0; i < bins; i++) {
         LN* head = ht[i];
-        while (head->next) {
+        while (head != nullptr) {
             auto del = head;
             head = head->next;
-            delete head;
+            delete del;
         }
-    } delete ht;
+    } delete[] ht;
 }
 
 
@@ -643,7 +643,7 @@ void HashSet<T,thash>::ensure_load_threshold(int new_used) {
                 p = p->next;
             }
         }
-        delete new_set;
+        delete_hash_table(new_set, b);
     }
     else return;
 }
@@ -653,12 +653,12 @@ template<class T, int (*thash)(const T& a)>
 void HashSet<T,thash>::delete_hash_table (LN**& ht, int bins) {
     for (int i = 0; i < bins; i++) {
         LN* head = ht[i];
-        while (head->next) {
+        while (head != nullptr) {
             auto del = head;
             head = head->next;
-            delete head;
+            delete del;
         }
-    } delete ht;
+    } delete[] ht;
 }
 
 
@@ -0,0 +1,315 @@
+#ifndef MINIMUM_SPANNING_FOREST_HPP_
+#define MINIMUM_SPANNING_FOREST_HPP_
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <random>
+#include "ics_exceptions.hpp"
+#include "hash_map.hpp"
+#include "hash_graph.hpp"
+#include "csr_graph.hpp"
+#include "disjoint_sets.hpp"
+
+
+namespace ics {
+
+
+//An EdgeList holds the edges of a graph with int values in flat arrays: edge
+//  i joins nodes origins[i] and destinations[i] (indexes into names) with
+//  value values[i]. graph_edges extracts one from a HashGraph<int> (interning
+//  node names in the order all_nodes iterates over them) or a CSRGraph<int>.
+struct EdgeList {
+  std::vector<std::string> names;
+  std::vector<int>         origins;
+  std::vector<int>         destinations;
+  std::vector<int>         values;
+
+  int  node_count () const {return names.size();}
+  int  edge_count () const {return values.size();}
+  void add_edge   (int origin, int destination, int value) {
+    origins.push_back(origin);
+    destinations.push_back(destination);
+    values.push_back(value);
+  }
+};
+
+
+EdgeList graph_edges(const HashGraph<int>& g) {
+      EdgeList answer;
+      HashMap<std::string, int, HashGraph<int>::hash_str> ids(g.node_count() + 1);
+      for (const HashGraph<int>::NodeMapEntry& n : g.all_nodes()) {
+        ids[n.first] = answer.names.size();
+        answer.names.push_back(n.first);
+      }
+      answer.origins.reserve(g.edge_count());
+      answer.destinations.reserve(g.edge_count());
+      answer.values.reserve(g.edge_count());
+      for (const HashGraph<int>::EdgeMapEntry& e : g.all_edges())
+        answer.add_edge(ids[e.first.first], ids[e.first.second], e.second);
+      return answer;
+}
+
+
+EdgeList graph_edges(const CSRGraph<int>& g) {
+      EdgeList answer;
+      for (int id = 0; id < g.node_count(); ++id)
+        answer.names.push_back(g.node_name(id));
+      for (int id = 0; id < g.node_count(); ++id)
+        for (int e = g.out_begin(id); e < g.out_end(id); ++e)
+          answer.add_edge(id, g.target(e), g.value(e));
+      return answer;
+}
+
+
+
+
+//A MinimumSpanningForest finds, by Kruskal's algorithm, a set of edges of
+//  least total value that connects every pair of nodes connected in the
+//  graph (the direction of each edge is ignored: an undirected HashGraph, with
+//  each edge stored both ways, gives the same forest as storing it one way).
+//The edges are copied into one array of small structs and sorted by value
+//  (method sort: std::sort; method radix: an LSD radix sort on the bytes of the
+//  value, skipping bytes that are equal in every edge); then each edge in turn
+//  is accepted if its ends are still in different trees, which DisjointSets
+//  over the node ids decides in near constant time.
+//Method filter (Filter-Kruskal) avoids sorting edges that cannot be in the
+//  forest, which helps on dense graphs: a large range of edges is partitioned
+//  around a random pivot value; the light part is solved first, then the heavy
+//  part is filtered (edges whose ends are already in the same tree are dropped)
+//  before it is solved; small ranges are radix sorted and scanned.
+//Scanning stops as soon as the forest has node_count()-1 edges (a tree).
+class MinimumSpanningForest {
+  public:
+    enum Method {sort, radix, filter};
+
+    //Destructor/Constructors
+    ~MinimumSpanningForest();
+    explicit MinimumSpanningForest(const EdgeList& edges, Method method = radix);
+    explicit MinimumSpanningForest(const HashGraph<int>& g, Method method = radix);
+
+    //Queries
+    int                     component_count () const;    //Trees in the forest (isolated nodes count)
+    long long               total_value     () const;
+    int                     filtered_count  () const;    //Edges dropped unsorted by filter
+    const std::vector<int>& forest_edges    () const;    //Indexes into the EdgeList, by increasing value
+    EdgeList                edge_list       () const;
+    HashGraph<int>          graph           (bool both_directions = true) const;
+
+  private:
+    struct Edge {
+      int value;
+      int origin;
+      int destination;
+      int index;       //Position in the EdgeList
+    };
+
+    enum {filter_base_size = 1 << 12};   //Ranges this small are sorted and scanned by filter
+
+    EdgeList          edges;
+    std::vector<int>  forest;
+    DisjointSets      trees;
+    std::vector<Edge> buffer;            //Radix sort workspace
+    int               filtered = 0;
+    std::default_random_engine generator;
+
+    //Helper methods
+    void compute    (Method method);
+    bool complete   () const {return int(forest.size()) >= edges.node_count() - 1;}
+    void radix_sort (Edge* begin, Edge* end);
+    void scan       (Edge* begin, Edge* end);
+    void filter_kruskal(Edge* begin, Edge* end);
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//MinimumSpanningForest: Destructor/Constructors
+
+MinimumSpanningForest::~MinimumSpanningForest()
+{}
+
+
+MinimumSpanningForest::MinimumSpanningForest(const EdgeList& edges, Method method)
+: edges(edges) {
+      compute(method);
+}
+
+
+MinimumSpanningForest::MinimumSpanningForest(const HashGraph<int>& g, Method method)
+: edges(graph_edges(g)) {
+      compute(method);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//MinimumSpanningForest: Queries
+
+int MinimumSpanningForest::component_count() const {
+      return edges.node_count() - forest.size();
+}
+
+
+long long MinimumSpanningForest::total_value() const {
+      long long answer = 0;
+      for (int e : forest)
+        answer += edges.values[e];
+      return answer;
+}
+
+
+int MinimumSpanningForest::filtered_count() const {
+      return filtered;
+}
+
+
+const std::vector<int>& MinimumSpanningForest::forest_edges() const {
+      return forest;
+}
+
+
+EdgeList MinimumSpanningForest::edge_list() const {
+      EdgeList answer;
+      answer.names = edges.names;
+      for (int e : forest)
+        answer.add_edge(edges.origins[e], edges.destinations[e], edges.values[e]);
+      return answer;
+}
+
+
+//Every node (even an isolated one) is in the answer; with both_directions each
+//  forest edge is added both ways, as in an undirected HashGraph
+HashGraph<int> MinimumSpanningForest::graph(bool both_directions) const {
+      HashGraph<int> answer;
+      for (const std::string& n : edges.names)
+        answer.add_node(n);
+      for (int e : forest) {
+        const std::string& origin      = edges.names[edges.origins[e]];
+        const std::string& destination = edges.names[edges.destinations[e]];
+        answer.add_edge(origin, destination, edges.values[e]);
+        if (both_directions)
+          answer.add_edge(destination, origin, edges.values[e]);
+      }
+      return answer;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//MinimumSpanningForest: Helper methods
+
+void MinimumSpanningForest::compute(Method method) {
+      int n = edges.node_count(), m = edges.edge_count();
+      if (int(edges.origins.size()) != m || int(edges.destinations.size()) != m)
+        throw GraphError("GraphError::MinimumSpanningForest: origins/destinations/values differ in size");
+      trees.reset(n);
+
+      std::vector<Edge> work(m);
+      for (int i = 0; i < m; ++i) {
+        if (edges.origins[i] < 0 || edges.origins[i] >= n || edges.destinations[i] < 0 || edges.destinations[i] >= n) {
+          std::ostringstream answer;
+          answer << "GraphError::MinimumSpanningForest: edge " << i << " joins a node not in the EdgeList";
+          throw GraphError(answer.str());
+        }
+        work[i] = Edge{edges.values[i], edges.origins[i], edges.destinations[i], i};
+      }
+
+      Edge* begin = work.data();
+      Edge* end   = work.data() + m;
+      if (method == sort) {
+        std::sort(begin, end, [] (const Edge& a, const Edge& b) {return a.value < b.value;});
+        scan(begin, end);
+      } else if (method == radix) {
+        radix_sort(begin, end);
+        scan(begin, end);
+      } else
+        filter_kruskal(begin, end);
+      std::vector<Edge>().swap(buffer);
+}
+
+
+//LSD radix sort on the 4 bytes of value (sign bit flipped, so negative values
+//  sort first), moving edges between the range and buffer; a byte that is the
+//  same in every edge needs no pass
+void MinimumSpanningForest::radix_sort(Edge* begin, Edge* end) {
+      int m = end - begin;
+      if (m < 2)
+        return;
+      if (int(buffer.size()) < m)
+        buffer.resize(m);
+
+      int counts[4][257] = {};
+      for (Edge* e = begin; e != end; ++e) {
+        unsigned key = unsigned(e->value) ^ 0x80000000u;
+        for (int b = 0; b < 4; ++b)
+          ++counts[b][((key >> (8*b)) & 0xFF) + 1];
+      }
+
+      Edge* from = begin;
+      Edge* to   = buffer.data();
+      for (int b = 0; b < 4; ++b) {
+        int* count = counts[b];
+        if (*std::max_element(count + 1, count + 257) == m)
+          continue;
+        for (int d = 0; d < 256; ++d)
+          count[d+1] += count[d];
+        for (Edge* e = from; e != from + m; ++e)
+          to[count[((unsigned(e->value) ^ 0x80000000u) >> (8*b)) & 0xFF]++] = *e;
+        std::swap(from, to);
+      }
+      if (from != begin)
+        std::copy(from, from + m, begin);
+}
+
+
+//Accept, in order, each edge joining two different trees
+void MinimumSpanningForest::scan(Edge* begin, Edge* end) {
+      for (Edge* e = begin; e != end && !complete(); ++e)
+        if (trees.unite(e->origin, e->destination))
+          forest.push_back(e->index);
+}
+
+
+//Solve the edges with values <= a random pivot, then those (still joining two
+//  different trees) above it. If no value is above the pivot (it is the
+//  range's maximum), split instead into values < pivot and values == pivot;
+//  if no value is below it either, all values are equal, so just scan
+void MinimumSpanningForest::filter_kruskal(Edge* begin, Edge* end) {
+      if (complete() || begin == end)
+        return;
+      if (end - begin <= filter_base_size) {
+        radix_sort(begin, end);
+        scan(begin, end);
+        return;
+      }
+
+      std::uniform_int_distribution<int> position(0, end - begin - 1);
+      int pivot = begin[position(generator)].value;
+      Edge* middle = std::partition(begin, end, [pivot] (const Edge& e) {return e.value <= pivot;});
+      if (middle == end) {
+        middle = std::partition(begin, end, [pivot] (const Edge& e) {return e.value < pivot;});
+        if (middle == begin) {
+          scan(begin, end);
+          return;
+        }
+      }
+
+      filter_kruskal(begin, middle);
+      if (complete())
+        return;
+      Edge* kept = std::remove_if(middle, end, [this] (const Edge& e) {
+        return trees.find(e.origin) == trees.find(e.destination);
+      });
+      filtered += end - kept;
+      filter_kruskal(middle, kept);
+}
+
+
+}
+
+#endif /* MINIMUM_SPANNING_FOREST_HPP_ */
@@ -0,0 +1,72 @@
+#ifndef MULTI_SOURCE_DIJKSTRA_HPP_
+#define MULTI_SOURCE_DIJKSTRA_HPP_
+
+#include <string>
+#include <vector>
+#include "csr_graph.hpp"
+#include "dijkstra.hpp"
+#include "parallel_for.hpp"
+
+
+namespace ics {
+
+
+//Independent Dijkstra searches from many start nodes, run in parallel over one
+//  shared CSRGraph: the graph is only read, and each thread owns a
+//  DijkstraWorkspace, so the threads share nothing they write except their
+//  own rows of the answer. threads = 0 means one per hardware thread.
+
+//row[i][v] is the cost from start_nodes[i] to node id v (max int if there is
+//  no path); node ids are those of g
+typedef std::vector<std::vector<int>> CostMatrix;
+
+
+//Check every start node before starting threads, so a bad name throws here
+std::vector<int> start_ids(const CSRGraph<int> &g, const std::vector<std::string> &start_nodes) {
+       std::vector<int> ids;
+       for (const std::string& s : start_nodes)
+          ids.push_back(g.node_id(s));
+       return ids;
+}
+
+
+CostMatrix cost_matrix(const CSRGraph<int> &g, const std::vector<std::string> &start_nodes, int threads = 0) {
+       std::vector<int> ids = start_ids(g, start_nodes);
+       CostMatrix answer(ids.size());
+       std::vector<DijkstraWorkspace> workspace(std::min<int>(thread_count(threads), ids.size()));
+       parallel_for(ids.size(), workspace.size(), [&] (int i, int thread) {
+          DijkstraWorkspace& w = workspace[thread];
+          csr_dijkstra(g, ids[i], w);
+          answer[i] = w.cost;
+       });
+       return answer;
+}
+
+
+//Costs between all pairs of nodes: row and column indexes are node ids of g
+CostMatrix all_pairs_costs(const CSRGraph<int> &g, int threads = 0) {
+       std::vector<std::string> start_nodes;
+       for (int v = 0; v < g.node_count(); ++v)
+          start_nodes.push_back(g.node_name(v));
+       return cost_matrix(g, start_nodes, threads);
+}
+
+
+//answer[i] is extended_dijkstra(g, start_nodes[i])
+std::vector<CostMap> multi_source_dijkstra(const CSRGraph<int> &g, const std::vector<std::string> &start_nodes,
+                                           int threads = 0) {
+       std::vector<int> ids = start_ids(g, start_nodes);
+       std::vector<CostMap> answer(ids.size());
+       std::vector<DijkstraWorkspace> workspace(std::min<int>(thread_count(threads), ids.size()));
+       parallel_for(ids.size(), workspace.size(), [&] (int i, int thread) {
+          DijkstraWorkspace& w = workspace[thread];
+          csr_dijkstra(g, ids[i], w);
+          answer[i] = cost_map(g, w.cost, w.from);
+       });
+       return answer;
+}
+
+
+}
+
+#endif /* MULTI_SOURCE_DIJKSTRA_HPP_ */
@@ -0,0 +1,65 @@
+#ifndef PARALLEL_FOR_HPP_
+#define PARALLEL_FOR_HPP_
+
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+
+
+namespace ics {
+
+
+//Return the number of threads to use when a caller asks for threads (0 or
+//  less means one per hardware thread)
+int thread_count(int threads) {
+      if (threads > 0)
+        return threads;
+      int hardware = std::thread::hardware_concurrency();
+      return hardware > 0 ? hardware : 1;
+}
+
+
+//Call body(i, thread) for every i in [0,count), spread over the given number of
+//  threads (numbered 0 to threads-1; the calling thread is thread 0). Threads
+//  claim the next index from a shared counter, so uneven work balances itself;
+//  body may use thread to pick per-thread workspace, which then needs no
+//  locking. The first exception thrown by body is rethrown here after every
+//  thread has stopped.
+//Programs using it must be compiled with -pthread (Threads::Threads in CMake).
+template<class Body>
+void parallel_for(int count, int threads, Body body) {
+      threads = std::min(thread_count(threads), count);
+      std::atomic<int>   next(0);
+      std::exception_ptr error;
+      std::mutex         error_lock;
+
+      auto work = [&] (int thread) {
+        try {
+          for (int i = next++; i < count; i = next++)
+            body(i, thread);
+        } catch (...) {
+          std::lock_guard<std::mutex> guard(error_lock);
+          if (!error)
+            error = std::current_exception();
+          next = count;                             //Stop the other threads early
+        }
+      };
+
+      std::vector<std::thread> pool;
+      for (int t = 1; t < threads; ++t)
+        pool.push_back(std::thread(work, t));
+      if (threads > 0)
+        work(0);
+      for (std::thread& t : pool)
+        t.join();
+      if (error)
+        std::rethrow_exception(error);
+}
+
+
+}
+
+#endif /* PARALLEL_FOR_HPP_ */
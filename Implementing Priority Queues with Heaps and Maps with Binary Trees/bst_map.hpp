@@ -5,9 +5,12 @@
 #include <iostream>
 #include <sstream>
 #include <initializer_list>
+#include <vector>
+#include <algorithm>         //For std::stable_sort (bulk construction)
 #include "ics_exceptions.hpp"
 #include "pair.hpp"
 #include "array_queue.hpp"   //For traversal
+#include "static_sorted_map.hpp"
 
 
 namespace ics {
@@ -48,6 +51,14 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedl
     bool has_value  (const T& value) const;
     std::string str () const; //supplies useful debugging information; contrast to operator <<
 
+    //Order-statistic queries (use the subtree sizes cached in each TN): O(log N)
+    int   rank        (const KEY& key)                   const; //# of keys < key
+    Entry select      (int i)                            const; //Entry whose key has rank i (0 <= i < size())
+    int   count_range (const KEY& lo, const KEY& hi)     const; //# of keys k with lo <= k < hi
+
+    //Immutable copy laid out for fast searching (see static_sorted_map.hpp): O(N)
+    StaticSortedMap<KEY,T,tlt> freeze () const;
+
 
     //Commands
     T    put   (const KEY& key, const T& value);
@@ -58,6 +69,12 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedl
     template <class Iterable>
     int put_all(const Iterable& i);
 
+    //Merge a batch of associations (ideally in increasing key order; otherwise
+    //  they are sorted first) with those in the map, rebuilding it as a perfectly
+    //  balanced tree in O(N+M); for duplicate keys the batch's (last) value wins
+    template <class Iterable>
+    int put_all_sorted(const Iterable& i);
+
 
     //Operators
 
@@ -71,7 +88,10 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedl
     friend std::ostream& operator << (std::ostream& outs, const BSTMap<KEY2,T2,lt2>& m);
 
 
+  private:
+    class TN;                                 //Defined below; Iterator refers to nodes
 
+  public:
     class Iterator {
       public:
         //Private constructor called in begin/end, which are friends of BSTMap<T>
@@ -90,6 +110,9 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedl
         }
         friend Iterator BSTMap<KEY,T,tlt>::begin () const;
         friend Iterator BSTMap<KEY,T,tlt>::end   () const;
+        friend Iterator BSTMap<KEY,T,tlt>::lower_bound (const KEY& key) const;
+        friend Iterator BSTMap<KEY,T,tlt>::upper_bound (const KEY& key) const;
+        friend class    BSTMap<KEY,T,tlt>::Range;
 
       private:
         //If can_erase is false, the value has been removed from "it" (++ does nothing)
@@ -98,24 +121,69 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedl
         int               expected_mod_count;
         bool              can_erase = true;
 
+        //A lazy Iterator (from lower_bound/upper_bound) queues nothing: path
+        //  holds the current node (at its back) and every ancestor whose key
+        //  follows it, so ++ finds the next key without copying the rest
+        bool              lazy      = false;
+        std::vector<TN*>  path;
+        int               remaining = 0;      //# of associations from the current one to the end
+
         //Called in friends begin/end
         Iterator(BSTMap<KEY,T,tlt>* iterate_over, bool from_begin);
+
+        //Called in friend Range: only the associations whose keys are in the
+        //  bounds are queued
+        Iterator(BSTMap<KEY,T,tlt>* iterate_over, const KEY* lo, bool include_lo, const KEY* hi);
+
+        //Called in friends lower_bound/upper_bound: lazy, from the first key >=
+        //  key (include_key) or > key
+        Iterator(BSTMap<KEY,T,tlt>* iterate_over, const KEY& key, bool include_key);
+
+        int  remaining_count () const;         //# of associations not yet passed
+        void seek            (const KEY& key, bool include_key);
+    };
+
+
+    //Supports a "for-each" loop over the associations whose keys k satisfy lo <= k < hi
+    class Range {
+      public:
+        Iterator begin () const;
+        Iterator end   () const;
+        friend Range BSTMap<KEY,T,tlt>::range (const KEY& lo, const KEY& hi) const;
+
+      private:
+        BSTMap<KEY,T,tlt>* ref_map;
+        KEY                lo;
+        KEY                hi;
+
+        //Called in friend range
+        Range(BSTMap<KEY,T,tlt>* iterate_over, const KEY& the_lo, const KEY& the_hi);
     };
 
 
     Iterator begin () const;
     Iterator end   () const;
 
+    //Iterators in key order starting at the first key >= key (lower_bound) or
+    //  > key (upper_bound); compare them against end() to stop. They are lazy:
+    //  constructing one is O(log N) and each ++ is O(1) amortized, so reading
+    //  the first k associations is O(log N + k).
+    //Range's begin copies its associations (O(log N) plus their number)
+    Iterator lower_bound (const KEY& key)               const;
+    Iterator upper_bound (const KEY& key)               const;
+    Range    range       (const KEY& lo, const KEY& hi) const;
+
 
   private:
     class TN {
       public:
-        TN ()                     : left(nullptr), right(nullptr){}
-        TN (const TN& tn)         : value(tn.value), left(tn.left), right(tn.right){}
+        TN ()                     : size(1), left(nullptr), right(nullptr){}
+        TN (const TN& tn)         : value(tn.value), size(tn.size), left(tn.left), right(tn.right){}
         TN (Entry v, TN* l = nullptr,
-                     TN* r = nullptr) : value(v), left(l), right(r){}
+                     TN* r = nullptr) : value(v), size(1 + (l ? l->size : 0) + (r ? r->size : 0)), left(l), right(r){}
 
         Entry value;
+        int   size;                   //# of TN in the subtree rooted here (including this one)
         TN*   left;
         TN*   right;
     };
@@ -130,6 +198,15 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedl
   bool  has_value           (TN*  root, const T& value)                 const; //Returns whether value is is root's tree
   TN*   copy                (TN*  root)                                 const; //Copy the keys/values in root's tree (identical structure)
   void  copy_to_queue       (TN* root, ArrayQueue<Entry>& q)            const; //Fill queue with root's tree value
+  void  copy_to_vector      (TN* root, std::vector<Entry>& v)           const; //Append root's tree values (in order) to v
+  void  sort_unique         (std::vector<Entry>& entries)               const; //Sort by key (if needed), keeping last duplicate
+  TN*   build_balanced      (const std::vector<Entry>& entries,
+                             int low, int high)                         const; //Perfectly balanced tree of sorted entries[low..high]
+  void  build_from          (std::vector<Entry>& entries);                     //Replace (empty) map by balanced tree of entries
+  void  copy_range_to_queue (TN* root, const KEY* lo, bool include_lo,
+                             const KEY* hi, ArrayQueue<Entry>& q)        const; //Fill queue with root's tree values in bounds
+  static int  tree_size     (TN* root);                                        //# of TN in root's tree (0 for nullptr)
+  static void update_size   (TN* root);                                        //Recompute root's size from its children
   bool  equals              (TN*  root, const BSTMap<KEY,T,tlt>& other) const; //Returns whether root's keys/value are all in other
   std::string string_rotated(TN* root, std::string indent)              const; //Returns string representing root's tree
 
@@ -175,9 +252,12 @@ BSTMap<KEY,T,tlt>::BSTMap(const BSTMap<KEY,T,tlt>& to_copy, bool (*clt)(const KE
         throw TemplateFunctionError("BSTMap::copy constructor: both specified and different");
 
     if (lt != to_copy.lt) {
+        std::vector<Entry> entries;
+        entries.reserve(to_copy.used);
         for (auto i : to_copy) {
-            put(i.first, i.second);
+            entries.push_back(i);
         }
+        build_from(entries);
     }
     else {
         used = to_copy.used;
@@ -194,9 +274,8 @@ BSTMap<KEY,T,tlt>::BSTMap(const std::initializer_list<Entry>& il, bool (*clt)(co
     if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
         throw TemplateFunctionError("BSTMap::initializer_list constructor: both specified and different");
 
-    for (auto i : il) {
-        put(i.first, i.second);
-    }
+    std::vector<Entry> entries(il.begin(), il.end());
+    build_from(entries);
 }
 
 
@@ -209,9 +288,11 @@ BSTMap<KEY,T,tlt>::BSTMap(const Iterable& i, bool (*clt)(const KEY& a, const KEY
     if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
         throw TemplateFunctionError("BSTMap::Iterable constructor: both specified and different");
 
+    std::vector<Entry> entries;
     for (auto j : i) {
-        put(j.first, j.second);
+        entries.push_back(Entry(j.first, j.second));
     }
+    build_from(entries);
 }
 
 
@@ -252,6 +333,64 @@ std::string BSTMap<KEY,T,tlt>::str() const {
 }
 
 
+//Walk one path from the root: every time the path goes right, all keys in the
+//  left subtree (and the key we are leaving) are < key
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+int BSTMap<KEY,T,tlt>::rank (const KEY& key) const {
+    int smaller = 0;
+    for (TN* c = map; c != nullptr; ) {
+        if (lt(c->value.first, key)) {
+            smaller += tree_size(c->left) + 1;
+            c = c->right;
+        } else
+            c = c->left;
+    }
+    return smaller;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BSTMap<KEY,T,tlt>::select (int i) const -> Entry {
+    if (i < 0 || i >= used) {
+        std::ostringstream answer;
+        answer << "BSTMap::select: index(" << i << ") not in Map (size = " << used << ")";
+        throw KeyError(answer.str());
+    }
+
+    TN* c = map;
+    for (;;) {
+        int left_size = tree_size(c->left);
+        if (i < left_size)
+            c = c->left;
+        else if (i == left_size)
+            return c->value;
+        else {
+            i -= left_size + 1;
+            c = c->right;
+        }
+    }
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+int BSTMap<KEY,T,tlt>::count_range (const KEY& lo, const KEY& hi) const {
+    if (!lt(lo, hi))
+        return 0;
+    return rank(hi) - rank(lo);
+}
+
+
+//copy_to_vector supplies the keys in increasing order, so building the
+//  StaticSortedMap needs no sorting
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BSTMap<KEY,T,tlt>::freeze () const -> StaticSortedMap<KEY,T,tlt> {
+    std::vector<Entry> entries;
+    entries.reserve(used);
+    copy_to_vector(map, entries);
+    return StaticSortedMap<KEY,T,tlt>(entries, lt);
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Commands
@@ -293,6 +432,46 @@ int BSTMap<KEY,T,tlt>::put_all(const Iterable& i) {
 }
 
 
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+template<class Iterable>
+int BSTMap<KEY,T,tlt>::put_all_sorted(const Iterable& i) {
+    std::vector<Entry> batch;
+    for (auto m_entry : i) {
+        batch.push_back(Entry(m_entry.first, m_entry.second));
+    }
+    int count = batch.size();
+    sort_unique(batch);
+
+    std::vector<Entry> current;
+    current.reserve(used);
+    copy_to_vector(map, current);
+
+    //Standard merge of two sorted sequences; on equal keys the batch wins
+    std::vector<Entry> merged;
+    merged.reserve(current.size() + batch.size());
+    auto c = current.begin();
+    auto b = batch.begin();
+    while (c != current.end() && b != batch.end()) {
+        if (lt(c->first, b->first))
+            merged.push_back(*c++);
+        else if (lt(b->first, c->first))
+            merged.push_back(*b++);
+        else {
+            merged.push_back(*b++);
+            ++c;
+        }
+    }
+    merged.insert(merged.end(), c, current.end());
+    merged.insert(merged.end(), b, batch.end());
+
+    delete_BST(map);
+    used = merged.size();
+    map = build_balanced(merged, 0, used-1);
+    mod_count++;
+    return count;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Operators
@@ -373,6 +552,21 @@ auto BSTMap<KEY,T,tlt>::end () const -> BSTMap<KEY,T,tlt>::Iterator {
     return Iterator(const_cast<BSTMap<KEY,T,tlt>*>(this),false);
 }
 
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BSTMap<KEY,T,tlt>::lower_bound (const KEY& key) const -> BSTMap<KEY,T,tlt>::Iterator {
+    return Iterator(const_cast<BSTMap<KEY,T,tlt>*>(this), key, true);
+}
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BSTMap<KEY,T,tlt>::upper_bound (const KEY& key) const -> BSTMap<KEY,T,tlt>::Iterator {
+    return Iterator(const_cast<BSTMap<KEY,T,tlt>*>(this), key, false);
+}
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BSTMap<KEY,T,tlt>::range (const KEY& lo, const KEY& hi) const -> BSTMap<KEY,T,tlt>::Range {
+    return Range(const_cast<BSTMap<KEY,T,tlt>*>(this), lo, hi);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Private helper methods
@@ -428,6 +622,95 @@ void BSTMap<KEY,T,tlt>::copy_to_queue (TN* root, ArrayQueue<Entry>& q) const {
 }
 
 
+//Skip any subtree that cannot hold keys in the bounds, so only the
+//  O(log N) nodes on the two boundary paths are visited beyond those queued
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void BSTMap<KEY,T,tlt>::copy_range_to_queue (TN* root, const KEY* lo, bool include_lo, const KEY* hi, ArrayQueue<Entry>& q) const {
+    if (!root)
+        return;
+
+    const KEY& key = root->value.first;
+    bool above_lo = lo == nullptr || (include_lo ? !lt(key, *lo) : lt(*lo, key));
+    bool below_hi = hi == nullptr || lt(key, *hi);
+    if (above_lo)
+        copy_range_to_queue(root->left, lo, include_lo, hi, q);
+    if (above_lo && below_hi)
+        q.enqueue(root->value);
+    if (below_hi)
+        copy_range_to_queue(root->right, lo, include_lo, hi, q);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+int BSTMap<KEY,T,tlt>::tree_size (TN* root) {
+    return root == nullptr ? 0 : root->size;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void BSTMap<KEY,T,tlt>::update_size (TN* root) {
+    root->size = 1 + tree_size(root->left) + tree_size(root->right);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void BSTMap<KEY,T,tlt>::copy_to_vector (TN* root, std::vector<Entry>& v) const {
+    if (!root)
+        return;
+    copy_to_vector(root->left, v);
+    v.push_back(root->value);
+    copy_to_vector(root->right, v);
+}
+
+
+//Already strictly increasing input (the common bulk-load case) is left alone:
+//  O(N); otherwise a stable sort keeps duplicate keys in input order, so
+//  keeping the last of each run matches what calling put for each would do
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void BSTMap<KEY,T,tlt>::sort_unique (std::vector<Entry>& entries) const {
+    bool increasing = true;
+    for (int i = 1; i < int(entries.size()) && increasing; ++i)
+        increasing = lt(entries[i-1].first, entries[i].first);
+    if (increasing)
+        return;
+
+    ltfunc key_lt = lt;
+    std::stable_sort(entries.begin(), entries.end(),
+                     [key_lt] (const Entry& a, const Entry& b) {return key_lt(a.first, b.first);});
+    int kept = 0;
+    for (int i = 0; i < int(entries.size()); ++i)
+        if (kept > 0 && !lt(entries[kept-1].first, entries[i].first))
+            entries[kept-1] = entries[i];
+        else
+            entries[kept++] = entries[i];
+    entries.erase(entries.begin()+kept, entries.end());
+}
+
+
+//The middle entry becomes the root, so subtree sizes differ by at most 1;
+//  each entry is copied once into its node (no comparisons): O(N)
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+typename BSTMap<KEY,T,tlt>::TN* BSTMap<KEY,T,tlt>::build_balanced (const std::vector<Entry>& entries, int low, int high) const {
+    if (low > high)
+        return nullptr;
+
+    int mid = low + (high - low) / 2;
+    TN* root = new TN(entries[mid]);
+    root->left  = build_balanced(entries, low, mid-1);
+    root->right = build_balanced(entries, mid+1, high);
+    update_size(root);
+    return root;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void BSTMap<KEY,T,tlt>::build_from (std::vector<Entry>& entries) {
+    sort_unique(entries);
+    used = entries.size();
+    map = build_balanced(entries, 0, used-1);
+}
+
+
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 bool BSTMap<KEY,T,tlt>::equals (TN* root, const BSTMap<KEY,T,tlt>& other) const {
     if (this == &other)
@@ -475,10 +758,11 @@ T BSTMap<KEY,T,tlt>::insert (TN*& root, const KEY& key, const T& value) {
         root->value.second = value;
         return to_return;
     }
-    else if (lt(key, root->value.first))
-        return insert(root->left, key, value);
-    else
-        return insert(root->right, key, value);
+    else {
+        T to_return = insert((lt(key, root->value.first) ? root->left : root->right), key, value);
+        update_size(root);
+        return to_return;
+    }
 }
 
 
@@ -496,18 +780,21 @@ T& BSTMap<KEY,T,tlt>::find_addempty (TN*& root, const KEY& key) {
     {
         return root->value.second;
     }
-    else if (lt(key, root->value.first))
-        return find_addempty(root->left, key);
-    else
-        return find_addempty(root->right, key);
+    else {
+        T& to_return = find_addempty((lt(key, root->value.first) ? root->left : root->right), key);
+        update_size(root);
+        return to_return;
+    }
 }
 
 
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 pair<KEY,T> BSTMap<KEY,T,tlt>::remove_closest(TN*& root) {
-  if (root->right != nullptr)
-    return remove_closest(root->right);
-  else{
+  if (root->right != nullptr) {
+    Entry to_return = remove_closest(root->right);
+    update_size(root);
+    return to_return;
+  }else{
     Entry to_return = root->value;
     TN* to_delete = root;
     root = root->left;
@@ -534,11 +821,16 @@ T BSTMap<KEY,T,tlt>::remove (TN*& root, const KEY& key) {
         TN* to_delete = root;
         root = root->left;
         delete to_delete;
-      }else
+      }else {
         root->value = remove_closest(root->left);
+        update_size(root);
+      }
       return to_return;
-    }else
-      return remove( (lt(key,root->value.first) ? root->left : root->right), key);
+    }else {
+      T to_return = remove( (lt(key,root->value.first) ? root->left : root->right), key);
+      update_size(root);
+      return to_return;
+    }
 }
 
 
@@ -570,6 +862,20 @@ BSTMap<KEY,T,tlt>::Iterator::Iterator(BSTMap<KEY,T,tlt>* iterate_over, bool from
 }
 
 
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+BSTMap<KEY,T,tlt>::Iterator::Iterator(BSTMap<KEY,T,tlt>* iterate_over, const KEY* lo, bool include_lo, const KEY* hi)
+: ref_map(iterate_over), expected_mod_count(ref_map->mod_count) {
+    ref_map->copy_range_to_queue(ref_map->map, lo, include_lo, hi, it);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+BSTMap<KEY,T,tlt>::Iterator::Iterator(BSTMap<KEY,T,tlt>* iterate_over, const KEY& key, bool include_key)
+: ref_map(iterate_over), expected_mod_count(ref_map->mod_count), lazy(true) {
+    seek(key, include_key);
+}
+
+
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 BSTMap<KEY,T,tlt>::Iterator::~Iterator()
 {}
@@ -581,14 +887,16 @@ auto BSTMap<KEY,T,tlt>::Iterator::erase() -> Entry {
         throw ConcurrentModificationError("BSTMap::Iterator::erase");
     if (!can_erase)
         throw CannotEraseError("BSTMap::Iterator::erase Iterator cursor already erased");
-    if (it.empty())
+    if (remaining_count() == 0)
         throw CannotEraseError("BSTMap::Iterator::erase Iterator cursor beyond data structure");
 
     can_erase = false;
-    Entry to_return = it.dequeue();
+    Entry to_return = (lazy ? path.back()->value : it.dequeue());
     ref_map->remove(ref_map->map, to_return.first);
     ref_map->used--;
     expected_mod_count = ref_map->mod_count;
+    if (lazy)
+        seek(to_return.first, false);         //remove restructures the tree: find the next key again
     return to_return;
 }
 
@@ -596,7 +904,13 @@ auto BSTMap<KEY,T,tlt>::Iterator::erase() -> Entry {
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 std::string BSTMap<KEY,T,tlt>::Iterator::str() const {
     std::ostringstream answer;
-    answer << it.str() << ",expected_mod_count=" << expected_mod_count << ",can_erase=" << can_erase << ")";
+    if (lazy) {
+        answer << "lazy(remaining=" << remaining;
+        if (remaining != 0)
+            answer << ",current=" << path.back()->value.first << "->" << path.back()->value.second;
+    }else
+        answer << it.str();
+    answer << ",expected_mod_count=" << expected_mod_count << ",can_erase=" << can_erase << ")";
     return answer.str();
 }
 
@@ -606,13 +920,22 @@ auto  BSTMap<KEY,T,tlt>::Iterator::operator ++ () -> BSTMap<KEY,T,tlt>::Iterator
     if (expected_mod_count != ref_map->mod_count)
         throw ConcurrentModificationError("BSTMap::Iterator::operator ++");
 
-    if (it.size() == 0)
+    if (remaining_count() == 0)
         return *this;
 
-    if (can_erase)
-        it.dequeue();
-    else
+    if (!can_erase)
         can_erase = true;
+    else if (!lazy)
+        it.dequeue();
+    else {
+        //The next key is leftmost in the current node's right subtree, or
+        //  (if it has none) the nearest ancestor whose key follows it
+        TN* current = path.back();
+        path.pop_back();
+        for (TN* c = current->right; c != nullptr; c = c->left)
+            path.push_back(c);
+        --remaining;
+    }
 
     return *this;
 
@@ -624,15 +947,11 @@ auto BSTMap<KEY,T,tlt>::Iterator::operator ++ (int) -> BSTMap<KEY,T,tlt>::Iterat
     if (expected_mod_count != ref_map->mod_count)
         throw ConcurrentModificationError("BSTMap::Iterator::operator ++(int)");
 
-    if (it.size() == 0)
+    if (remaining_count() == 0)
         return *this;
 
     Iterator to_return(*this);
-    if (can_erase)
-        it.dequeue();
-    else
-        can_erase = true;
-
+    ++(*this);
     return to_return;
 }
 
@@ -647,7 +966,7 @@ bool BSTMap<KEY,T,tlt>::Iterator::operator == (const BSTMap<KEY,T,tlt>::Iterator
     if (ref_map != rhsASI->ref_map)
         throw ComparingDifferentIteratorsError("BSTMap::Iterator::operator ==");
 
-    return it.size() == rhsASI->it.size();
+    return remaining_count() == rhsASI->remaining_count();
 }
 
 
@@ -661,7 +980,7 @@ bool BSTMap<KEY,T,tlt>::Iterator::operator != (const BSTMap<KEY,T,tlt>::Iterator
     if (ref_map != rhsASI->ref_map)
         throw ComparingDifferentIteratorsError("BSTMap::Iterator::operator !=");
 
-    return it.size() != rhsASI->it.size();
+    return remaining_count() != rhsASI->remaining_count();
 }
 
 
@@ -669,13 +988,13 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 pair<KEY,T>& BSTMap<KEY,T,tlt>::Iterator::operator *() const {
     if (expected_mod_count != ref_map->mod_count)
         throw ConcurrentModificationError("BSTMap::Iterator::operator *");
-    if (!can_erase || it.size() == 0) {
+    if (!can_erase || remaining_count() == 0) {
         std::ostringstream where;
         where << it << " when size = " << ref_map->size();
         throw IteratorPositionIllegal("BSTMap::Iterator::operator * Iterator illegal: "+where.str());
     }
 
-    return it.peek();
+    return (lazy ? path.back()->value : it.peek());
 }
 
 
@@ -683,13 +1002,64 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 pair<KEY,T>* BSTMap<KEY,T,tlt>::Iterator::operator ->() const {
     if (expected_mod_count != ref_map->mod_count)
         throw ConcurrentModificationError("BSTMap::Iterator::operator ->");
-    if (!can_erase || it.size() == 0) {
+    if (!can_erase || remaining_count() == 0) {
         std::ostringstream where;
         where << it << " when size = " << ref_map->size();
         throw IteratorPositionIllegal("BSTMap::Iterator::operator -> Iterator illegal: "+where.str());
     }
 
-    return &(it.peek);
+    return (lazy ? &path.back()->value : &it.peek());
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+int BSTMap<KEY,T,tlt>::Iterator::remaining_count() const {
+    return lazy ? remaining : it.size();
+}
+
+
+//Descend from the root toward key, pushing each node whose key is in bounds
+//  (then going left) and counting the keys before each node passed on the
+//  right (with the cached subtree sizes): O(log N) for a balanced tree
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void BSTMap<KEY,T,tlt>::Iterator::seek(const KEY& key, bool include_key) {
+    path.clear();
+    int before = 0;
+    for (TN* c = ref_map->map; c != nullptr; ) {
+        const KEY& k = c->value.first;
+        if (include_key ? !ref_map->lt(k, key) : ref_map->lt(key, k)) {
+            path.push_back(c);
+            c = c->left;
+        }else{
+            before += tree_size(c->left) + 1;
+            c = c->right;
+        }
+    }
+    remaining = ref_map->used - before;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Range class definitions
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+BSTMap<KEY,T,tlt>::Range::Range(BSTMap<KEY,T,tlt>* iterate_over, const KEY& the_lo, const KEY& the_hi)
+: ref_map(iterate_over), lo(the_lo), hi(the_hi)
+{}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BSTMap<KEY,T,tlt>::Range::begin () const -> BSTMap<KEY,T,tlt>::Iterator {
+    return Iterator(ref_map, &lo, true, &hi);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BSTMap<KEY,T,tlt>::Range::end () const -> BSTMap<KEY,T,tlt>::Iterator {
+    return Iterator(ref_map, false);
 }
 
 
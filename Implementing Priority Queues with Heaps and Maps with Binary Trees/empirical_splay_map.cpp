@@ -0,0 +1,121 @@
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <random>
+#include <cmath>                     //std::pow
+#include <algorithm>                 //std::shuffle, std::upper_bound
+#include "ics46goody.hpp"
+#include "stopwatch.hpp"
+#include "ics_exceptions.hpp"
+#include "pair.hpp"
+#include "bst_map.hpp"
+#include "splay_map.hpp"
+
+
+//Compare BSTMap (built by put in random order, and built balanced in bulk)
+//  with SplayMap on lookups whose keys follow a Zipf distribution: the word of
+//  rank r (1 = most frequent) is looked up with probability proportional to
+//  1/r^s, which is roughly how often words are looked up in wordgenerator.
+
+bool word_lt(const std::string& a, const std::string& b) {return a < b;}
+
+typedef ics::pair<std::string,int>                   WordEntry;
+typedef ics::BSTMap<std::string,int,word_lt>         PlainMap;
+typedef ics::SplayMap<std::string,int,word_lt>       SplayMap;
+
+
+//Return a vector of count indexes in [0,n) drawn from a Zipf distribution
+//  with exponent s, by binary searching a random number in the cumulative sums
+std::vector<int> zipf_indexes(int n, double s, int count, std::default_random_engine& generator) {
+  std::vector<double> cumulative(n);
+  double total = 0;
+  for (int r=1; r<=n; ++r) {
+    total += 1.0/std::pow(r,s);
+    cumulative[r-1] = total;
+  }
+
+  std::uniform_real_distribution<double> distribution(0.0,total);
+  std::vector<int> answer(count);
+  for (int i=0; i<count; ++i)
+    answer[i] = std::upper_bound(cumulative.begin(), cumulative.end(), distribution(generator)) - cumulative.begin();
+  return answer;
+}
+
+
+//Look up every word (as produce_text does: has_key, then operator []) and
+//  return the elapsed time; the sum keeps the lookups from being optimized away
+template<class Map>
+double time_lookups(const Map& m, const std::vector<std::string>& lookups, long long& sum) {
+  ics::Stopwatch watch;
+  watch.start();
+  for (const std::string& w : lookups)
+    if (m.has_key(w))
+      sum += m[w];
+  watch.stop();
+  return watch.read();
+}
+
+
+int main() {
+  try {
+    int N       = ics::prompt_int("Enter N for test (number of distinct words)",100000);
+    int lookups = ics::prompt_int("Enter number of lookups",2000000);
+    double s    = 1.0;                      //Zipf exponent typical of word frequencies
+
+    std::default_random_engine generator;
+    std::vector<std::string> words;
+    for (int i=0; i<N; ++i) {
+      std::ostringstream w;
+      w << "w" << generator();
+      words.push_back(w.str());
+    }
+    std::sort(words.begin(),words.end());
+    words.erase(std::unique(words.begin(),words.end()),words.end());
+    N = words.size();
+
+    //Random insertion order for the plain BST; the frequency rank of each word
+    //  is independent of its alphabetical position
+    std::vector<std::string> shuffled(words);
+    std::shuffle(shuffled.begin(), shuffled.end(), generator);
+    std::vector<std::string> lookup_words;
+    for (int i : zipf_indexes(N,s,lookups,generator))
+      lookup_words.push_back(shuffled[i]);
+
+    ics::Stopwatch build;
+    build.start();
+    PlainMap plain;
+    for (int i=0; i<N; ++i)
+      plain.put(shuffled[i],i);
+    build.stop();
+    std::cout << "BSTMap (put, random order) build time = " << build.read() << std::endl;
+
+    std::vector<WordEntry> sorted_entries;
+    for (int i=0; i<N; ++i)
+      sorted_entries.push_back(WordEntry(words[i],i));
+    build.reset();
+    build.start();
+    PlainMap balanced(sorted_entries);
+    build.stop();
+    std::cout << "BSTMap (balanced bulk) build time     = " << build.read() << std::endl;
+
+    build.reset();
+    build.start();
+    SplayMap splay;
+    for (int i=0; i<N; ++i)
+      splay.put(shuffled[i],i);
+    build.stop();
+    std::cout << "SplayMap (put, random order) build time = " << build.read() << std::endl;
+
+    long long sum = 0;
+    std::cout << std::endl << lookups << " Zipf(s=" << s << ") lookups over " << N << " words" << std::endl;
+    std::cout << "  BSTMap (random order) time = " << time_lookups(plain,   lookup_words,sum) << std::endl;
+    std::cout << "  BSTMap (balanced) time     = " << time_lookups(balanced,lookup_words,sum) << std::endl;
+    std::cout << "  SplayMap time              = " << time_lookups(splay,   lookup_words,sum) << std::endl;
+    std::cout << "  (checksum = " << sum << ")" << std::endl;
+  } catch (ics::IcsError& e) {
+    std::cout << "  " << e.what() << std::endl;
+  }
+
+  return 0;
+}
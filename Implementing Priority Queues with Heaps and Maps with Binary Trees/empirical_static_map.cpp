@@ -0,0 +1,87 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>                 //std::sort, std::lower_bound
+#include "ics46goody.hpp"
+#include "stopwatch.hpp"
+#include "ics_exceptions.hpp"
+#include "pair.hpp"
+#include "bst_map.hpp"
+#include "static_sorted_map.hpp"
+
+
+//Compare three ways of searching a map that is built once and then only
+//  queried: BSTMap::has_key (pointer chasing), binary search over a sorted
+//  array (std::lower_bound), and the StaticSortedMap made by BSTMap::freeze
+//  (Eytzinger layout, branchless, prefetching). Half the queries are hits.
+
+bool int_lt(const int& a, const int& b) {return a < b;}
+
+typedef ics::BSTMap<int,int,int_lt>          TreeMap;
+typedef ics::StaticSortedMap<int,int,int_lt> FrozenMap;
+
+
+template<class Map>
+double time_map(const Map& m, const std::vector<int>& queries, long long& found) {
+  ics::Stopwatch watch;
+  watch.start();
+  for (int q : queries)
+    found += m.has_key(q);
+  watch.stop();
+  return watch.read();
+}
+
+
+double time_sorted_array(const std::vector<int>& sorted, const std::vector<int>& queries, long long& found) {
+  ics::Stopwatch watch;
+  watch.start();
+  for (int q : queries) {
+    auto i = std::lower_bound(sorted.begin(), sorted.end(), q);
+    found += (i != sorted.end() && *i == q);
+  }
+  watch.stop();
+  return watch.read();
+}
+
+
+int main() {
+  try {
+    int N       = ics::prompt_int("Enter N for test (number of keys)",1000000);
+    int queries = ics::prompt_int("Enter number of queries",5000000);
+
+    //Even keys are in the map; odd queries miss
+    std::default_random_engine generator;
+    std::vector<int> keys;
+    for (int i=0; i<N; ++i)
+      keys.push_back(2*i);
+    std::vector<int> shuffled(keys);
+    std::shuffle(shuffled.begin(), shuffled.end(), generator);
+
+    std::uniform_int_distribution<int> distribution(0,2*N-1);
+    std::vector<int> query_keys(queries);
+    for (int i=0; i<queries; ++i)
+      query_keys[i] = distribution(generator);
+
+    TreeMap tree;
+    for (int k : shuffled)
+      tree.put(k,k);
+
+    ics::Stopwatch build;
+    build.start();
+    FrozenMap frozen = tree.freeze();
+    build.stop();
+    std::cout << "freeze time for " << N << " keys = " << build.read() << std::endl;
+
+    long long found[3] = {0,0,0};
+    std::cout << std::endl << queries << " queries over " << N << " keys" << std::endl;
+    std::cout << "  BSTMap::has_key time          = " << time_map(tree,query_keys,found[0]) << std::endl;
+    std::cout << "  sorted array binary search    = " << time_sorted_array(keys,query_keys,found[1]) << std::endl;
+    std::cout << "  StaticSortedMap::has_key time = " << time_map(frozen,query_keys,found[2]) << std::endl;
+    std::cout << "  (found = " << found[0] << "/" << found[1] << "/" << found[2] << ")" << std::endl;
+  } catch (ics::IcsError& e) {
+    std::cout << "  " << e.what() << std::endl;
+  }
+
+  return 0;
+}
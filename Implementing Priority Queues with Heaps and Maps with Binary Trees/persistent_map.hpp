@@ -0,0 +1,672 @@
+#ifndef PERSISTENT_MAP_HPP_
+#define PERSISTENT_MAP_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <atomic>
+#include <initializer_list>
+#include "ics_exceptions.hpp"
+#include "pair.hpp"
+
+
+namespace ics {
+
+
+#ifndef undefinedltdefined
+#define undefinedltdefined
+template<class T>
+bool undefinedlt (const T& a, const T& b) {return false;}
+#endif /* undefinedltdefined */
+
+//A PersistentMap is an ordered map whose tree nodes are never changed once
+//  built. put/erase copy only the nodes on the path from the root to the key
+//  (O(log N) expected: the tree is a treap with random priorities) and share
+//  every other node with the previous version. Nodes are reference counted,
+//  so copying a map (the copy constructor, operator =, or snapshot) is O(1):
+//  the copy is a consistent snapshot that later updates to either map cannot
+//  change. Reference counts are atomic, so snapshots may be read in other
+//  threads while the original is updated (each map object itself still needs
+//  a single writer).
+//Because nodes are shared there is no non-const operator []: use put.
+//
+//Instantiate the templated class supplying tlt(a,b): true, iff a is less than b.
+//If tlt is defaulted to undefinedlt in the template, then a constructor must supply clt.
+//If both tlt and clt are supplied, then they must be the same (by ==) function.
+//If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
+//The (unique) non-undefinedlt value supplied by tlt/clt is stored in the instance variable lt.
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedlt<KEY>> class PersistentMap {
+  private:
+    class TN;
+
+  public:
+    typedef pair<KEY,T> Entry;
+    typedef bool (*ltfunc) (const KEY& a, const KEY& b);
+
+    //Destructor/Constructors
+    ~PersistentMap();
+
+    PersistentMap          (bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+    PersistentMap          (const PersistentMap<KEY,T,tlt>& to_copy);    //O(1): shares all nodes
+    explicit PersistentMap (const std::initializer_list<Entry>& il, bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit PersistentMap (const Iterable& i, bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+
+
+    //Queries
+    bool empty      () const;
+    int  size       () const;
+    bool has_key    (const KEY& key) const;
+    bool has_value  (const T& value) const;
+    PersistentMap<KEY,T,tlt> snapshot () const;   //O(1) copy of the current version
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+
+    //Commands
+    T    put   (const KEY& key, const T& value);
+    T    erase (const KEY& key);
+    void clear ();
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    int put_all(const Iterable& i);
+
+
+    //Operators
+
+    const T& operator [] (const KEY&) const;
+    PersistentMap<KEY,T,tlt>& operator = (const PersistentMap<KEY,T,tlt>& rhs);   //O(1): shares all nodes
+    bool operator == (const PersistentMap<KEY,T,tlt>& rhs) const;
+    bool operator != (const PersistentMap<KEY,T,tlt>& rhs) const;
+
+    template<class KEY2,class T2, bool (*lt2)(const KEY2& a, const KEY2& b)>
+    friend std::ostream& operator << (std::ostream& outs, const PersistentMap<KEY2,T2,lt2>& m);
+
+
+
+    //An Iterator walks (in key order) the version of the map current when begin
+    //  was called, holding a reference to its root; later updates to the map
+    //  cannot affect it, so there is no ConcurrentModificationError.
+    class Iterator {
+      public:
+        //Private constructor called in begin/end, which are friends of PersistentMap<T>
+        ~Iterator();
+        Iterator(const Iterator& i);
+        Iterator& operator = (const Iterator& rhs);
+        Entry       erase();                               //Erases the current key from the map (not this version)
+        std::string str  () const;
+        PersistentMap<KEY,T,tlt>::Iterator& operator ++ ();
+        PersistentMap<KEY,T,tlt>::Iterator  operator ++ (int);
+        bool operator == (const PersistentMap<KEY,T,tlt>::Iterator& rhs) const;
+        bool operator != (const PersistentMap<KEY,T,tlt>::Iterator& rhs) const;
+        const Entry& operator *  () const;
+        const Entry* operator -> () const;
+        friend std::ostream& operator << (std::ostream& outs, const PersistentMap<KEY,T,tlt>::Iterator& i) {
+          outs << i.str(); //Use the same meaning as the debugging .str() method
+          return outs;
+        }
+        friend Iterator PersistentMap<KEY,T,tlt>::begin () const;
+        friend Iterator PersistentMap<KEY,T,tlt>::end   () const;
+
+      private:
+        //If can_erase is false, the current node was erased (++ just resets can_erase)
+        TN*                       version;            //Root of the version iterated over (holds a reference)
+        std::vector<TN*>          path;               //Ancestors still to visit; back() is the current node
+        PersistentMap<KEY,T,tlt>* ref_map;
+        bool                      can_erase = true;
+
+        void push_left(TN* n);                        //Push n and its chain of left descendants
+
+        //Called in friends begin/end
+        Iterator(PersistentMap<KEY,T,tlt>* iterate_over, bool from_begin);
+    };
+
+
+    Iterator begin () const;
+    Iterator end   () const;
+
+
+  private:
+    //Nodes are immutable once reachable from a map; a new node starts with one
+    //  reference, owned by whoever created it, and the constructor takes
+    //  ownership of one reference to each child
+    class TN {
+      public:
+        TN (const Entry& v, unsigned p, TN* l = nullptr,
+                                        TN* r = nullptr) : value(v), priority(p), left(l), right(r), refs(1){}
+
+        Entry            value;
+        unsigned         priority;    //Treap (max-heap) ordering: parent priority >= child priority
+        TN*              left;
+        TN*              right;
+        std::atomic<int> refs;
+    };
+
+  bool (*lt) (const KEY& a, const KEY& b); // The lt used for searching (from template or constructor)
+  TN* map       = nullptr;                 //Holds one reference to the root of the current version
+  int used      = 0;                       //Cache for number of key->value pairs in the current version
+
+  //Helper methods
+  static TN*      retain        (TN* root);                            //Add a reference; returns root
+  static void     release       (TN* root);                            //Drop a reference, deleting nodes no longer used
+  static unsigned next_priority ();                                    //Pseudo-random priority for a new node
+
+  TN*   find_key      (const KEY& key)                           const; //Returns key's node or nullptr
+  TN*   insert        (TN* root, const Entry& e, unsigned p, bool& added) const; //New version of root's tree with e
+  TN*   remove        (TN* root, const KEY& key)                 const; //New version of root's tree without key (present)
+  TN*   join          (TN* a, TN* b)                             const; //New tree of a's keys then b's keys (all a < all b)
+  std::string string_rotated(TN* root, std::string indent)       const; //Returns string representing root's tree
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//PersistentMap class and related definitions
+
+//Destructor/Constructors
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+PersistentMap<KEY,T,tlt>::~PersistentMap() {
+    release(map);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+PersistentMap<KEY,T,tlt>::PersistentMap(bool (*clt)(const KEY& a, const KEY& b))
+: lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt) {
+    if (lt == (ltfunc)undefinedlt<KEY>)
+        throw TemplateFunctionError("PersistentMap::default constructor: neither specified");
+    if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
+        throw TemplateFunctionError("PersistentMap::default constructor: both specified and different");
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+PersistentMap<KEY,T,tlt>::PersistentMap(const PersistentMap<KEY,T,tlt>& to_copy)
+: lt(to_copy.lt), map(retain(to_copy.map)), used(to_copy.used)
+{}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+PersistentMap<KEY,T,tlt>::PersistentMap(const std::initializer_list<Entry>& il, bool (*clt)(const KEY& a, const KEY& b))
+: lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt) {
+    if (lt == (ltfunc)undefinedlt<KEY>)
+        throw TemplateFunctionError("PersistentMap::initializer_list constructor: neither specified");
+    if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
+        throw TemplateFunctionError("PersistentMap::initializer_list constructor: both specified and different");
+
+    for (auto i : il) {
+        put(i.first, i.second);
+    }
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+template <class Iterable>
+PersistentMap<KEY,T,tlt>::PersistentMap(const Iterable& i, bool (*clt)(const KEY& a, const KEY& b))
+: lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt) {
+    if (lt == (ltfunc)undefinedlt<KEY>)
+        throw TemplateFunctionError("PersistentMap::Iterable constructor: neither specified");
+    if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
+        throw TemplateFunctionError("PersistentMap::Iterable constructor: both specified and different");
+
+    for (auto j : i) {
+        put(j.first, j.second);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool PersistentMap<KEY,T,tlt>::empty() const {
+    return used == 0;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+int PersistentMap<KEY,T,tlt>::size() const {
+    return used;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool PersistentMap<KEY,T,tlt>::has_key (const KEY& key) const {
+    return find_key(key) != nullptr;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool PersistentMap<KEY,T,tlt>::has_value (const T& value) const {
+    for (const Entry& e : *this)
+        if (e.second == value)
+            return true;
+    return false;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentMap<KEY,T,tlt>::snapshot () const -> PersistentMap<KEY,T,tlt> {
+    return PersistentMap<KEY,T,tlt>(*this);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::string PersistentMap<KEY,T,tlt>::str() const {
+    std::ostringstream outs;
+    outs << "persistent_map[";
+    outs<< string_rotated(map,"\n") << "\n](used = " << used << ")";
+    return  outs.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+//Build the new version completely before releasing the old one, so the
+//  shared nodes are never without a reference
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+T PersistentMap<KEY,T,tlt>::put(const KEY& key, const T& value) {
+    TN* old = find_key(key);
+    T to_return = (old == nullptr ? value : old->value.second);
+
+    bool added = false;
+    TN* new_map = insert(map, Entry(key,value), next_priority(), added);
+    release(map);
+    map = new_map;
+    if (added)
+        used++;
+    return to_return;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+T PersistentMap<KEY,T,tlt>::erase(const KEY& key) {
+    TN* old = find_key(key);
+    if (old == nullptr) {
+        std::ostringstream answer;
+        answer << "PersistentMap::erase: key(" << key << ") not in Map";
+        throw KeyError(answer.str());
+    }
+
+    T to_return = old->value.second;
+    TN* new_map = remove(map, key);
+    release(map);
+    map = new_map;
+    --used;
+    return to_return;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void PersistentMap<KEY,T,tlt>::clear() {
+    release(map);
+    map = nullptr;
+    used = 0;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+template<class Iterable>
+int PersistentMap<KEY,T,tlt>::put_all(const Iterable& i) {
+    int count = 0;
+    for (auto m_entry : i) {
+        ++count;
+        put(m_entry.first, m_entry.second);
+    }
+
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+const T& PersistentMap<KEY,T,tlt>::operator [] (const KEY& key) const {
+    TN* n = find_key(key);
+    if (n == nullptr) {
+        std::ostringstream answer;
+        answer << "PersistentMap::operator []: key(" << key << ") not in Map";
+        throw KeyError(answer.str());
+    }
+    return n->value.second;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+PersistentMap<KEY,T,tlt>& PersistentMap<KEY,T,tlt>::operator = (const PersistentMap<KEY,T,tlt>& rhs) {
+    if (this == &rhs)
+        return *this;
+
+    TN* new_map = retain(rhs.map);
+    release(map);
+    map  = new_map;
+    used = rhs.used;
+    lt   = rhs.lt;
+    return *this;
+}
+
+
+//Versions that share their root are equal without looking further
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool PersistentMap<KEY,T,tlt>::operator == (const PersistentMap<KEY,T,tlt>& rhs) const {
+    if (map == rhs.map)
+        return true;
+    if (used != rhs.used)
+        return false;
+
+    for (const Entry& e : *this) {
+        TN* n = rhs.find_key(e.first);
+        if (n == nullptr || !(n->value.second == e.second))
+            return false;
+    }
+    return true;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool PersistentMap<KEY,T,tlt>::operator != (const PersistentMap<KEY,T,tlt>& rhs) const {
+    return !(*this == rhs);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::ostream& operator << (std::ostream& outs, const PersistentMap<KEY,T,tlt>& m) {
+    outs << "map[";
+    int i = 0;
+    for(const auto& kv : m)
+    {
+        outs<<kv.first<<"->"<<kv.second;
+        i++;
+        if(m.size() > 1 && i < m.size())
+            outs<<", ";
+    }
+
+    outs<<"]";
+    return  outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentMap<KEY,T,tlt>::begin () const -> PersistentMap<KEY,T,tlt>::Iterator {
+    return Iterator(const_cast<PersistentMap<KEY,T,tlt>*>(this), true);
+}
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentMap<KEY,T,tlt>::end () const -> PersistentMap<KEY,T,tlt>::Iterator {
+    return Iterator(const_cast<PersistentMap<KEY,T,tlt>*>(this),false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+typename PersistentMap<KEY,T,tlt>::TN* PersistentMap<KEY,T,tlt>::retain (TN* root) {
+    if (root != nullptr)
+        root->refs.fetch_add(1, std::memory_order_relaxed);
+    return root;
+}
+
+
+//The thread dropping the last reference deletes the node and drops its
+//  references to its children (recursion depth is the treap's height)
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void PersistentMap<KEY,T,tlt>::release (TN* root) {
+    if (root != nullptr && root->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        release(root->left);
+        release(root->right);
+        delete root;
+    }
+}
+
+
+//Weyl sequence passed through a 32-bit integer mixer: cheap, thread-safe,
+//  and random enough to keep the treap's expected height O(log N)
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+unsigned PersistentMap<KEY,T,tlt>::next_priority () {
+    static std::atomic<unsigned> counter(0);
+    unsigned x = counter.fetch_add(0x9E3779B9u, std::memory_order_relaxed);
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return x;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+typename PersistentMap<KEY,T,tlt>::TN* PersistentMap<KEY,T,tlt>::find_key (const KEY& key) const {
+    TN* c = map;
+    while (c != nullptr && !(c->value.first == key))
+        c = (lt(key, c->value.first) ? c->left : c->right);
+    return c;
+}
+
+
+//Every node returned is new (one reference, owned by the caller), so the
+//  rotation that restores the heap order on the way back up may change it
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+typename PersistentMap<KEY,T,tlt>::TN* PersistentMap<KEY,T,tlt>::insert (TN* root, const Entry& e, unsigned p, bool& added) const {
+    if (root == nullptr) {
+        added = true;
+        return new TN(e, p);
+    }
+    if (root->value.first == e.first)
+        return new TN(e, root->priority, retain(root->left), retain(root->right));
+
+    if (lt(e.first, root->value.first)) {
+        TN* l = insert(root->left, e, p, added);
+        TN* n = new TN(root->value, root->priority, l, retain(root->right));
+        if (l->priority > n->priority) {          //rotate right
+            n->left  = l->right;
+            l->right = n;
+            return l;
+        }
+        return n;
+    }else{
+        TN* r = insert(root->right, e, p, added);
+        TN* n = new TN(root->value, root->priority, retain(root->left), r);
+        if (r->priority > n->priority) {          //rotate left
+            n->right = r->left;
+            r->left  = n;
+            return r;
+        }
+        return n;
+    }
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+typename PersistentMap<KEY,T,tlt>::TN* PersistentMap<KEY,T,tlt>::remove (TN* root, const KEY& key) const {
+    if (root->value.first == key)
+        return join(root->left, root->right);
+    else if (lt(key, root->value.first))
+        return new TN(root->value, root->priority, remove(root->left, key), retain(root->right));
+    else
+        return new TN(root->value, root->priority, retain(root->left), remove(root->right, key));
+}
+
+
+//Copies only the nodes on the right spine of a and the left spine of b
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+typename PersistentMap<KEY,T,tlt>::TN* PersistentMap<KEY,T,tlt>::join (TN* a, TN* b) const {
+    if (a == nullptr)
+        return retain(b);
+    if (b == nullptr)
+        return retain(a);
+
+    if (a->priority > b->priority)
+        return new TN(a->value, a->priority, retain(a->left), join(a->right, b));
+    else
+        return new TN(b->value, b->priority, join(a, b->left), retain(b->right));
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::string PersistentMap<KEY,T,tlt>::string_rotated(TN* root, std::string indent) const {
+    std::ostringstream rotated;
+    if (root == nullptr)
+        return "";
+    else {
+        rotated <<string_rotated(root->right, indent+"..")<<indent<< root->value.first<<"->" << root->value.second << string_rotated(root->left, indent+"..");
+        return rotated.str();
+    }
+}
+
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+PersistentMap<KEY,T,tlt>::Iterator::Iterator(PersistentMap<KEY,T,tlt>* iterate_over, bool from_begin)
+: version(nullptr), ref_map(iterate_over) {
+    if (from_begin) {
+        version = retain(ref_map->map);
+        push_left(version);
+    }
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+PersistentMap<KEY,T,tlt>::Iterator::Iterator(const Iterator& i)
+: version(retain(i.version)), path(i.path), ref_map(i.ref_map), can_erase(i.can_erase)
+{}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentMap<KEY,T,tlt>::Iterator::operator = (const Iterator& rhs) -> Iterator& {
+    TN* new_version = retain(rhs.version);
+    release(version);
+    version   = new_version;
+    path      = rhs.path;
+    ref_map   = rhs.ref_map;
+    can_erase = rhs.can_erase;
+    return *this;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+PersistentMap<KEY,T,tlt>::Iterator::~Iterator() {
+    release(version);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void PersistentMap<KEY,T,tlt>::Iterator::push_left(TN* n) {
+    for (; n != nullptr; n = n->left)
+        path.push_back(n);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentMap<KEY,T,tlt>::Iterator::erase() -> Entry {
+    if (!can_erase)
+        throw CannotEraseError("PersistentMap::Iterator::erase Iterator cursor already erased");
+    if (path.empty())
+        throw CannotEraseError("PersistentMap::Iterator::erase Iterator cursor beyond data structure");
+
+    can_erase = false;
+    Entry to_return = path.back()->value;
+    ref_map->erase(to_return.first);
+    return to_return;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::string PersistentMap<KEY,T,tlt>::Iterator::str() const {
+    std::ostringstream answer;
+    answer << "PersistentMap::Iterator(";
+    if (path.empty())
+        answer << "at end";
+    else
+        answer << "current=" << path.back()->value;
+    answer << ",can_erase=" << can_erase << ")";
+    return answer.str();
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto  PersistentMap<KEY,T,tlt>::Iterator::operator ++ () -> PersistentMap<KEY,T,tlt>::Iterator& {
+    if (path.empty())
+        return *this;
+
+    TN* current = path.back();
+    path.pop_back();
+    push_left(current->right);
+    can_erase = true;
+    return *this;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentMap<KEY,T,tlt>::Iterator::operator ++ (int) -> PersistentMap<KEY,T,tlt>::Iterator {
+    Iterator to_return(*this);
+    ++(*this);
+    return to_return;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool PersistentMap<KEY,T,tlt>::Iterator::operator == (const PersistentMap<KEY,T,tlt>::Iterator& rhs) const {
+    if (ref_map != rhs.ref_map)
+        throw ComparingDifferentIteratorsError("PersistentMap::Iterator::operator ==");
+
+    return (path.empty() ? nullptr : path.back()) == (rhs.path.empty() ? nullptr : rhs.path.back());
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool PersistentMap<KEY,T,tlt>::Iterator::operator != (const PersistentMap<KEY,T,tlt>::Iterator& rhs) const {
+    return !(*this == rhs);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentMap<KEY,T,tlt>::Iterator::operator *() const -> const Entry& {
+    if (!can_erase || path.empty()) {
+        std::ostringstream where;
+        where << str() << " when size = " << ref_map->size();
+        throw IteratorPositionIllegal("PersistentMap::Iterator::operator * Iterator illegal: "+where.str());
+    }
+
+    return path.back()->value;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentMap<KEY,T,tlt>::Iterator::operator ->() const -> const Entry* {
+    if (!can_erase || path.empty()) {
+        std::ostringstream where;
+        where << str() << " when size = " << ref_map->size();
+        throw IteratorPositionIllegal("PersistentMap::Iterator::operator -> Iterator illegal: "+where.str());
+    }
+
+    return &(path.back()->value);
+}
+
+
+}
+
+#endif /* PERSISTENT_MAP_HPP_ */
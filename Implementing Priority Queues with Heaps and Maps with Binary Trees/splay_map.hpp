@@ -0,0 +1,736 @@
+#ifndef SPLAY_MAP_HPP_
+#define SPLAY_MAP_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <initializer_list>
+#include "ics_exceptions.hpp"
+#include "pair.hpp"
+#include "array_queue.hpp"   //For traversal
+
+
+namespace ics {
+
+
+#ifndef undefinedltdefined
+#define undefinedltdefined
+template<class T>
+bool undefinedlt (const T& a, const T& b) {return false;}
+#endif /* undefinedltdefined */
+
+//A SplayMap has the same interface as a BSTMap, but every access (has_key,
+//  operator [], put, erase) moves the key's node (or the last node on its
+//  search path) to the root by top-down splaying. Frequently accessed keys
+//  therefore stay near the root: for skewed (e.g., Zipfian) lookups they are
+//  found in a few comparisons, and any sequence of M accesses is O(M log N).
+//Two keys are the same if neither is lt the other.
+//Lookups in const methods also splay, so the root pointer is mutable.
+//
+//Instantiate the templated class supplying tlt(a,b): true, iff a is less than b.
+//If tlt is defaulted to undefinedlt in the template, then a constructor must supply clt.
+//If both tlt and clt are supplied, then they must be the same (by ==) function.
+//If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
+//The (unique) non-undefinedlt value supplied by tlt/clt is stored in the instance variable lt.
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedlt<KEY>> class SplayMap {
+  public:
+    typedef pair<KEY,T> Entry;
+    typedef bool (*ltfunc) (const KEY& a, const KEY& b);
+
+    //Destructor/Constructors
+    ~SplayMap();
+
+    SplayMap          (bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+    SplayMap          (const SplayMap<KEY,T,tlt>& to_copy, bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+    explicit SplayMap (const std::initializer_list<Entry>& il, bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit SplayMap (const Iterable& i, bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+
+
+    //Queries
+    bool empty      () const;
+    int  size       () const;
+    bool has_key    (const KEY& key) const;
+    bool has_value  (const T& value) const;
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+
+    //Commands
+    T    put   (const KEY& key, const T& value);
+    T    erase (const KEY& key);
+    void clear ();
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    int put_all(const Iterable& i);
+
+
+    //Operators
+
+    T&       operator [] (const KEY&);
+    const T& operator [] (const KEY&) const;
+    SplayMap<KEY,T,tlt>& operator = (const SplayMap<KEY,T,tlt>& rhs);
+    bool operator == (const SplayMap<KEY,T,tlt>& rhs) const;
+    bool operator != (const SplayMap<KEY,T,tlt>& rhs) const;
+
+    template<class KEY2,class T2, bool (*lt2)(const KEY2& a, const KEY2& b)>
+    friend std::ostream& operator << (std::ostream& outs, const SplayMap<KEY2,T2,lt2>& m);
+
+
+
+    class Iterator {
+      public:
+        //Private constructor called in begin/end, which are friends of SplayMap<T>
+        ~Iterator();
+        Entry       erase();
+        std::string str  () const;
+        SplayMap<KEY,T,tlt>::Iterator& operator ++ ();
+        SplayMap<KEY,T,tlt>::Iterator  operator ++ (int);
+        bool operator == (const SplayMap<KEY,T,tlt>::Iterator& rhs) const;
+        bool operator != (const SplayMap<KEY,T,tlt>::Iterator& rhs) const;
+        Entry& operator *  () const;
+        Entry* operator -> () const;
+        friend std::ostream& operator << (std::ostream& outs, const SplayMap<KEY,T,tlt>::Iterator& i) {
+          outs << i.str(); //Use the same meaning as the debugging .str() method
+          return outs;
+        }
+        friend Iterator SplayMap<KEY,T,tlt>::begin () const;
+        friend Iterator SplayMap<KEY,T,tlt>::end   () const;
+
+      private:
+        //If can_erase is false, the value has been removed from "it" (++ does nothing)
+        ArrayQueue<Entry>    it;                 //Queue for all associations (from begin); use it as iterator via dequeue
+        SplayMap<KEY,T,tlt>* ref_map;
+        int                  expected_mod_count;
+        bool                 can_erase = true;
+
+        //Called in friends begin/end
+        Iterator(SplayMap<KEY,T,tlt>* iterate_over, bool from_begin);
+    };
+
+
+    Iterator begin () const;
+    Iterator end   () const;
+
+
+  private:
+    class TN {
+      public:
+        TN ()                     : left(nullptr), right(nullptr){}
+        TN (const TN& tn)         : value(tn.value), left(tn.left), right(tn.right){}
+        TN (Entry v, TN* l = nullptr,
+                     TN* r = nullptr) : value(v), left(l), right(r){}
+
+        Entry value;
+        TN*   left;
+        TN*   right;
+    };
+
+  bool (*lt) (const KEY& a, const KEY& b); // The lt used for searching (from template or constructor)
+  mutable TN* map = nullptr;               //Splaying (even in const lookups) changes the root
+  int used      = 0;                       //Cache for number of key->value pairs in the tree
+  int mod_count = 0;                       //For sensing concurrent modification
+
+  //Helper methods
+  //A splay tree can degenerate into a path of length N (e.g., after keys are put
+  //  in increasing order), so every traversal of an existing tree here is
+  //  iterative, not recursive; only build_balanced recurses (O(Log N) deep)
+  void  splay               (const KEY& key)                         const; //Top-down: key's node (or last on its path) becomes root
+  bool  root_has            (const KEY& key)                         const; //Whether the root's key is key
+  TN*   build_balanced      (const std::vector<Entry>& entries,
+                             int low, int high)                      const; //Balanced tree of entries[low..high]
+  void  copy_to_vector      (TN* root, std::vector<Entry>& v)        const; //Append root's tree values (in order) to v
+  T     remove              (const KEY& key);                               //Remove key->value from the tree
+  void  delete_tree         (TN*& root);                                    //Deallocate all TN in tree; root == nullptr
+  std::string string_rotated(TN* root, std::string indent)           const; //Returns string representing root's tree
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//SplayMap class and related definitions
+
+//Destructor/Constructors
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+SplayMap<KEY,T,tlt>::~SplayMap() {
+    delete_tree(map);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+SplayMap<KEY,T,tlt>::SplayMap(bool (*clt)(const KEY& a, const KEY& b))
+: lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt) {
+    if (lt == (ltfunc)undefinedlt<KEY>)
+        throw TemplateFunctionError("SplayMap::default constructor: neither specified");
+    if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
+        throw TemplateFunctionError("SplayMap::default constructor: both specified and different");
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+SplayMap<KEY,T,tlt>::SplayMap(const SplayMap<KEY,T,tlt>& to_copy, bool (*clt)(const KEY& a, const KEY& b))
+: lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt) {
+    if (lt == (ltfunc)undefinedlt<KEY>)
+        lt = to_copy.lt;
+    if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
+        throw TemplateFunctionError("SplayMap::copy constructor: both specified and different");
+
+    if (lt != to_copy.lt) {
+        for (auto i : to_copy) {
+            put(i.first, i.second);
+        }
+    }
+    else {
+        //Copy into a balanced tree: the copy need not keep to_copy's shape
+        std::vector<Entry> entries;
+        entries.reserve(to_copy.used);
+        copy_to_vector(to_copy.map, entries);
+        used = to_copy.used;
+        map = build_balanced(entries, 0, used-1);
+    }
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+SplayMap<KEY,T,tlt>::SplayMap(const std::initializer_list<Entry>& il, bool (*clt)(const KEY& a, const KEY& b))
+: lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt) {
+    if (lt == (ltfunc)undefinedlt<KEY>)
+        throw TemplateFunctionError("SplayMap::initializer_list constructor: neither specified");
+    if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
+        throw TemplateFunctionError("SplayMap::initializer_list constructor: both specified and different");
+
+    for (auto i : il) {
+        put(i.first, i.second);
+    }
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+template <class Iterable>
+SplayMap<KEY,T,tlt>::SplayMap(const Iterable& i, bool (*clt)(const KEY& a, const KEY& b))
+: lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt) {
+    if (lt == (ltfunc)undefinedlt<KEY>)
+        throw TemplateFunctionError("SplayMap::Iterable constructor: neither specified");
+    if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
+        throw TemplateFunctionError("SplayMap::Iterable constructor: both specified and different");
+
+    for (auto j : i) {
+        put(j.first, j.second);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool SplayMap<KEY,T,tlt>::empty() const {
+    return used == 0;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+int SplayMap<KEY,T,tlt>::size() const {
+    return used;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool SplayMap<KEY,T,tlt>::has_key (const KEY& key) const {
+    splay(key);
+    return root_has(key);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool SplayMap<KEY,T,tlt>::has_value (const T& value) const {
+    for (auto i : *this)
+        if (i.second == value)
+            return true;
+    return false;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::string SplayMap<KEY,T,tlt>::str() const {
+    std::ostringstream outs;
+    outs << "splay_map[";
+    outs<< string_rotated(map,"\n") << "\n](used = " << used << ", mod_count = " << mod_count << ")";
+    return  outs.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+//After splaying, an absent key belongs between the root and one of its
+//  subtrees: the new node becomes the root, taking that subtree with it
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+T SplayMap<KEY,T,tlt>::put(const KEY& key, const T& value) {
+    mod_count++;
+    splay(key);
+    if (root_has(key)) {
+        T to_return = map->value.second;
+        map->value.second = value;
+        return to_return;
+    }
+
+    TN* n = new TN(Entry(key,value));
+    if (map != nullptr) {
+        if (lt(key, map->value.first)) {
+            n->left  = map->left;
+            n->right = map;
+            map->left = nullptr;
+        }else{
+            n->right = map->right;
+            n->left  = map;
+            map->right = nullptr;
+        }
+    }
+    map = n;
+    used++;
+    return value;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+T SplayMap<KEY,T,tlt>::erase(const KEY& key) {
+    auto to_return = remove(key);
+    mod_count++;
+    return to_return;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void SplayMap<KEY,T,tlt>::clear() {
+    used = 0;
+    mod_count++;
+    delete_tree(map);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+template<class Iterable>
+int SplayMap<KEY,T,tlt>::put_all(const Iterable& i) {
+    int count = 0;
+    for (auto m_entry : i) {
+        ++count;
+        put(m_entry.first, m_entry.second);
+    }
+
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+T& SplayMap<KEY,T,tlt>::operator [] (const KEY& key) {
+    splay(key);
+    if (!root_has(key)) {
+        put(key, T());
+    }
+    return map->value.second;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+const T& SplayMap<KEY,T,tlt>::operator [] (const KEY& key) const {
+    splay(key);
+    if (root_has(key)) {
+        return map->value.second;
+    } else {
+        std::ostringstream answer;
+        answer << "SplayMap::operator []: key(" << key << ") not in Map";
+        throw KeyError(answer.str());
+    }
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+SplayMap<KEY,T,tlt>& SplayMap<KEY,T,tlt>::operator = (const SplayMap<KEY,T,tlt>& rhs) {
+    if (this == &rhs)
+        return *this;
+
+    clear();
+    lt = rhs.lt;
+    std::vector<Entry> entries;
+    entries.reserve(rhs.used);
+    copy_to_vector(rhs.map, entries);
+    used = rhs.used;
+    map = build_balanced(entries, 0, used-1);
+    return *this;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool SplayMap<KEY,T,tlt>::operator == (const SplayMap<KEY,T,tlt>& rhs) const {
+    if (this == &rhs)
+        return true;
+    if (used != rhs.used)
+        return false;
+
+    for (auto i : *this)
+        if (!rhs.has_key(i.first) || !(rhs[i.first] == i.second))
+            return false;
+    return true;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool SplayMap<KEY,T,tlt>::operator != (const SplayMap<KEY,T,tlt>& rhs) const {
+    return !(*this == rhs);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::ostream& operator << (std::ostream& outs, const SplayMap<KEY,T,tlt>& m) {
+    outs << "map[";
+    int i = 0;
+    for(auto kv : m)
+    {
+        outs<<kv.first<<"->"<<kv.second;
+        i++;
+        if(m.size() > 1 && i < m.size())
+            outs<<", ";
+    }
+
+    outs<<"]";
+    return  outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto SplayMap<KEY,T,tlt>::begin () const -> SplayMap<KEY,T,tlt>::Iterator {
+    return Iterator(const_cast<SplayMap<KEY,T,tlt>*>(this), true);
+}
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto SplayMap<KEY,T,tlt>::end () const -> SplayMap<KEY,T,tlt>::Iterator {
+    return Iterator(const_cast<SplayMap<KEY,T,tlt>*>(this),false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+//Top-down splay (Sleator and Tarjan): walk down from the root two levels at a
+//  time, rotating on zig-zig steps, and hang the nodes passed over on a left
+//  tree (keys < key) and a right tree (keys > key). left_hook/right_hook are
+//  where the next node is attached in each. At the end, the node where the
+//  walk stopped becomes the root, with the two trees as its subtrees.
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void SplayMap<KEY,T,tlt>::splay (const KEY& key) const {
+    if (map == nullptr)
+        return;
+
+    TN*  left_root  = nullptr;
+    TN*  right_root = nullptr;
+    TN** left_hook  = &left_root;
+    TN** right_hook = &right_root;
+    TN*  t = map;
+    for (;;) {
+        if (lt(key, t->value.first)) {
+            if (t->left == nullptr)
+                break;
+            if (lt(key, t->left->value.first)) {   //zig-zig: rotate right
+                TN* l = t->left;
+                t->left = l->right;
+                l->right = t;
+                t = l;
+                if (t->left == nullptr)
+                    break;
+            }
+            *right_hook = t;                        //link right
+            right_hook = &t->left;
+            t = t->left;
+        }else if (lt(t->value.first, key)) {
+            if (t->right == nullptr)
+                break;
+            if (lt(t->right->value.first, key)) {  //zag-zag: rotate left
+                TN* r = t->right;
+                t->right = r->left;
+                r->left = t;
+                t = r;
+                if (t->right == nullptr)
+                    break;
+            }
+            *left_hook = t;                         //link left
+            left_hook = &t->right;
+            t = t->right;
+        }else
+            break;
+    }
+
+    *left_hook  = t->left;                          //assemble
+    *right_hook = t->right;
+    t->left  = left_root;
+    t->right = right_root;
+    map = t;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool SplayMap<KEY,T,tlt>::root_has (const KEY& key) const {
+    return map != nullptr && !lt(key, map->value.first) && !lt(map->value.first, key);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+typename SplayMap<KEY,T,tlt>::TN* SplayMap<KEY,T,tlt>::build_balanced (const std::vector<Entry>& entries, int low, int high) const {
+    if (low > high)
+        return nullptr;
+
+    int mid = low + (high - low) / 2;
+    return new TN(entries[mid], build_balanced(entries, low, mid-1), build_balanced(entries, mid+1, high));
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void SplayMap<KEY,T,tlt>::copy_to_vector (TN* root, std::vector<Entry>& v) const {
+    std::vector<TN*> path;
+    for (TN* c = root; c != nullptr || !path.empty(); ) {
+        if (c != nullptr) {
+            path.push_back(c);
+            c = c->left;
+        }else{
+            c = path.back();
+            path.pop_back();
+            v.push_back(c->value);
+            c = c->right;
+        }
+    }
+}
+
+
+//Splay key to the root and remove it; join its subtrees by splaying the
+//  (larger) key in the left subtree, which brings that subtree's maximum to
+//  its root, leaving an empty right child for the old right subtree
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+T SplayMap<KEY,T,tlt>::remove (const KEY& key) {
+    splay(key);
+    if (!root_has(key)) {
+        std::ostringstream answer;
+        answer << "SplayMap::erase: key(" << key << ") not in Map";
+        throw KeyError(answer.str());
+    }
+
+    TN* to_delete = map;
+    T to_return = to_delete->value.second;
+    if (to_delete->left == nullptr)
+        map = to_delete->right;
+    else {
+        map = to_delete->left;
+        splay(key);
+        map->right = to_delete->right;
+    }
+    delete to_delete;
+    --used;
+    return to_return;
+}
+
+
+//Rotate left children up until there are none at the root, then delete it
+//  and continue with its right subtree: O(N) with no recursion
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void SplayMap<KEY,T,tlt>::delete_tree (TN*& root) {
+    while (root != nullptr) {
+        if (root->left != nullptr) {
+            TN* l = root->left;
+            root->left = l->right;
+            l->right = root;
+            root = l;
+        }else{
+            TN* to_delete = root;
+            root = root->right;
+            delete to_delete;
+        }
+    }
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::string SplayMap<KEY,T,tlt>::string_rotated(TN* root, std::string indent) const {
+    //Reverse in-order (right subtree, root, left subtree), with each node's
+    //  depth on the stack to indent it
+    std::ostringstream rotated;
+    std::vector<std::pair<TN*,std::string>> path;
+    for (TN* c = root; c != nullptr || !path.empty(); ) {
+        if (c != nullptr) {
+            path.push_back(std::make_pair(c, indent));
+            c = c->right;
+            indent += "..";
+        }else{
+            c      = path.back().first;
+            indent = path.back().second;
+            path.pop_back();
+            rotated << indent << c->value.first << "->" << c->value.second;
+            c = c->left;
+            indent += "..";
+        }
+    }
+    return rotated.str();
+}
+
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+SplayMap<KEY,T,tlt>::Iterator::Iterator(SplayMap<KEY,T,tlt>* iterate_over, bool from_begin)
+: ref_map(iterate_over), expected_mod_count(ref_map->mod_count) {
+    if (from_begin) {
+        std::vector<Entry> entries;
+        entries.reserve(ref_map->used);
+        ref_map->copy_to_vector(ref_map->map, entries);
+        for (const Entry& e : entries)
+            it.enqueue(e);
+    }
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+SplayMap<KEY,T,tlt>::Iterator::~Iterator()
+{}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto SplayMap<KEY,T,tlt>::Iterator::erase() -> Entry {
+    if (expected_mod_count != ref_map->mod_count)
+        throw ConcurrentModificationError("SplayMap::Iterator::erase");
+    if (!can_erase)
+        throw CannotEraseError("SplayMap::Iterator::erase Iterator cursor already erased");
+    if (it.empty())
+        throw CannotEraseError("SplayMap::Iterator::erase Iterator cursor beyond data structure");
+
+    can_erase = false;
+    Entry to_return = it.dequeue();
+    ref_map->remove(to_return.first);
+    expected_mod_count = ref_map->mod_count;
+    return to_return;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::string SplayMap<KEY,T,tlt>::Iterator::str() const {
+    std::ostringstream answer;
+    answer << it.str() << ",expected_mod_count=" << expected_mod_count << ",can_erase=" << can_erase << ")";
+    return answer.str();
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto  SplayMap<KEY,T,tlt>::Iterator::operator ++ () -> SplayMap<KEY,T,tlt>::Iterator& {
+    if (expected_mod_count != ref_map->mod_count)
+        throw ConcurrentModificationError("SplayMap::Iterator::operator ++");
+
+    if (it.size() == 0)
+        return *this;
+
+    if (can_erase)
+        it.dequeue();
+    else
+        can_erase = true;
+
+    return *this;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto SplayMap<KEY,T,tlt>::Iterator::operator ++ (int) -> SplayMap<KEY,T,tlt>::Iterator {
+    if (expected_mod_count != ref_map->mod_count)
+        throw ConcurrentModificationError("SplayMap::Iterator::operator ++(int)");
+
+    if (it.size() == 0)
+        return *this;
+
+    Iterator to_return(*this);
+    if (can_erase)
+        it.dequeue();
+    else
+        can_erase = true;
+
+    return to_return;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool SplayMap<KEY,T,tlt>::Iterator::operator == (const SplayMap<KEY,T,tlt>::Iterator& rhs) const {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+        throw IteratorTypeError("SplayMap::Iterator::operator ==");
+    if (expected_mod_count != ref_map->mod_count)
+        throw ConcurrentModificationError("SplayMap::Iterator::operator ==");
+    if (ref_map != rhsASI->ref_map)
+        throw ComparingDifferentIteratorsError("SplayMap::Iterator::operator ==");
+
+    return it.size() == rhsASI->it.size();
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool SplayMap<KEY,T,tlt>::Iterator::operator != (const SplayMap<KEY,T,tlt>::Iterator& rhs) const {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+        throw IteratorTypeError("SplayMap::Iterator::operator !=");
+    if (expected_mod_count != ref_map->mod_count)
+        throw ConcurrentModificationError("SplayMap::Iterator::operator !=");
+    if (ref_map != rhsASI->ref_map)
+        throw ComparingDifferentIteratorsError("SplayMap::Iterator::operator !=");
+
+    return it.size() != rhsASI->it.size();
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+pair<KEY,T>& SplayMap<KEY,T,tlt>::Iterator::operator *() const {
+    if (expected_mod_count != ref_map->mod_count)
+        throw ConcurrentModificationError("SplayMap::Iterator::operator *");
+    if (!can_erase || it.size() == 0) {
+        std::ostringstream where;
+        where << it << " when size = " << ref_map->size();
+        throw IteratorPositionIllegal("SplayMap::Iterator::operator * Iterator illegal: "+where.str());
+    }
+
+    return it.peek();
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+pair<KEY,T>* SplayMap<KEY,T,tlt>::Iterator::operator ->() const {
+    if (expected_mod_count != ref_map->mod_count)
+        throw ConcurrentModificationError("SplayMap::Iterator::operator ->");
+    if (!can_erase || it.size() == 0) {
+        std::ostringstream where;
+        where << it << " when size = " << ref_map->size();
+        throw IteratorPositionIllegal("SplayMap::Iterator::operator -> Iterator illegal: "+where.str());
+    }
+
+    return &(it.peek());
+}
+
+
+}
+
+#endif /* SPLAY_MAP_HPP_ */
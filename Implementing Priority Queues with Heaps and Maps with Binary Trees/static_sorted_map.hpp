@@ -0,0 +1,488 @@
+#ifndef STATIC_SORTED_MAP_HPP_
+#define STATIC_SORTED_MAP_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <algorithm>         //For std::stable_sort
+#include <initializer_list>
+#include "ics_exceptions.hpp"
+#include "pair.hpp"
+
+
+namespace ics {
+
+
+#ifndef undefinedltdefined
+#define undefinedltdefined
+template<class T>
+bool undefinedlt (const T& a, const T& b) {return false;}
+#endif /* undefinedltdefined */
+
+//A StaticSortedMap is an immutable map for data that is built once and then
+//  searched many times. Keys are stored in Eytzinger (BFS) order in one
+//  contiguous array: the children of index k are at 2k and 2k+1 (index 0 is
+//  unused), so the first levels of every search share the same few cache
+//  lines. The search loop has no data-dependent branch (k = 2k + (key[k] < key))
+//  and prefetches the cache line holding k's descendants four levels down.
+//  Values are kept in a parallel array, touched only after a key is found.
+//Build one from any Iterable of pairs (e.g., BSTMap::freeze or an ArrayMap):
+//  O(N) if the keys are already in increasing order, else O(N Log N);
+//  for duplicate keys the last value wins.
+//
+//Instantiate the templated class supplying tlt(a,b): true, iff a is less than b.
+//If tlt is defaulted to undefinedlt in the template, then a constructor must supply clt.
+//If both tlt and clt are supplied, then they must be the same (by ==) function.
+//If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
+//The (unique) non-undefinedlt value supplied by tlt/clt is stored in the instance variable lt.
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedlt<KEY>> class StaticSortedMap {
+  public:
+    typedef pair<KEY,T> Entry;
+    typedef bool (*ltfunc) (const KEY& a, const KEY& b);
+
+    //Destructor/Constructors
+    ~StaticSortedMap();
+
+    StaticSortedMap          (bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+    StaticSortedMap          (const StaticSortedMap<KEY,T,tlt>& to_copy);
+    explicit StaticSortedMap (const std::initializer_list<Entry>& il, bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit StaticSortedMap (const Iterable& i, bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+
+
+    //Queries
+    bool empty      () const;
+    int  size       () const;
+    bool has_key    (const KEY& key) const;
+    bool has_value  (const T& value) const;
+    const T* find   (const KEY& key) const;   //Pointer to key's value, or nullptr (one search)
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+
+    //Operators
+
+    const T& operator [] (const KEY&) const;
+    StaticSortedMap<KEY,T,tlt>& operator = (const StaticSortedMap<KEY,T,tlt>& rhs);
+    bool operator == (const StaticSortedMap<KEY,T,tlt>& rhs) const;
+    bool operator != (const StaticSortedMap<KEY,T,tlt>& rhs) const;
+
+    template<class KEY2,class T2, bool (*lt2)(const KEY2& a, const KEY2& b)>
+    friend std::ostream& operator << (std::ostream& outs, const StaticSortedMap<KEY2,T2,lt2>& m);
+
+
+
+    //An Iterator visits the entries in increasing key order by moving to the
+    //  in-order successor in the implicit tree: no queue is built. Keys and
+    //  values are stored apart, so * returns an Entry by value (no ->).
+    class Iterator {
+      public:
+        //Private constructor called in begin/end, which are friends of StaticSortedMap<T>
+        ~Iterator();
+        std::string str  () const;
+        StaticSortedMap<KEY,T,tlt>::Iterator& operator ++ ();
+        StaticSortedMap<KEY,T,tlt>::Iterator  operator ++ (int);
+        bool operator == (const StaticSortedMap<KEY,T,tlt>::Iterator& rhs) const;
+        bool operator != (const StaticSortedMap<KEY,T,tlt>::Iterator& rhs) const;
+        Entry operator *  () const;
+        friend std::ostream& operator << (std::ostream& outs, const StaticSortedMap<KEY,T,tlt>::Iterator& i) {
+          outs << i.str(); //Use the same meaning as the debugging .str() method
+          return outs;
+        }
+        friend Iterator StaticSortedMap<KEY,T,tlt>::begin () const;
+        friend Iterator StaticSortedMap<KEY,T,tlt>::end   () const;
+
+      private:
+        int                               current;   //Eytzinger index; 0 means beyond the last entry
+        const StaticSortedMap<KEY,T,tlt>* ref_map;
+
+        //Called in friends begin/end
+        Iterator(const StaticSortedMap<KEY,T,tlt>* iterate_over, int initial);
+    };
+
+
+    Iterator begin () const;
+    Iterator end   () const;
+
+
+  private:
+    bool (*lt) (const KEY& a, const KEY& b); // The lt used for searching (from template or constructor)
+    std::vector<KEY> keys;                   //keys[1..used] in Eytzinger order; keys[0] unused
+    std::vector<T>   values;                 //values[k] is associated with keys[k]
+    int used = 0;                            //Cache for number of key->value pairs in the map
+
+    //Helper methods
+    int  lower_bound_index (const KEY& key)                           const; //Index of first key >= key, or 0
+    void sort_unique       (std::vector<Entry>& entries)              const; //Sort by key; last duplicate wins
+    void build_from        (std::vector<Entry>& entries);                    //Fill keys/values from entries
+    void fill              (const std::vector<Entry>& entries, int& i, int k);  //In-order fill of subtree k
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//StaticSortedMap class and related definitions
+
+//Destructor/Constructors
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+StaticSortedMap<KEY,T,tlt>::~StaticSortedMap() {
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+StaticSortedMap<KEY,T,tlt>::StaticSortedMap(bool (*clt)(const KEY& a, const KEY& b))
+: lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt) {
+    if (lt == (ltfunc)undefinedlt<KEY>)
+        throw TemplateFunctionError("StaticSortedMap::default constructor: neither specified");
+    if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
+        throw TemplateFunctionError("StaticSortedMap::default constructor: both specified and different");
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+StaticSortedMap<KEY,T,tlt>::StaticSortedMap(const StaticSortedMap<KEY,T,tlt>& to_copy)
+: lt(to_copy.lt), keys(to_copy.keys), values(to_copy.values), used(to_copy.used)
+{}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+StaticSortedMap<KEY,T,tlt>::StaticSortedMap(const std::initializer_list<Entry>& il, bool (*clt)(const KEY& a, const KEY& b))
+: lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt) {
+    if (lt == (ltfunc)undefinedlt<KEY>)
+        throw TemplateFunctionError("StaticSortedMap::initializer_list constructor: neither specified");
+    if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
+        throw TemplateFunctionError("StaticSortedMap::initializer_list constructor: both specified and different");
+
+    std::vector<Entry> entries(il.begin(), il.end());
+    build_from(entries);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+template <class Iterable>
+StaticSortedMap<KEY,T,tlt>::StaticSortedMap(const Iterable& i, bool (*clt)(const KEY& a, const KEY& b))
+: lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt) {
+    if (lt == (ltfunc)undefinedlt<KEY>)
+        throw TemplateFunctionError("StaticSortedMap::Iterable constructor: neither specified");
+    if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
+        throw TemplateFunctionError("StaticSortedMap::Iterable constructor: both specified and different");
+
+    std::vector<Entry> entries;
+    for (auto j : i) {
+        entries.push_back(Entry(j.first, j.second));
+    }
+    build_from(entries);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool StaticSortedMap<KEY,T,tlt>::empty() const {
+    return used == 0;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+int StaticSortedMap<KEY,T,tlt>::size() const {
+    return used;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool StaticSortedMap<KEY,T,tlt>::has_key (const KEY& key) const {
+    return find(key) != nullptr;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool StaticSortedMap<KEY,T,tlt>::has_value (const T& value) const {
+    for (int k = 1; k <= used; ++k)
+        if (values[k] == value)
+            return true;
+    return false;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+const T* StaticSortedMap<KEY,T,tlt>::find (const KEY& key) const {
+    int k = lower_bound_index(key);
+    if (k == 0 || lt(key, keys[k]))
+        return nullptr;
+    return &values[k];
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::string StaticSortedMap<KEY,T,tlt>::str() const {
+    std::ostringstream outs;
+    outs << "static_sorted_map[";
+    for (int k = 1; k <= used; ++k)
+        outs << (k == 1 ? "" : ",") << k << ":" << keys[k] << "->" << values[k];
+    outs << "](used = " << used << ")";
+    return  outs.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+const T& StaticSortedMap<KEY,T,tlt>::operator [] (const KEY& key) const {
+    const T* v = find(key);
+    if (v == nullptr) {
+        std::ostringstream answer;
+        answer << "StaticSortedMap::operator []: key(" << key << ") not in Map";
+        throw KeyError(answer.str());
+    }
+    return *v;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+StaticSortedMap<KEY,T,tlt>& StaticSortedMap<KEY,T,tlt>::operator = (const StaticSortedMap<KEY,T,tlt>& rhs) {
+    if (this == &rhs)
+        return *this;
+
+    lt     = rhs.lt;
+    keys   = rhs.keys;
+    values = rhs.values;
+    used   = rhs.used;
+    return *this;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool StaticSortedMap<KEY,T,tlt>::operator == (const StaticSortedMap<KEY,T,tlt>& rhs) const {
+    if (this == &rhs)
+        return true;
+    if (used != rhs.used)
+        return false;
+
+    for (int k = 1; k <= used; ++k) {
+        const T* v = rhs.find(keys[k]);
+        if (v == nullptr || !(*v == values[k]))
+            return false;
+    }
+    return true;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool StaticSortedMap<KEY,T,tlt>::operator != (const StaticSortedMap<KEY,T,tlt>& rhs) const {
+    return !(*this == rhs);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::ostream& operator << (std::ostream& outs, const StaticSortedMap<KEY,T,tlt>& m) {
+    outs << "map[";
+    int i = 0;
+    for(const auto& kv : m)
+    {
+        outs<<kv.first<<"->"<<kv.second;
+        i++;
+        if(m.size() > 1 && i < m.size())
+            outs<<", ";
+    }
+
+    outs<<"]";
+    return  outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+//The smallest key is at the end of the leftmost path from the root
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto StaticSortedMap<KEY,T,tlt>::begin () const -> StaticSortedMap<KEY,T,tlt>::Iterator {
+    int k = (used == 0 ? 0 : 1);
+    while (k != 0 && 2*k <= used)
+        k = 2*k;
+    return Iterator(this, k);
+}
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto StaticSortedMap<KEY,T,tlt>::end () const -> StaticSortedMap<KEY,T,tlt>::Iterator {
+    return Iterator(this, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+//Descend to a leaf, going right exactly when keys[k] < key; the path taken
+//  (the bits of k) ends with a 0 at the last left turn, which is at the first
+//  key >= key: shifting off the trailing 1s and that 0 recovers its index.
+//  Bounding the loop by used (not by comparisons) makes its trip count
+//  Log2(used)+1 (rounded down) or one more: the same for every key when the
+//  tree is perfect (used is 2^h-1), otherwise one more for keys whose path
+//  reaches the partial bottom level. The comparison only picks the next k, so
+//  the loop has at most one data-dependent branch (its last test).
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+int StaticSortedMap<KEY,T,tlt>::lower_bound_index (const KEY& key) const {
+    const KEY* base = keys.data();
+    unsigned k = 1;
+    while (k <= unsigned(used)) {
+#ifdef __GNUC__
+        //The 16 descendants of k four levels down are contiguous from 16k
+        if (16*k <= unsigned(used))
+            __builtin_prefetch(base + 16*k);
+#endif
+        k = 2*k + lt(base[k], key);
+    }
+#ifdef __GNUC__
+    k >>= __builtin_ffs(~k);
+#else
+    while (k & 1)
+        k >>= 1;
+    k >>= 1;
+#endif
+    return k;
+}
+
+
+//Already strictly increasing input (e.g., from a BSTMap) is left alone: O(N);
+//  otherwise a stable sort keeps duplicate keys in input order, so keeping the
+//  last of each run matches what calling put for each would do
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void StaticSortedMap<KEY,T,tlt>::sort_unique (std::vector<Entry>& entries) const {
+    bool increasing = true;
+    for (int i = 1; i < int(entries.size()) && increasing; ++i)
+        increasing = lt(entries[i-1].first, entries[i].first);
+    if (increasing)
+        return;
+
+    ltfunc key_lt = lt;
+    std::stable_sort(entries.begin(), entries.end(),
+                     [key_lt] (const Entry& a, const Entry& b) {return key_lt(a.first, b.first);});
+    int kept = 0;
+    for (int i = 0; i < int(entries.size()); ++i)
+        if (kept > 0 && !lt(entries[kept-1].first, entries[i].first))
+            entries[kept-1] = entries[i];
+        else
+            entries[kept++] = entries[i];
+    entries.erase(entries.begin()+kept, entries.end());
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void StaticSortedMap<KEY,T,tlt>::build_from (std::vector<Entry>& entries) {
+    sort_unique(entries);
+    used = entries.size();
+    keys.resize(used+1);
+    values.resize(used+1);
+    int i = 0;
+    fill(entries, i, 1);
+}
+
+
+//An in-order walk of the implicit tree visits the indexes in key order
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void StaticSortedMap<KEY,T,tlt>::fill (const std::vector<Entry>& entries, int& i, int k) {
+    if (k > used)
+        return;
+    fill(entries, i, 2*k);
+    keys[k]   = entries[i].first;
+    values[k] = entries[i].second;
+    ++i;
+    fill(entries, i, 2*k+1);
+}
+
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+StaticSortedMap<KEY,T,tlt>::Iterator::Iterator(const StaticSortedMap<KEY,T,tlt>* iterate_over, int initial)
+: current(initial), ref_map(iterate_over) {
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+StaticSortedMap<KEY,T,tlt>::Iterator::~Iterator() {
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::string StaticSortedMap<KEY,T,tlt>::Iterator::str() const {
+    std::ostringstream answer;
+    answer << "StaticSortedMap::Iterator(current=" << current << ")";
+    return answer.str();
+}
+
+
+//Successor: the leftmost index in the right subtree if there is one; else
+//  climb while k is a right child, and then once more
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto  StaticSortedMap<KEY,T,tlt>::Iterator::operator ++ () -> StaticSortedMap<KEY,T,tlt>::Iterator& {
+    if (current == 0)
+        return *this;
+
+    if (2*current+1 <= ref_map->used) {
+        current = 2*current+1;
+        while (2*current <= ref_map->used)
+            current = 2*current;
+    }else{
+        while (current & 1)
+            current >>= 1;
+        current >>= 1;
+    }
+    return *this;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto StaticSortedMap<KEY,T,tlt>::Iterator::operator ++ (int) -> StaticSortedMap<KEY,T,tlt>::Iterator {
+    Iterator to_return(*this);
+    ++(*this);
+    return to_return;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool StaticSortedMap<KEY,T,tlt>::Iterator::operator == (const StaticSortedMap<KEY,T,tlt>::Iterator& rhs) const {
+    if (ref_map != rhs.ref_map)
+        throw ComparingDifferentIteratorsError("StaticSortedMap::Iterator::operator ==");
+
+    return current == rhs.current;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool StaticSortedMap<KEY,T,tlt>::Iterator::operator != (const StaticSortedMap<KEY,T,tlt>::Iterator& rhs) const {
+    return !(*this == rhs);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto StaticSortedMap<KEY,T,tlt>::Iterator::operator *() const -> Entry {
+    if (current == 0) {
+        std::ostringstream where;
+        where << str() << " when size = " << ref_map->size();
+        throw IteratorPositionIllegal("StaticSortedMap::Iterator::operator * Iterator illegal: "+where.str());
+    }
+
+    return Entry(ref_map->keys[current], ref_map->values[current]);
+}
+
+
+}
+
+#endif /* STATIC_SORTED_MAP_HPP_ */
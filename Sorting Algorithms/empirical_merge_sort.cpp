@@ -0,0 +1,103 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include "ics46goody.hpp"
+#include "stopwatch.hpp"
+#include "q6solution.hpp"
+#include "merge_sort.hpp"
+
+
+//Time sorting length ints, in several orders, with std::stable_sort, with a
+//  top-down merge sort calling q6solution.hpp's merge (one MergeSorter, so
+//  one buffer allocation, per merge), and with adaptive_merge_sort (natural
+//  runs, one reusable buffer, galloping). Every answer is checked against
+//  std::stable_sort's. Orders:
+//  random        : random values
+//  sorted        : ascending
+//  reversed      : descending
+//  nearly sorted : ascending, then percent_swapped% of values swapped with
+//                    a random other value
+//  sorted blocks : 16 ascending blocks of random values, one after another
+//  few values    : random values in [0,10)
+
+template<class T>
+void top_down_merge_sort(T a[], int low, int high) {
+  if (low >= high)
+    return;
+  int middle = (low + high) / 2;
+  top_down_merge_sort(a, low, middle);
+  top_down_merge_sort(a, middle+1, high);
+  merge(a, low, middle, middle+1, high);
+}
+
+
+void compare(const std::string& title, const std::vector<int>& values) {
+  std::vector<int> expected(values);
+  ics::Stopwatch watch;
+  watch.start();
+  std::stable_sort(expected.begin(), expected.end());
+  watch.stop();
+  std::cout << title << std::endl;
+  std::cout << "  std::stable_sort     : time = " << watch.read() << std::endl;
+
+  std::vector<int> a(values);
+  watch.reset();
+  watch.start();
+  top_down_merge_sort(a.data(), 0, a.size()-1);
+  watch.stop();
+  std::cout << "  top-down with merge  : time = " << watch.read() << (a == expected ? "" : " NOT SORTED") << std::endl;
+
+  a = values;
+  ics::MergeSorter<int*> sorter;
+  watch.reset();
+  watch.start();
+  sorter.sort(a.data(), a.data() + a.size());
+  watch.stop();
+  std::cout << "  adaptive_merge_sort  : time = " << watch.read() << " (" << sorter.natural_runs() << " natural runs)"
+            << (a == expected ? "" : " NOT SORTED") << std::endl;
+}
+
+
+int main() {
+  try {
+    int length          = ics::prompt_int("Enter number of values to sort",1000000);
+    int percent_swapped = ics::prompt_int("Enter percent of values swapped in nearly sorted",1);
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<int> value_distribution(0,1000000000);
+    std::uniform_int_distribution<int> index_distribution(0,length-1);
+    std::uniform_int_distribution<int> digit_distribution(0,9);
+
+    std::vector<int> values(length);
+    for (int& v : values)
+      v = value_distribution(generator);
+    compare("random", values);
+
+    std::sort(values.begin(), values.end());
+    compare("sorted", values);
+
+    std::reverse(values.begin(), values.end());
+    compare("reversed", values);
+
+    std::reverse(values.begin(), values.end());
+    for (int i=0; i<length/100*percent_swapped; ++i)
+      std::swap(values[index_distribution(generator)], values[index_distribution(generator)]);
+    compare("nearly sorted", values);
+
+    for (int& v : values)
+      v = value_distribution(generator);
+    for (int b=0; b<16; ++b)
+      std::sort(values.begin() + long(length)*b/16, values.begin() + long(length)*(b+1)/16);
+    compare("sorted blocks", values);
+
+    for (int& v : values)
+      v = digit_distribution(generator);
+    compare("few values", values);
+  } catch (ics::IcsError& e) {
+    std::cout << "  " << e.what() << std::endl;
+  }
+
+  return 0;
+}
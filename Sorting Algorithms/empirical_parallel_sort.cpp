@@ -0,0 +1,109 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include "ics46goody.hpp"
+#include "stopwatch.hpp"
+#include "ics_exceptions.hpp"
+#include "parallel_sort.hpp"
+
+
+//Time parallel_quicksort, parallel_merge_sort, and parallel_radix_sort on
+//  length random ints (10^8 by default: with the copy being sorted and the
+//  buffers, about 1.2GB) with a WorkStealingPool of 1, 2, 4, ... up to
+//  max_threads threads, reporting each time, its speedup over the same sort
+//  with 1 thread, and the number of tasks stolen. std::sort (1 thread) is
+//  timed first as the baseline, and its answer checks every other answer.
+//Finally each sort is called from inside tasks of the pool it runs on (one
+//  sort of a quarter of the values per parallel_for index), which must
+//  neither deadlock nor give a different answer.
+//Compile with -O2 -pthread; speedups are limited by the cores actually
+//  available (and by memory bandwidth, for radix sort).
+
+int main() {
+  try {
+    int length      = ics::prompt_int("Enter number of values to sort",100000000);
+    int hardware    = std::max(1, int(std::thread::hardware_concurrency()));
+    int max_threads = ics::prompt_int("Enter maximum number of threads",hardware);
+    int cutoff      = ics::prompt_int("Enter sequential cutoff (0 for each sort's default)",0);
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<int> value_distribution(0,1000000000);
+    std::vector<int> values(length);
+    for (int& v : values)
+      v = value_distribution(generator);
+
+    std::vector<int> expected(values);
+    ics::Stopwatch watch;
+    watch.start();
+    std::sort(expected.begin(), expected.end());
+    watch.stop();
+    std::cout << length << " values: std::sort time = " << watch.read() << std::endl;
+
+    std::vector<int> thread_counts;
+    for (int threads=1; threads<max_threads; threads *= 2)
+      thread_counts.push_back(threads);
+    thread_counts.push_back(max_threads);
+
+    const char* names[] = {"parallel_quicksort ", "parallel_merge_sort", "parallel_radix_sort"};
+    std::vector<int> a;
+    for (int s=0; s<3; ++s) {
+      double one_thread = 0;
+      for (int threads : thread_counts) {
+        ics::WorkStealingPool pool(threads);
+        a = values;
+        watch.reset();
+        watch.start();
+        if (s == 0)
+          ics::parallel_quicksort(a.data(), length, pool, cutoff > 0 ? cutoff : 1 << 14);
+        else if (s == 1)
+          ics::parallel_merge_sort(a.data(), length, pool, std::less<int>(), cutoff > 0 ? cutoff : 1 << 14);
+        else
+          ics::parallel_radix_sort(a.data(), length, pool, ics::RadixIdentity(), cutoff > 0 ? cutoff : 1 << 16);
+        watch.stop();
+        if (threads == 1)
+          one_thread = watch.read();
+        std::cout << "  " << names[s] << " " << threads << " threads: time = " << watch.read()
+                  << ", speedup = " << one_thread/watch.read() << ", steals = " << pool.steals()
+                  << (a == expected ? "" : " NOT SORTED") << std::endl;
+      }
+    }
+
+    ics::WorkStealingPool pool(max_threads);
+    int part = length / 4;
+    for (int s=0; s<3; ++s) {
+      a = values;
+      watch.reset();
+      watch.start();
+      pool.run([&] () {
+        pool.parallel_for(4, [&] (int i) {
+          int* first = a.data() + i*part;
+          int  count = (i == 3 ? length - 3*part : part);
+          if (s == 0)
+            ics::parallel_quicksort(first, count, pool, cutoff > 0 ? cutoff : 1 << 14);
+          else if (s == 1)
+            ics::parallel_merge_sort(first, count, pool, std::less<int>(), cutoff > 0 ? cutoff : 1 << 14);
+          else
+            ics::parallel_radix_sort(first, count, pool, ics::RadixIdentity(), cutoff > 0 ? cutoff : 1 << 16);
+        });
+      });
+      watch.stop();
+      bool sorted = true;
+      for (int i=0; i<4; ++i) {
+        int* first = a.data() + i*part;
+        int* last  = (i == 3 ? a.data() + length : first + part);
+        std::vector<int> expected_part(values.begin() + (first - a.data()), values.begin() + (last - a.data()));
+        std::sort(expected_part.begin(), expected_part.end());
+        sorted = sorted && std::equal(first, last, expected_part.begin());
+      }
+      std::cout << "  " << names[s] << " nested in 4 tasks, " << max_threads << " threads: time = " << watch.read()
+                << (sorted ? "" : " NOT SORTED") << std::endl;
+    }
+  } catch (ics::IcsError& e) {
+    std::cout << "  " << e.what() << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,118 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <limits>
+#include <type_traits>
+#include "ics46goody.hpp"
+#include "stopwatch.hpp"
+#include "q6solution.hpp"
+#include "radix_sort.hpp"
+
+
+//Time sorting length random values with std::sort (std::stable_sort for
+//  records, as radix sorts are stable) and ics::radix_sort (which chooses lsd
+//  or msd), and also RadixSorter's lsd and msd separately; for ints in
+//  [0,10^6) also time the 6-pass decimal radix_sort from q6solution.hpp,
+//  which handles only those values. Every answer is checked against std::sort's.
+
+struct Record {
+  std::string name;
+  long long   key;
+};
+
+
+template<class T>
+bool same(const std::vector<T>& a, const std::vector<T>& b) {
+  return a == b;
+}
+
+bool same(const std::vector<Record>& a, const std::vector<Record>& b) {
+  for (int i=0; i<int(a.size()); ++i)
+    if (a[i].key != b[i].key || a[i].name != b[i].name)
+      return false;
+  return true;
+}
+
+
+//Returns std::sort's answer, for checking other sorts
+template<class T, class KeyOf>
+std::vector<T> compare(const std::string& title, const std::vector<T>& values, KeyOf key) {
+  std::cout << title << " (" << values.size() << " values)" << std::endl;
+  std::vector<T> expected(values);
+  ics::Stopwatch watch;
+  watch.start();
+  if (std::is_arithmetic<T>::value)
+    std::sort(expected.begin(), expected.end(), [&key] (const T& a, const T& b) {return key(a) < key(b);});
+  else
+    std::stable_sort(expected.begin(), expected.end(), [&key] (const T& a, const T& b) {return key(a) < key(b);});
+  watch.stop();
+  std::cout << (std::is_arithmetic<T>::value ? "  std::sort         : time = " : "  std::stable_sort  : time = ")
+            << watch.read() << std::endl;
+
+  const char* names[] = {"ics::radix_sort   ", "RadixSorter::lsd  ", "RadixSorter::msd  "};
+  for (int m=0; m<3; ++m) {
+    std::vector<T> a(values);
+    int passes = -1;
+    watch.reset();
+    watch.start();
+    if (m == 0)
+      ics::radix_sort(a.data(), a.size(), key);
+    else {
+      ics::RadixSorter<T,KeyOf> sorter(a.data(), a.size(), key);
+      passes = sorter.active_bytes();
+      if (m == 1)
+        sorter.lsd();
+      else
+        sorter.msd();
+    }
+    watch.stop();
+    std::cout << "  " << names[m] << ": time = " << watch.read();
+    if (m == 1)
+      std::cout << " (" << passes << " passes)";
+    std::cout << (same(a, expected) ? "" : " NOT SORTED") << std::endl;
+  }
+  return expected;
+}
+
+
+int main() {
+  try {
+    int length = ics::prompt_int("Enter number of values to sort",1000000);
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<int>       decimal_distribution(0,999999);
+    std::uniform_int_distribution<int>       int_distribution(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+    std::uniform_int_distribution<long long> long_distribution(std::numeric_limits<long long>::min(), std::numeric_limits<long long>::max());
+    std::normal_distribution<double>         double_distribution(0.0, 1000.0);
+    ics::RadixIdentity identity;
+
+    std::vector<int> decimals(length), ints(length);
+    std::vector<long long> longs(length);
+    std::vector<double> doubles(length);
+    std::vector<Record> records(length);
+    for (int i=0; i<length; ++i) {
+      decimals[i] = decimal_distribution(generator);
+      ints[i]     = int_distribution(generator);
+      longs[i]    = long_distribution(generator);
+      doubles[i]  = double_distribution(generator);
+      records[i]  = Record{std::to_string(i), long_distribution(generator) % 1000};
+    }
+
+    std::vector<int> expected = compare("ints in [0,10^6)", decimals, identity);
+    ics::Stopwatch watch;
+    watch.start();
+    radix_sort(decimals.data(), length);
+    watch.stop();
+    std::cout << "  q6 radix_sort     : time = " << watch.read() << (decimals == expected ? "" : " NOT SORTED") << std::endl;
+    compare("ints", ints, identity);
+    compare("long longs", longs, identity);
+    compare("doubles", doubles, identity);
+    compare("records by key in (-1000,1000)", records, [] (const Record& r) {return r.key;});
+  } catch (ics::IcsError& e) {
+    std::cout << "  " << e.what() << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,369 @@
+#ifndef MERGE_SORT_HPP_
+#define MERGE_SORT_HPP_
+
+#include <vector>
+#include <iterator>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+
+namespace ics {
+
+
+//A MergeSorter sorts (stably) any random-access range, adapting to the order
+//  already in it: a nearly sorted range sorts in close to linear time.
+//sort scans the range left to right for natural runs: a non-descending run,
+//  or a strictly descending run (which is reversed in place; strictly, so
+//  reversing keeps equal values in order). A run shorter than min_run (32 to
+//  64, chosen so the number of runs is a power of 2 or just below one) is
+//  extended by binary insertion sort. Runs are kept on a stack and merged
+//  while the lengths on its top break the invariants that keep merges
+//  balanced (the corrected Timsort rules), so there are O(log N) runs pending.
+//merge merges two adjacent sorted ranges: it first skips the prefix of the
+//  left range and the suffix of the right range that are already in place
+//  (binary searches), then moves the shorter of what remains into buffer and
+//  merges from the ends inward. When one side supplies min_gallop values in a
+//  row, it gallops: an exponential then binary search finds how many more
+//  values that side supplies and moves them as a block.
+//The buffer is kept between merges (and sorts), so sorting N values allocates
+//  at most N/2 values' space once, instead of once for every merge.
+template<class Iterator, class Compare = std::less<typename std::iterator_traits<Iterator>::value_type>>
+class MergeSorter {
+  public:
+    typedef typename std::iterator_traits<Iterator>::value_type T;
+    enum {min_merge = 64, min_gallop = 7};
+
+    explicit MergeSorter(Compare less = Compare());
+
+    void sort         (Iterator first, Iterator last);
+    void merge        (Iterator first, Iterator middle, Iterator last);
+    int  natural_runs () const;           //Runs found by the last sort, before extending
+
+  private:
+    struct Run {
+      int start;
+      int length;
+    };
+
+    Compare          less;
+    std::vector<T>   buffer;
+    std::vector<Run> runs;
+    Iterator         base;                //first in the current sort
+    int              natural = 0;
+
+    //Helper methods
+    static int min_run     (int n);
+    int        run_end     (Iterator first, int low, int n);
+    void       insertion_sort(Iterator first, Iterator sorted_end, Iterator last);
+    void       collapse    ();
+    void       force_collapse();
+    void       merge_at    (int i);
+    void       merge_low   (Iterator first, Iterator middle, Iterator last);
+    void       merge_high  (Iterator first, Iterator middle, Iterator last);
+    template<class It> It gallop_upper     (It begin, It end, const T& v) const;
+    template<class It> It gallop_lower     (It begin, It end, const T& v) const;
+    template<class It> It gallop_upper_back(It begin, It end, const T& v) const;
+    template<class It> It gallop_lower_back(It begin, It end, const T& v) const;
+};
+
+
+template<class Iterator, class Compare>
+void adaptive_merge_sort(Iterator first, Iterator last, Compare less) {
+  MergeSorter<Iterator,Compare>(less).sort(first, last);
+}
+
+
+template<class Iterator>
+void adaptive_merge_sort(Iterator first, Iterator last) {
+  MergeSorter<Iterator>().sort(first, last);
+}
+
+
+template<class T>
+void adaptive_merge_sort(T a[], int length) {
+  MergeSorter<T*>().sort(a, a + length);
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//MergeSorter: Constructor, Queries, and Commands
+
+template<class Iterator, class Compare>
+MergeSorter<Iterator,Compare>::MergeSorter(Compare less)
+: less(less)
+{}
+
+
+template<class Iterator, class Compare>
+int MergeSorter<Iterator,Compare>::natural_runs() const {
+  return natural;
+}
+
+
+template<class Iterator, class Compare>
+void MergeSorter<Iterator,Compare>::sort(Iterator first, Iterator last) {
+  int n = last - first;
+  natural = n == 0 ? 0 : 1;
+  if (n < 2)
+    return;
+  base = first;
+  runs.clear();
+  natural = 0;
+  int minimum = min_run(n);
+  for (int low = 0; low < n; ) {
+    int high = run_end(first, low, n);
+    ++natural;
+    if (high - low < minimum) {
+      int forced = std::min(n, low + minimum);
+      insertion_sort(first + low, first + high, first + forced);
+      high = forced;
+    }
+    runs.push_back(Run{low, high - low});
+    collapse();
+    low = high;
+  }
+  force_collapse();
+}
+
+
+//Merge the adjacent sorted ranges [first,middle) and [middle,last) (stably:
+//  equal values from the left range stay first)
+template<class Iterator, class Compare>
+void MergeSorter<Iterator,Compare>::merge(Iterator first, Iterator middle, Iterator last) {
+  if (first == middle || middle == last)
+    return;
+  first = std::upper_bound(first, middle, *middle, less);
+  if (first == middle)
+    return;
+  last = std::lower_bound(middle, last, *(middle - 1), less);
+  if (middle - first <= last - middle)
+    merge_low(first, middle, last);
+  else
+    merge_high(first, middle, last);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//MergeSorter: Helper methods
+
+//For n < min_merge, n (one run, insertion sorted); otherwise a length in
+//  [min_merge/2, min_merge] that divides n into 2^k runs or just fewer
+template<class Iterator, class Compare>
+int MergeSorter<Iterator,Compare>::min_run(int n) {
+  int odd = 0;
+  while (n >= min_merge) {
+    odd |= n & 1;
+    n >>= 1;
+  }
+  return n + odd;
+}
+
+
+//Return the end of the natural run starting at first[low], reversing it
+//  if it is strictly descending
+template<class Iterator, class Compare>
+int MergeSorter<Iterator,Compare>::run_end(Iterator first, int low, int n) {
+  int high = low + 1;
+  if (high == n)
+    return high;
+  if (less(first[high], first[low])) {
+    while (high < n && less(first[high], first[high-1]))
+      ++high;
+    std::reverse(first + low, first + high);
+  } else
+    while (high < n && !less(first[high], first[high-1]))
+      ++high;
+  return high;
+}
+
+
+//[first,sorted_end) is sorted; insert each later value (up to last) after
+//  the equal values already sorted
+template<class Iterator, class Compare>
+void MergeSorter<Iterator,Compare>::insertion_sort(Iterator first, Iterator sorted_end, Iterator last) {
+  for (Iterator i = sorted_end; i != last; ++i) {
+    Iterator to = std::upper_bound(first, i, *i, less);
+    if (to != i) {
+      T v = std::move(*i);
+      std::move_backward(to, i, i + 1);
+      *to = std::move(v);
+    }
+  }
+}
+
+
+//Merge until, for the runs X,Y,Z,W on top of the stack (W on top),
+//  Y > Z+W, X > Y+Z, and Z > W
+template<class Iterator, class Compare>
+void MergeSorter<Iterator,Compare>::collapse() {
+  while (runs.size() > 1) {
+    int n = runs.size() - 2;
+    if ((n > 0 && runs[n-1].length <= runs[n].length + runs[n+1].length) ||
+        (n > 1 && runs[n-2].length <= runs[n-1].length + runs[n].length)) {
+      if (runs[n-1].length < runs[n+1].length)
+        --n;
+    } else if (runs[n].length > runs[n+1].length)
+      break;
+    merge_at(n);
+  }
+}
+
+
+template<class Iterator, class Compare>
+void MergeSorter<Iterator,Compare>::force_collapse() {
+  while (runs.size() > 1) {
+    int n = runs.size() - 2;
+    if (n > 0 && runs[n-1].length < runs[n+1].length)
+      --n;
+    merge_at(n);
+  }
+}
+
+
+template<class Iterator, class Compare>
+void MergeSorter<Iterator,Compare>::merge_at(int i) {
+  Iterator first  = base + runs[i].start;
+  Iterator middle = base + runs[i+1].start;
+  merge(first, middle, middle + runs[i+1].length);
+  runs[i].length += runs[i+1].length;
+  runs.erase(runs.begin() + i + 1);
+}
+
+
+//The left range is shorter: move it into buffer and merge forward into
+//  [first,last); the right range's values never move before they are merged
+template<class Iterator, class Compare>
+void MergeSorter<Iterator,Compare>::merge_low(Iterator first, Iterator middle, Iterator last) {
+  buffer.assign(std::make_move_iterator(first), std::make_move_iterator(middle));
+  T*       l     = buffer.data();
+  T*       l_end = l + buffer.size();
+  Iterator r     = middle;
+  Iterator out   = first;
+  while (l != l_end && r != last) {
+    int left_wins = 0, right_wins = 0;
+    do {
+      if (less(*r, *l)) {
+        *out++ = std::move(*r++);
+        ++right_wins;
+        left_wins = 0;
+      } else {
+        *out++ = std::move(*l++);
+        ++left_wins;
+        right_wins = 0;
+      }
+    } while (l != l_end && r != last && left_wins < min_gallop && right_wins < min_gallop);
+    if (l == l_end || r == last)
+      break;
+    if (left_wins == min_gallop) {
+      T* stop = gallop_upper(l, l_end, *r);
+      out = std::move(l, stop, out);
+      l = stop;
+    } else {
+      Iterator stop = gallop_lower(r, last, *l);
+      out = std::move(r, stop, out);
+      r = stop;
+    }
+  }
+  std::move(l, l_end, out);
+}
+
+
+//The right range is shorter: move it into buffer and merge backward into
+//  [first,last); the left range's values never move before they are merged
+template<class Iterator, class Compare>
+void MergeSorter<Iterator,Compare>::merge_high(Iterator first, Iterator middle, Iterator last) {
+  buffer.assign(std::make_move_iterator(middle), std::make_move_iterator(last));
+  T*       r_begin = buffer.data();
+  T*       r       = r_begin + buffer.size();
+  Iterator l       = middle;
+  Iterator out     = last;
+  while (l != first && r != r_begin) {
+    int left_wins = 0, right_wins = 0;
+    do {
+      if (less(*(r-1), *(l-1))) {
+        *--out = std::move(*--l);
+        ++left_wins;
+        right_wins = 0;
+      } else {
+        *--out = std::move(*--r);
+        ++right_wins;
+        left_wins = 0;
+      }
+    } while (l != first && r != r_begin && left_wins < min_gallop && right_wins < min_gallop);
+    if (l == first || r == r_begin)
+      break;
+    if (left_wins == min_gallop) {
+      Iterator stop = gallop_upper_back(first, l, *(r-1));
+      out = std::move_backward(stop, l, out);
+      l = stop;
+    } else {
+      T* stop = gallop_lower_back(r_begin, r, *(l-1));
+      out = std::move_backward(stop, r, out);
+      r = stop;
+    }
+  }
+  std::move_backward(r_begin, r, out);
+}
+
+
+//The first value in [begin,end) greater than v, searching from begin in
+//  steps of 1, 3, 7, ... and then by binary search
+template<class Iterator, class Compare>
+template<class It>
+It MergeSorter<Iterator,Compare>::gallop_upper(It begin, It end, const T& v) const {
+  int n = end - begin, low = 0, high = 1;
+  while (high < n && !less(v, begin[high])) {
+    low  = high;
+    high = 2*high + 1;
+  }
+  return std::upper_bound(begin + low, begin + std::min(high, n), v, less);
+}
+
+
+//The first value in [begin,end) not less than v, searching from begin
+template<class Iterator, class Compare>
+template<class It>
+It MergeSorter<Iterator,Compare>::gallop_lower(It begin, It end, const T& v) const {
+  int n = end - begin, low = 0, high = 1;
+  while (high < n && less(begin[high], v)) {
+    low  = high;
+    high = 2*high + 1;
+  }
+  return std::lower_bound(begin + low, begin + std::min(high, n), v, less);
+}
+
+
+//The first value in [begin,end) greater than v, searching back from end
+template<class Iterator, class Compare>
+template<class It>
+It MergeSorter<Iterator,Compare>::gallop_upper_back(It begin, It end, const T& v) const {
+  int n = end - begin, low = 0, high = 1;
+  while (high <= n && less(v, *(end - high))) {
+    low  = high;
+    high = 2*high + 1;
+  }
+  return std::upper_bound(end - std::min(high, n), end - low, v, less);
+}
+
+
+//The first value in [begin,end) not less than v, searching back from end
+template<class Iterator, class Compare>
+template<class It>
+It MergeSorter<Iterator,Compare>::gallop_lower_back(It begin, It end, const T& v) const {
+  int n = end - begin, low = 0, high = 1;
+  while (high <= n && !less(*(end - high), v)) {
+    low  = high;
+    high = 2*high + 1;
+  }
+  return std::lower_bound(end - std::min(high, n), end - low, v, less);
+}
+
+
+}
+
+#endif /* MERGE_SORT_HPP_ */
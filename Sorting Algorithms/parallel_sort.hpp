@@ -0,0 +1,203 @@
+#ifndef PARALLEL_SORT_HPP_
+#define PARALLEL_SORT_HPP_
+
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include "q6utility.hpp"
+#include "merge_sort.hpp"
+#include "radix_sort.hpp"
+#include "work_stealing_pool.hpp"
+
+
+namespace ics {
+
+
+//Parallel sorts of a[0..length-1], each run on a WorkStealingPool; ranges of
+//  at most cutoff values are sorted sequentially, so tasks are large enough to
+//  be worth stealing.
+//  - parallel_quicksort partitions with median_3 and partition (q6utility.hpp)
+//    and sorts the two sides in parallel; below cutoff (or after 2*log2(length)
+//    levels of recursion, which only bad pivots reach, e.g., with many equal
+//    values) it uses std::sort.
+//  - parallel_merge_sort (stable) sorts the two halves in parallel and merges
+//    them in parallel: the larger range's middle value is found in the other
+//    range by binary search, splitting the merge into two independent merges.
+//    It ping-pongs between a and one buffer of length values; ranges below
+//    cutoff are sorted by MergeSorter.
+//  - parallel_radix_sort (stable) is an LSD radix sort on the bytes of the
+//    encoded keys (see RadixKey in radix_sort.hpp), splitting a into one block
+//    per worker: for each byte, every block counts its own histogram, the
+//    histograms are combined (digit major, block minor) into where each
+//    block's values for each digit go, and every block moves its values.
+//    Bytes that are the same in every key are skipped; below cutoff it uses
+//    radix_sort.
+//Programs using them must be compiled with -pthread (Threads::Threads in CMake).
+
+template<class T>
+void parallel_quicksort (T a[], int length, WorkStealingPool& pool, int cutoff = 1 << 14);
+
+template<class T, class Compare = std::less<T>>
+void parallel_merge_sort(T a[], int length, WorkStealingPool& pool, Compare less = Compare(), int cutoff = 1 << 14);
+
+template<class T, class KeyOf = RadixIdentity>
+void parallel_radix_sort(T a[], int length, WorkStealingPool& pool, KeyOf key = KeyOf(), int cutoff = 1 << 16);
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//parallel_quicksort
+
+template<class T>
+void parallel_quicksort(WorkStealingPool& pool, T a[], int low, int high, int cutoff, int depth) {
+  if (high - low + 1 <= cutoff || depth == 0) {
+    std::sort(a + low, a + high + 1);
+    return;
+  }
+  int pivot = partition(a, low, high, median_3(a, low, high));
+  pool.invoke([&] () {parallel_quicksort(pool, a, low, pivot - 1, cutoff, depth - 1);},
+              [&] () {parallel_quicksort(pool, a, pivot + 1, high, cutoff, depth - 1);});
+}
+
+
+template<class T>
+void parallel_quicksort(T a[], int length, WorkStealingPool& pool, int cutoff) {
+  int depth = 0;
+  for (int n = length; n > 1; n /= 2)
+    depth += 2;
+  pool.run([&] () {parallel_quicksort(pool, a, 0, length - 1, std::max(cutoff, 1), depth);});
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//parallel_merge_sort
+
+//Merge [l,l_end) and [r,r_end) (equal values from [l,l_end) first) into out
+template<class T, class Compare>
+void parallel_merge(WorkStealingPool& pool, T* l, T* l_end, T* r, T* r_end, T* out, Compare& less, int cutoff) {
+  if ((l_end - l) + (r_end - r) <= cutoff) {
+    std::merge(std::make_move_iterator(l), std::make_move_iterator(l_end),
+               std::make_move_iterator(r), std::make_move_iterator(r_end), out, less);
+    return;
+  }
+  T* l_split;
+  T* r_split;
+  if (l_end - l >= r_end - r) {
+    l_split = l + (l_end - l) / 2;
+    r_split = std::lower_bound(r, r_end, *l_split, less);
+  } else {
+    r_split = r + (r_end - r) / 2;
+    l_split = std::upper_bound(l, l_end, *r_split, less);
+  }
+  T* out_split = out + (l_split - l) + (r_split - r);
+  pool.invoke([&] () {parallel_merge(pool, l, l_split, r, r_split, out, less, cutoff);},
+              [&] () {parallel_merge(pool, l_split, l_end, r_split, r_end, out_split, less, cutoff);});
+}
+
+
+//Sort a[0..n-1], leaving the answer in b if into_b (else in a): the halves are
+//  sorted into the other array, then merged back
+template<class T, class Compare>
+void parallel_merge_sort(WorkStealingPool& pool, T* a, T* b, int n, bool into_b, Compare& less, int cutoff) {
+  if (n <= cutoff) {
+    MergeSorter<T*,Compare>(less).sort(a, a + n);
+    if (into_b)
+      std::move(a, a + n, b);
+    return;
+  }
+  int half = n / 2;
+  pool.invoke([&] () {parallel_merge_sort(pool, a, b, half, !into_b, less, cutoff);},
+              [&] () {parallel_merge_sort(pool, a + half, b + half, n - half, !into_b, less, cutoff);});
+  T* from = into_b ? a : b;
+  T* to   = into_b ? b : a;
+  parallel_merge(pool, from, from + half, from + half, from + n, to, less, cutoff);
+}
+
+
+template<class T, class Compare>
+void parallel_merge_sort(T a[], int length, WorkStealingPool& pool, Compare less, int cutoff) {
+  std::vector<T> buffer(length);
+  pool.run([&] () {parallel_merge_sort(pool, a, buffer.data(), length, false, less, std::max(cutoff, 2));});
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//parallel_radix_sort
+
+template<class T, class KeyOf>
+void parallel_radix_sort(T a[], int length, WorkStealingPool& pool, KeyOf key, int cutoff) {
+  typedef typename RadixSorter<T,KeyOf>::Key  Key;
+  typedef typename RadixSorter<T,KeyOf>::Bits Bits;
+  const int bytes = sizeof(Bits);
+  if (length <= cutoff) {
+    radix_sort(a, length, key);
+    return;
+  }
+
+  int blocks = pool.size();
+  std::vector<int> bounds(blocks + 1);
+  for (int b = 0; b <= blocks; ++b)
+    bounds[b] = (long long)length * b / blocks;
+  auto digit = [&key] (const T& v, int byte) {return int((RadixKey<Key>::encode(key(v)) >> (8*byte)) & 0xFF);};
+
+  //Which bytes differ: each block ANDs and ORs the bits of its keys; a bit is
+  //  the same in all keys if every OR has it 0 or every AND has it 1, and a
+  //  byte whose bits are all the same needs no pass
+  std::vector<Bits> ands(blocks, Bits(~Bits(0))), ors(blocks, Bits(0));
+  std::vector<T>    buffer(length);
+  std::vector<int>  counts(blocks * 256);
+  T* from = a;
+  T* to   = buffer.data();
+  pool.run([&] () {
+    pool.parallel_for(blocks, [&] (int b) {
+      for (T* v = a + bounds[b]; v != a + bounds[b+1]; ++v) {
+        Bits bits = RadixKey<Key>::encode(key(*v));
+        ands[b] &= bits;
+        ors[b]  |= bits;
+      }
+    });
+    Bits same_zero = Bits(~Bits(0)), same_one = Bits(~Bits(0));
+    for (int b = 0; b < blocks; ++b) {
+      same_zero &= Bits(~ors[b]);
+      same_one  &= ands[b];
+    }
+    Bits same = same_zero | same_one;
+
+    for (int byte = 0; byte < bytes; ++byte) {
+      if (((same >> (8*byte)) & 0xFF) == 0xFF)
+        continue;
+      pool.parallel_for(blocks, [&] (int b) {
+        int* count = &counts[b * 256];
+        std::fill(count, count + 256, 0);
+        for (T* v = from + bounds[b]; v != from + bounds[b+1]; ++v)
+          ++count[digit(*v, byte)];
+      });
+      for (int d = 0, sum = 0; d < 256; ++d)
+        for (int b = 0; b < blocks; ++b) {
+          int c = counts[b * 256 + d];
+          counts[b * 256 + d] = sum;
+          sum += c;
+        }
+      pool.parallel_for(blocks, [&] (int b) {
+        int* next = &counts[b * 256];
+        for (T* v = from + bounds[b]; v != from + bounds[b+1]; ++v)
+          to[next[digit(*v, byte)]++] = std::move(*v);
+      });
+      std::swap(from, to);
+    }
+    if (from != a)
+      pool.parallel_for(blocks, [&] (int b) {
+        std::move(from + bounds[b], from + bounds[b+1], a + bounds[b]);
+      });
+  });
+}
+
+
+}
+
+#endif /* PARALLEL_SORT_HPP_ */
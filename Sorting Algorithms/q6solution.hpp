@@ -8,8 +8,10 @@
 #include <sstream>
 #include <algorithm>                 // std::swap
 #include "ics46goody.hpp"
+#include "ics_exceptions.hpp"
 #include "array_queue.hpp"
 #include "q6utility.hpp"
+#include "merge_sort.hpp"
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -39,31 +41,21 @@ void selection_sort(LN<T>* l) {
 //Problem 2
 
 //Write this function
+//The ranges must be adjacent (right_low == left_high+1): otherwise IcsError
+//  is thrown, rather than merging the wrong values. MergeSorter merges them
+//  stably through a heap buffer sized by the shorter range (galloping when
+//  one side supplies many values in a row); to merge repeatedly without
+//  reallocating, or to sort, use a MergeSorter (see merge_sort.hpp) directly.
 template<class T>
 void merge(T a[], int left_low,  int left_high,
                     int right_low, int right_high) {
-    int temp_l = left_low, temp_r = right_low, size = right_high - left_low + 1;
-    int array[(right_high - left_low + 1)];
-    for (auto i = 0; i < size; i++) {
-        if (temp_l > left_high) {
-            array[i] = a[temp_r];
-            temp_r++;
-        } else if (temp_r > right_high) {
-            array[i] = a[temp_l];
-            temp_l++;
-        } else if (a[temp_l] <= a[temp_r]) {
-            array[i] = a[temp_l];
-            temp_l++;
-        } else {
-            array[i] = a[temp_r];
-            temp_r++;
-        }
-    }
-
-    for (auto i = 0; i < size; i++, left_low++) {
-        a[left_low] = array[i];
+    if (right_low != left_high + 1) {
+        std::ostringstream answer;
+        answer << "merge: ranges [" << left_low << "," << left_high << "] and ["
+               << right_low << "," << right_high << "] are not adjacent";
+        throw ics::IcsError(answer.str());
     }
-
+    ics::MergeSorter<T*>().merge(a + left_low, a + right_low, a + right_high + 1);
 }
 
 
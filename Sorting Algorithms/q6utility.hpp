@@ -1,3 +1,6 @@
+#ifndef Q6UTILITY_HPP_
+#define Q6UTILITY_HPP_
+
 #include <vector>
 #include <algorithm>                 // std::random_shuffle
 #include <random>
@@ -92,7 +95,8 @@ void shuffle(T values[], int length) {
 //using pivot_index as the pivot (first swapping it to the end)
 template<class T>
 int partition(T a[], int low, int high, int pivot_index) {
-  int l = low, r = high, pivot = a[pivot_index];
+  int l = low, r = high;
+  T pivot = a[pivot_index];
   std::swap(a[pivot_index],a[high]);
   while (l < r) {                    //Are there some values to examine?
     while (l < r && a[l] < pivot)    //Find a left value >= the pivot
@@ -121,10 +125,10 @@ int last(T a[], int low, int high) {
 //  the index of the middle value.
 template<class T>
 int median_3(T a[], int low, int high) { //Returns the index of the middle value
-  int l = a[low];
+  const T& l = a[low];
   int mid = (low + high) / 2;
-  int m = a[mid];
-  int r = a[high];
+  const T& m = a[mid];
+  const T& r = a[high];
   if (l < m) {
     if (m < r)
       return mid;
@@ -140,4 +144,6 @@ int median_3(T a[], int low, int high) { //Returns the index of the middle value
     else
       return high;
   }
-}
\ No newline at end of file
+}
+
+#endif /* Q6UTILITY_HPP_ */
@@ -0,0 +1,259 @@
+#ifndef RADIX_SORT_HPP_
+#define RADIX_SORT_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+
+namespace ics {
+
+
+//RadixKey<K>::encode maps a key to an unsigned integer (bits) ordered the same
+//  way as the keys, so keys can be sorted one byte at a time:
+//  - unsigned integers are their own encoding;
+//  - signed integers flip their sign bit (so negative values sort first);
+//  - floats and doubles flip the sign bit of non-negative values and every
+//    bit of negative values (-0.0 sorts before 0.0; NaNs sort at the ends).
+template<class K, class Enable = void> struct RadixKey;
+
+template<class K>
+struct RadixKey<K, typename std::enable_if<std::is_integral<K>::value>::type> {
+  typedef typename std::make_unsigned<K>::type bits;
+  static bits encode (K k) {
+    return std::is_signed<K>::value ? bits(bits(k) ^ bits(bits(1) << (8*sizeof(K)-1))) : bits(k);
+  }
+};
+
+template<>
+struct RadixKey<float> {
+  typedef std::uint32_t bits;
+  static bits encode (float k) {
+    bits b;
+    std::memcpy(&b, &k, sizeof(b));
+    return (b & 0x80000000u) ? ~b : b | 0x80000000u;
+  }
+};
+
+template<>
+struct RadixKey<double> {
+  typedef std::uint64_t bits;
+  static bits encode (double k) {
+    bits b;
+    std::memcpy(&b, &k, sizeof(b));
+    return (b >> 63) ? ~b : b | (bits(1) << 63);
+  }
+};
+
+
+//The key of a value sorted by itself
+struct RadixIdentity {
+  template<class T>
+  const T& operator () (const T& v) const {return v;}
+};
+
+
+
+
+//A RadixSorter sorts a[0..length-1] (stably) by key(a[i]), which must return
+//  a value for which RadixKey is defined (any integer type, float, or double).
+//One pass counts every byte of every encoded key, filling a histogram for each
+//  byte; a byte that is the same in every key needs no pass. Then
+//  - lsd (least significant digit first) moves every value once per remaining
+//    byte, ping-ponging between a and a buffer of the same size;
+//  - msd (most significant digit first) distributes by the highest remaining
+//    byte and recurses on each bucket with the next byte, so it stops as soon
+//    as buckets are small (then insertion sorted) instead of always moving
+//    every value once per byte; it wins when the keys use many more bytes
+//    than needed to tell length values apart (e.g., random 64-bit keys).
+//sort chooses msd when the remaining bytes number more than 2 + the bytes
+//  needed to index length values (e.g., 10^5 or more random 64-bit keys);
+//  otherwise lsd.
+//T must be default constructible (for the buffer) and movable.
+template<class T, class KeyOf = RadixIdentity>
+class RadixSorter {
+  public:
+    typedef typename std::decay<decltype(std::declval<KeyOf>()(std::declval<const T&>()))>::type Key;
+    typedef typename RadixKey<Key>::bits Bits;
+    enum {bytes = sizeof(Bits), insertion_size = 32};
+
+    RadixSorter(T a[], int length, KeyOf key = KeyOf());
+
+    int  active_bytes () const;              //Bytes that differ among the keys
+    void sort         ();
+    void lsd          ();
+    void msd          ();
+
+  private:
+    T*             a;
+    int            length;
+    KeyOf          key;
+    std::vector<T> buffer;
+    int            counts[bytes][256];
+    bool           active[bytes];
+
+    //Helper methods
+    Bits       bits_of        (const T& v) const {return RadixKey<Key>::encode(key(v));}
+    static int digit          (Bits b, int byte) {return int((b >> (8*byte)) & 0xFF);}
+    void       msd            (T* from, T* to, int n, int byte, bool from_is_a);
+    void       insertion_sort (T* from, int n);
+};
+
+
+//Sort a[0..length-1] (stably) by key(a[i]), or by a[i] itself
+template<class T, class KeyOf>
+void radix_sort(T a[], int length, KeyOf key) {
+  RadixSorter<T,KeyOf>(a, length, key).sort();
+}
+
+
+template<class T>
+void radix_sort(T a[], int length) {
+  RadixSorter<T>(a, length).sort();
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//RadixSorter: Constructor
+
+//Count every byte of every key, and find which bytes differ among the keys
+template<class T, class KeyOf>
+RadixSorter<T,KeyOf>::RadixSorter(T a[], int length, KeyOf key)
+: a(a), length(length), key(key) {
+  std::memset(counts, 0, sizeof(counts));
+  for (int i = 0; i < length; ++i) {
+    Bits b = bits_of(a[i]);
+    for (int byte = 0; byte < bytes; ++byte)
+      ++counts[byte][digit(b, byte)];
+  }
+  Bits first = length == 0 ? Bits(0) : bits_of(a[0]);
+  for (int byte = 0; byte < bytes; ++byte)
+    active[byte] = counts[byte][digit(first, byte)] != length;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//RadixSorter: Queries and Commands
+
+template<class T, class KeyOf>
+int RadixSorter<T,KeyOf>::active_bytes() const {
+  return std::count(active, active + bytes, true);
+}
+
+
+//After the bytes needed to index length values, msd's buckets are tiny: it
+//  pays off when it would skip more than 2 of lsd's passes
+template<class T, class KeyOf>
+void RadixSorter<T,KeyOf>::sort() {
+  int index_bytes = 1;
+  for (long long reach = 256; reach < length; reach *= 256)
+    ++index_bytes;
+  if (active_bytes() > index_bytes + 2)
+    msd();
+  else
+    lsd();
+}
+
+
+template<class T, class KeyOf>
+void RadixSorter<T,KeyOf>::lsd() {
+  if (length < 2)
+    return;
+  buffer.resize(length);
+  T* from = a;
+  T* to   = buffer.data();
+  for (int byte = 0; byte < bytes; ++byte) {
+    if (!active[byte])
+      continue;
+    int next[256];
+    for (int d = 0, sum = 0; d < 256; ++d) {
+      next[d] = sum;
+      sum += counts[byte][d];
+    }
+    for (T* v = from; v != from + length; ++v)
+      to[next[digit(bits_of(*v), byte)]++] = std::move(*v);
+    std::swap(from, to);
+  }
+  if (from != a)
+    std::move(from, from + length, a);
+}
+
+
+//Start at the highest byte that differs (the constructor's counts are for
+//  all of a, so they are not needed again)
+template<class T, class KeyOf>
+void RadixSorter<T,KeyOf>::msd() {
+  int byte = bytes - 1;
+  while (byte >= 0 && !active[byte])
+    --byte;
+  if (length < 2 || byte < 0)
+    return;
+  buffer.resize(length);
+  msd(a, buffer.data(), length, byte, true);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//RadixSorter: Helper methods
+
+//from[0..n-1] have keys equal in all bytes above byte; to[0..n-1] is the
+//  other of a/buffer. Leave the sorted values in the a side. Bytes that are
+//  the same in every key of a are skipped.
+template<class T, class KeyOf>
+void RadixSorter<T,KeyOf>::msd(T* from, T* to, int n, int byte, bool from_is_a) {
+  if (n <= insertion_size || byte < 0) {
+    if (byte >= 0)
+      insertion_sort(from, n);
+    if (!from_is_a)
+      std::move(from, from + n, to);
+    return;
+  }
+
+  int count[257] = {};
+  for (T* v = from; v != from + n; ++v)
+    ++count[digit(bits_of(*v), byte) + 1];
+  int lower = byte - 1;
+  while (lower >= 0 && !active[lower])
+    --lower;
+  if (count[digit(bits_of(*from), byte) + 1] == n) {
+    msd(from, to, n, lower, from_is_a);
+    return;
+  }
+
+  for (int d = 0; d < 256; ++d)
+    count[d+1] += count[d];
+  int next[256];
+  std::copy(count, count + 256, next);
+  for (T* v = from; v != from + n; ++v)
+    to[next[digit(bits_of(*v), byte)]++] = std::move(*v);
+  for (int d = 0; d < 256; ++d)
+    if (count[d+1] > count[d])
+      msd(to + count[d], from + count[d], count[d+1] - count[d], lower, !from_is_a);
+}
+
+
+//Stable: a value moves left only past values with larger keys
+template<class T, class KeyOf>
+void RadixSorter<T,KeyOf>::insertion_sort(T* from, int n) {
+  for (int i = 1; i < n; ++i) {
+    T    v = std::move(from[i]);
+    Bits b = bits_of(v);
+    int  j = i;
+    for (; j > 0 && bits_of(from[j-1]) > b; --j)
+      from[j] = std::move(from[j-1]);
+    from[j] = std::move(v);
+  }
+}
+
+
+}
+
+#endif /* RADIX_SORT_HPP_ */
@@ -0,0 +1,323 @@
+#ifndef WORK_STEALING_POOL_HPP_
+#define WORK_STEALING_POOL_HPP_
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+
+namespace ics {
+
+
+//A WorkStealingPool runs fork-join computations (e.g., divide and conquer
+//  sorts) on a fixed number of threads.
+//run(f) calls f on the calling thread, which is worker 0 while f runs; the
+//  pool's other size()-1 workers are threads that wait for work. Inside f (at
+//  any depth of recursion) invoke(f1,f2) may call f1 and f2 in parallel: it
+//  pushes f2 onto the back of this worker's deque, calls f1, and then pops f2
+//  and calls it itself, unless another worker stole it meanwhile. An idle
+//  worker steals from the front of a random worker's deque, which holds that
+//  worker's oldest (so largest) pieces of work. A worker whose f2 was stolen
+//  runs other tasks until it finishes, so no worker blocks while work remains.
+//Callers stop splitting below a sequential cutoff, so tasks are large enough
+//  that a mutex per deque costs little. invoke called from outside run (or by
+//  a thread not in this pool) calls f1 and then f2. An exception thrown by f1
+//  or f2 is rethrown by invoke after both have finished.
+//Nested use is supported: run called by a thread already working for this
+//  pool (inside f, or in a task) just calls its argument on that thread, whose
+//  invokes then share the pool's workers; e.g., a parallel sort may be called
+//  from inside a parallel_for body. Other threads' runs wait their turn.
+//Programs using it must be compiled with -pthread (Threads::Threads in CMake).
+class WorkStealingPool {
+  public:
+    //Destructor/Constructors
+    ~WorkStealingPool();
+    explicit WorkStealingPool(int threads = 0);     //0 or less: one per hardware thread
+    WorkStealingPool(const WorkStealingPool& p)              = delete;
+    WorkStealingPool& operator = (const WorkStealingPool& p) = delete;
+
+    //Queries
+    int  size   () const;
+    long steals () const;                           //Tasks run by a worker that didn't push them
+
+    //Commands
+    template<class F>          void run          (F f);
+    template<class F, class G> void invoke       (F f, G g);
+    template<class Body>       void parallel_for (int count, Body body);   //body(i) for i in [0,count)
+
+  private:
+    struct Task {
+      std::function<void()> body;
+      std::atomic<bool>     done{false};
+      std::exception_ptr    error;
+    };
+
+    struct Worker {
+      std::mutex                 lock;
+      std::deque<Task*>          tasks;
+      std::default_random_engine generator;      //Chooses victims; used only by its worker
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread>             pool;
+    std::mutex                           run_lock;       //One run at a time
+    std::mutex                           sleep_lock;
+    std::condition_variable              wake;
+    std::atomic<int>                     queued{0};      //Tasks in all deques
+    std::atomic<long>                    stolen{0};
+    std::atomic<bool>                    stopping{false};
+
+    //Helper methods
+    static WorkStealingPool*& current_pool  ();      //The pool this thread works for, or nullptr
+    static int&               current_index ();      //  and its worker index there
+    void  work      (int index);
+    void  push      (int index, Task* t);
+    bool  pop       (int index, Task* t);            //Pop t if it is still at the back
+    Task* find_task (int index);
+    void  execute   (Task* t);
+    template<class Body> void split (int low, int high, Body& body);
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//WorkStealingPool: Destructor/Constructors
+
+WorkStealingPool::~WorkStealingPool() {
+  stopping = true;
+  {
+    std::lock_guard<std::mutex> guard(sleep_lock);
+  }
+  wake.notify_all();
+  for (std::thread& t : pool)
+    t.join();
+}
+
+
+WorkStealingPool::WorkStealingPool(int threads) {
+  if (threads <= 0)
+    threads = std::max(1, int(std::thread::hardware_concurrency()));
+  for (int i = 0; i < threads; ++i) {
+    workers.push_back(std::unique_ptr<Worker>(new Worker()));
+    workers.back()->generator.seed(i);
+  }
+  for (int i = 1; i < threads; ++i)
+    pool.push_back(std::thread(&WorkStealingPool::work, this, i));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//WorkStealingPool: Queries
+
+int WorkStealingPool::size() const {
+  return workers.size();
+}
+
+
+long WorkStealingPool::steals() const {
+  return stolen;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//WorkStealingPool: Commands
+
+template<class F>
+void WorkStealingPool::run(F f) {
+  if (current_pool() == this) {
+    f();
+    return;
+  }
+
+  std::lock_guard<std::mutex> guard(run_lock);
+  WorkStealingPool* old_pool  = current_pool();
+  int               old_index = current_index();
+  current_pool()  = this;
+  current_index() = 0;
+  try {
+    f();
+  } catch (...) {
+    current_pool()  = old_pool;
+    current_index() = old_index;
+    throw;
+  }
+  current_pool()  = old_pool;
+  current_index() = old_index;
+}
+
+
+template<class F, class G>
+void WorkStealingPool::invoke(F f, G g) {
+  if (current_pool() != this) {
+    f();
+    g();
+    return;
+  }
+
+  int  index = current_index();
+  Task task;
+  task.body = g;
+  push(index, &task);
+  std::exception_ptr error;
+  try {
+    f();
+  } catch (...) {
+    error = std::current_exception();
+  }
+
+  if (pop(index, &task))
+    execute(&task);
+  else
+    while (!task.done.load(std::memory_order_acquire)) {
+      Task* t = find_task(index);
+      if (t != nullptr)
+        execute(t);
+      else
+        std::this_thread::yield();
+    }
+
+  if (error)
+    std::rethrow_exception(error);
+  if (task.error)
+    std::rethrow_exception(task.error);
+}
+
+
+//Split [0,count) in halves with invoke, down to single indexes
+template<class Body>
+void WorkStealingPool::parallel_for(int count, Body body) {
+  if (count > 0)
+    split(0, count, body);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//WorkStealingPool: Helper methods
+
+WorkStealingPool*& WorkStealingPool::current_pool() {
+  static thread_local WorkStealingPool* pool = nullptr;
+  return pool;
+}
+
+
+int& WorkStealingPool::current_index() {
+  static thread_local int index = -1;
+  return index;
+}
+
+
+//A worker thread's loop: run tasks while there are any, otherwise sleep
+//  until one is pushed (or the pool is destroyed)
+void WorkStealingPool::work(int index) {
+  current_pool()  = this;
+  current_index() = index;
+  while (!stopping) {
+    Task* t = find_task(index);
+    if (t != nullptr)
+      execute(t);
+    else {
+      std::unique_lock<std::mutex> guard(sleep_lock);
+      wake.wait(guard, [this] () {return stopping || queued > 0;});
+    }
+  }
+}
+
+
+//Count the task before waking a worker (under sleep_lock), so a worker
+//  checking whether to sleep cannot miss it
+void WorkStealingPool::push(int index, Task* t) {
+  {
+    std::lock_guard<std::mutex> guard(workers[index]->lock);
+    workers[index]->tasks.push_back(t);
+  }
+  ++queued;
+  {
+    std::lock_guard<std::mutex> guard(sleep_lock);
+  }
+  wake.notify_one();
+}
+
+
+bool WorkStealingPool::pop(int index, Task* t) {
+  std::lock_guard<std::mutex> guard(workers[index]->lock);
+  std::deque<Task*>& tasks = workers[index]->tasks;
+  if (tasks.empty() || tasks.back() != t)
+    return false;
+  tasks.pop_back();
+  --queued;
+  return true;
+}
+
+
+//The newest task in this worker's deque; otherwise the oldest task of the
+//  first worker with any, trying them in turn from a random one
+WorkStealingPool::Task* WorkStealingPool::find_task(int index) {
+  {
+    std::lock_guard<std::mutex> guard(workers[index]->lock);
+    std::deque<Task*>& tasks = workers[index]->tasks;
+    if (!tasks.empty()) {
+      Task* t = tasks.back();
+      tasks.pop_back();
+      --queued;
+      return t;
+    }
+  }
+  if (queued == 0)
+    return nullptr;
+
+  int n = workers.size();
+  int first = std::uniform_int_distribution<int>(0, n-1)(workers[index]->generator);
+  for (int i = 0; i < n; ++i) {
+    int victim = (first + i) % n;
+    if (victim == index)
+      continue;
+    std::lock_guard<std::mutex> guard(workers[victim]->lock);
+    std::deque<Task*>& tasks = workers[victim]->tasks;
+    if (!tasks.empty()) {
+      Task* t = tasks.front();
+      tasks.pop_front();
+      --queued;
+      ++stolen;
+      return t;
+    }
+  }
+  return nullptr;
+}
+
+
+void WorkStealingPool::execute(Task* t) {
+  try {
+    t->body();
+  } catch (...) {
+    t->error = std::current_exception();
+  }
+  t->done.store(true, std::memory_order_release);
+}
+
+
+template<class Body>
+void WorkStealingPool::split(int low, int high, Body& body) {
+  if (high - low == 1) {
+    body(low);
+    return;
+  }
+  int middle = low + (high - low) / 2;
+  invoke([&] () {split(low, middle, body);}, [&] () {split(middle, high, body);});
+}
+
+
+}
+
+#endif /* WORK_STEALING_POOL_HPP_ */
@@ -0,0 +1,113 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <random>
+#include "ics46goody.hpp"
+#include "stopwatch.hpp"
+#include "reachability.hpp"
+
+
+//Time reachability queries on two random graphs with 10^5 and 10^6 nodes:
+//  one whose random edges make most nodes one big strongly connected
+//  component, and one whose edges mostly go from higher to lower ids (with
+//  a few going back), which leaves many components. For each: BFS from a
+//  start node using a plain top-down search and the direction-optimizing
+//  bfs_reachable, then building a ReachabilityIndex and answering reaches
+//  queries (node pairs) and reachable_from queries with it.
+
+//A top-down-only BFS, for comparison
+ics::Bitset top_down_reachable(const ics::IdGraph& g, int start) {
+  ics::Bitset visited(g.node_count());
+  std::vector<int> queue(1, start);
+  visited.set(start);
+  for (int i=0; i<int(queue.size()); ++i)
+    for (int e=g.out_begin(queue[i]); e<g.out_end(queue[i]); ++e)
+      if (!visited.test(g.target(e))) {
+        visited.set(g.target(e));
+        queue.push_back(g.target(e));
+      }
+  return visited;
+}
+
+
+void compare(const std::string& title, int nodes, int edges_per, bool mostly_downward, int searches, int pairs) {
+  std::default_random_engine generator;
+  std::uniform_int_distribution<int> node_distribution(0,nodes-1);
+  std::bernoulli_distribution back_edge(0.001);
+  std::vector<int> origins, destinations;
+  for (int i=0; i<nodes*edges_per; ++i) {
+    int a = node_distribution(generator), b = node_distribution(generator);
+    if (mostly_downward && a < b && !back_edge(generator))
+      std::swap(a,b);
+    origins.push_back(a);
+    destinations.push_back(b);
+  }
+
+  ics::Stopwatch watch;
+  ics::IdGraph g(nodes, origins, destinations);
+  std::vector<int> starts, from, to;
+  for (int i=0; i<searches; ++i)
+    starts.push_back(node_distribution(generator));
+  for (int i=0; i<pairs; ++i) {
+    from.push_back(node_distribution(generator));
+    to.push_back(node_distribution(generator));
+  }
+  std::cout << std::endl << title << ": " << nodes << " nodes, " << g.edge_count() << " edges" << std::endl;
+
+  long long reached[2] = {0,0};
+  watch.start();
+  for (int s : starts)
+    reached[0] += top_down_reachable(g, s).count();
+  watch.stop();
+  std::cout << "  top-down BFS:              average time = " << watch.read()/searches
+            << " (average " << double(reached[0])/searches << " nodes reached)" << std::endl;
+
+  watch.reset();
+  watch.start();
+  for (int s : starts)
+    reached[1] += ics::bfs_reachable(g, s).count();
+  watch.stop();
+  std::cout << "  direction-optimizing BFS:  average time = " << watch.read()/searches
+            << (reached[0] == reached[1] ? "" : " (DIFFERENT ANSWERS)") << std::endl;
+
+  watch.reset();
+  watch.start();
+  ics::ReachabilityIndex index(g);
+  watch.stop();
+  std::cout << "  ReachabilityIndex build:   time = " << watch.read() << " (" << index.component_count()
+            << " components, " << (index.has_closure() ? "closure" : "interval labels") << ")" << std::endl;
+
+  int yes = 0;
+  watch.reset();
+  watch.start();
+  for (int i=0; i<pairs; ++i)
+    yes += index.reaches(from[i], to[i]);
+  watch.stop();
+  std::cout << "  reaches:                   average time = " << watch.read()/pairs
+            << " (" << yes << " of " << pairs << " pairs reachable)" << std::endl;
+
+  long long indexed = 0;
+  watch.reset();
+  watch.start();
+  for (int s : starts)
+    indexed += index.reachable_from(s).count();
+  watch.stop();
+  std::cout << "  reachable_from:            average time = " << watch.read()/searches
+            << (indexed == reached[0] ? "" : " (DIFFERENT ANSWERS)") << std::endl;
+}
+
+
+int main() {
+  try {
+    int searches = ics::prompt_int("Enter number of searches",20);
+    int pairs    = ics::prompt_int("Enter number of node pairs",100000);
+    for (int nodes : {100000, 1000000}) {
+      compare("Random graph",          nodes, 4, false, searches, pairs);
+      compare("Mostly downward graph", nodes, 4, true,  searches, pairs);
+    }
+  } catch (ics::IcsError& e) {
+    std::cout << "  " << e.what() << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,507 @@
+#ifndef REACHABILITY_HPP_
+#define REACHABILITY_HPP_
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include "ics_exceptions.hpp"
+
+
+namespace ics {
+
+
+//A Bitset holds a set of ints 0 to size()-1 as one bit each
+class Bitset {
+  public:
+    Bitset() {}
+    explicit Bitset(int size) : bits(size), words((size+63)/64, 0) {}
+
+    int  size ()                const {return bits;}
+    bool test (int i)           const {return (words[i>>6] >> (i&63)) & 1;}
+    void set  (int i)                 {words[i>>6] |= uint64_t(1) << (i&63);}
+    void reset()                      {std::fill(words.begin(), words.end(), 0);}
+
+    int count() const {
+      int answer = 0;
+      for (uint64_t w : words)
+        answer += __builtin_popcountll(w);
+      return answer;
+    }
+
+    //Smallest member >= i, or -1 if there is none
+    int next(int i) const {
+      if (i >= bits)
+        return -1;
+      int w = i>>6;
+      uint64_t word = words[w] & (~uint64_t(0) << (i&63));
+      while (word == 0) {
+        if (++w == int(words.size()))
+          return -1;
+        word = words[w];
+      }
+      return w*64 + __builtin_ctzll(word);
+    }
+
+    Bitset& operator |= (const Bitset& rhs) {
+      for (int w = 0; w < int(words.size()); ++w)
+        words[w] |= rhs.words[w];
+      return *this;
+    }
+
+    uint64_t word(int w) const {return words[w];}     //Bits 64w to 64w+63
+
+  private:
+    int                   bits = 0;
+    std::vector<uint64_t> words;
+};
+
+
+//An IdGraph is a read-only graph whose nodes are interned as dense int ids
+//  (0 to node_count()-1, in order of first appearance), with each node's
+//  out-edges and in-edges in contiguous arrays (as in a CSR graph).
+class IdGraph {
+  public:
+    //From a Map of each node name to the Set of names it has edges to (as
+    //  read_graph in reachable.cpp builds)
+    template<class Graph>
+    explicit IdGraph(const Graph& g);
+
+    //Edge i goes from origins[i] to destinations[i]; nodes are named by id
+    IdGraph(int node_count, const std::vector<int>& origins, const std::vector<int>& destinations);
+
+    int node_count () const {return out_offsets.size()-1;}
+    int edge_count () const {return out_targets.size();}
+    int find_id    (const std::string& node_name) const;     //-1 if not in graph
+    const std::string& node_name(int id) const {return names[id];}
+
+    int out_begin  (int id) const {return out_offsets[id];}
+    int out_end    (int id) const {return out_offsets[id+1];}
+    int target     (int e)  const {return out_targets[e];}
+    int in_begin   (int id) const {return in_offsets[id];}
+    int in_end     (int id) const {return in_offsets[id+1];}
+    int source     (int i)  const {return in_sources[i];}
+
+  private:
+    std::vector<std::string> names;
+    std::vector<int>         by_name;        //Ids sorted by name, for find_id
+    std::vector<int>         out_offsets, out_targets, in_offsets, in_sources;
+
+    std::vector<int> intern(const std::vector<std::string>& occurrences);
+    void build (const std::vector<int>& origins, const std::vector<int>& destinations);
+};
+
+
+//Return the nodes reachable from start (including start), by a
+//  direction-optimizing BFS: a level is expanded top-down (the frontier's
+//  out-edges) while the frontier is small, and bottom-up (each unvisited
+//  node looks through its in-edges for a frontier node, stopping at the
+//  first) once the frontier's out-edges outnumber a fraction of the edges
+//  still unexplored, which skips most edges in the big middle levels.
+Bitset bfs_reachable(const IdGraph& g, int start);
+
+
+//A ReachabilityIndex answers repeated reachability queries on an IdGraph
+//  without searching it again. Nodes are grouped into strongly connected
+//  components (all members reach each other), numbered by Tarjan's algorithm
+//  so every edge between components goes from a higher number to a lower
+//  one. In this condensation (a DAG):
+//  - if there are at most closure_limit components, each one stores a Bitset
+//    of the components it reaches (its transitive closure), so queries are
+//    bit tests;
+//  - otherwise, u cannot reach v if v's component number is higher, or if
+//    v's interval labels are not inside u's (post-order intervals from two
+//    DFS traversals of the DAG, as in GRAIL); the remaining queries search
+//    the DAG, skipping components that those tests rule out.
+class ReachabilityIndex {
+  public:
+    explicit ReachabilityIndex(const IdGraph& g, int closure_limit = 1 << 14);
+
+    int  component_count()                  const {return component_nodes_offsets.size()-1;}
+    int  component      (int id)            const {return components[id];}
+    bool has_closure    ()                  const {return !closure.empty();}
+    bool reaches        (int from, int to)  const;
+    Bitset reachable_from(int from)         const;   //Node ids reachable from from, including it
+
+  private:
+    std::vector<int>    components;                  //components[id]: its component number
+    std::vector<int>    component_nodes_offsets, component_nodes;
+    std::vector<int>    dag_offsets, dag_targets;    //Edges between components, without duplicates
+    std::vector<int>    low[2], post[2];             //Interval labels [low,post] from two traversals
+    std::vector<Bitset> closure;
+
+    bool labels_allow(int from, int to) const;
+    void label      (int traversal);
+    Bitset reachable_components(int from) const;
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//IdGraph
+
+//List every name occurrence (each source, then its destinations), sort the
+//  occurrences by name, and give each distinct name the id of its first
+//  appearance: no per-name search of a growing table. The names are copied,
+//  since g's iterators need not refer to storage that outlives them.
+template<class Graph>
+IdGraph::IdGraph(const Graph& g) {
+      std::vector<std::string> occurrences;
+      std::vector<int> origins, destinations;       //Occurrence indexes, then ids
+      for (const auto& entry : g) {
+          int origin = occurrences.size();
+          occurrences.push_back(entry.first);
+          for (const std::string& d : entry.second) {
+              origins.push_back(origin);
+              destinations.push_back(occurrences.size());
+              occurrences.push_back(d);
+          }
+      }
+
+      std::vector<int> ids = intern(occurrences);
+      for (int e = 0; e < int(origins.size()); ++e) {
+          origins[e]      = ids[origins[e]];
+          destinations[e] = ids[destinations[e]];
+      }
+      build(origins, destinations);
+}
+
+
+IdGraph::IdGraph(int node_count, const std::vector<int>& origins, const std::vector<int>& destinations) {
+      for (int id = 0; id < node_count; ++id) {
+          names.push_back(std::to_string(id));
+          by_name.push_back(id);
+      }
+      std::sort(by_name.begin(), by_name.end(), [this] (int a, int b) {return names[a] < names[b];});
+      build(origins, destinations);
+}
+
+
+int IdGraph::find_id(const std::string& node_name) const {
+      auto i = std::lower_bound(by_name.begin(), by_name.end(), node_name,
+                                [this] (int id, const std::string& n) {return names[id] < n;});
+      return (i != by_name.end() && names[*i] == node_name ? *i : -1);
+}
+
+
+//Fill names and by_name; return the id of each occurrence
+std::vector<int> IdGraph::intern(const std::vector<std::string>& occurrences) {
+      std::vector<int> order(occurrences.size());
+      for (int i = 0; i < int(order.size()); ++i)
+          order[i] = i;
+      std::stable_sort(order.begin(), order.end(),
+                       [&occurrences] (int a, int b) {return occurrences[a] < occurrences[b];});
+
+      std::vector<int> firsts;                      //First occurrence of each distinct name
+      for (int i = 0; i < int(order.size()); ++i)
+          if (i == 0 || occurrences[order[i]] != occurrences[order[i-1]])
+              firsts.push_back(order[i]);
+      std::vector<int> by_appearance(firsts);
+      std::sort(by_appearance.begin(), by_appearance.end());
+
+      std::vector<int> occurrence_ids(occurrences.size(), -1);
+      for (int id = 0; id < int(by_appearance.size()); ++id) {
+          names.push_back(occurrences[by_appearance[id]]);
+          occurrence_ids[by_appearance[id]] = id;
+      }
+      for (int first : firsts)
+          by_name.push_back(occurrence_ids[first]);
+      for (int i = 1; i < int(order.size()); ++i)
+          if (occurrence_ids[order[i]] == -1)
+              occurrence_ids[order[i]] = occurrence_ids[order[i-1]];
+      return occurrence_ids;
+}
+
+
+void IdGraph::build(const std::vector<int>& origins, const std::vector<int>& destinations) {
+      int n = names.size(), m = origins.size();
+      out_offsets.assign(n+1, 0);
+      in_offsets.assign(n+1, 0);
+      for (int e = 0; e < m; ++e) {
+          ++out_offsets[origins[e]+1];
+          ++in_offsets[destinations[e]+1];
+      }
+      for (int id = 0; id < n; ++id) {
+          out_offsets[id+1] += out_offsets[id];
+          in_offsets[id+1]  += in_offsets[id];
+      }
+      out_targets.resize(m);
+      in_sources.resize(m);
+      std::vector<int> out_next(out_offsets.begin(), out_offsets.end()-1), in_next(in_offsets.begin(), in_offsets.end()-1);
+      for (int e = 0; e < m; ++e) {
+          out_targets[out_next[origins[e]]++]   = destinations[e];
+          in_sources[in_next[destinations[e]]++] = origins[e];
+      }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//bfs_reachable
+
+//Switch to bottom-up when the frontier's out-edges exceed 1/alpha of the
+//  unexplored edges; back to top-down when it holds under 1/beta of the nodes
+Bitset bfs_reachable(const IdGraph& g, int start) {
+      const int alpha = 14, beta = 24;
+      int n = g.node_count();
+      Bitset visited(n), in_frontier(n);
+      std::vector<int> frontier(1, start), next;
+      visited.set(start);
+      long long unexplored = g.edge_count() - (g.out_end(start) - g.out_begin(start));
+      bool bottom_up = false;
+
+      while (!frontier.empty()) {
+          long long frontier_edges = 0;
+          for (int u : frontier)
+              frontier_edges += g.out_end(u) - g.out_begin(u);
+          if (!bottom_up && frontier_edges > unexplored/alpha)
+              bottom_up = true;
+          else if (bottom_up && frontier.size() < size_t(n/beta))
+              bottom_up = false;
+
+          next.clear();
+          if (!bottom_up) {
+              for (int u : frontier)
+                  for (int e = g.out_begin(u); e < g.out_end(u); ++e)
+                      if (!visited.test(g.target(e))) {
+                          visited.set(g.target(e));
+                          next.push_back(g.target(e));
+                      }
+          } else {
+              in_frontier.reset();
+              for (int u : frontier)
+                  in_frontier.set(u);
+              for (int w = 0; w*64 < n; ++w) {
+                  uint64_t unvisited = ~visited.word(w);
+                  while (unvisited != 0) {
+                      int v = w*64 + __builtin_ctzll(unvisited);
+                      unvisited &= unvisited - 1;
+                      if (v >= n)
+                          break;
+                      for (int i = g.in_begin(v); i < g.in_end(v); ++i)
+                          if (in_frontier.test(g.source(i))) {
+                              next.push_back(v);
+                              break;
+                          }
+                  }
+              }
+              for (int v : next)                    //Not before: v must not count as frontier
+                  visited.set(v);
+          }
+
+          for (int v : next)
+              unexplored -= g.out_end(v) - g.out_begin(v);
+          frontier.swap(next);
+      }
+      return visited;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//ReachabilityIndex
+
+//Tarjan's algorithm with an explicit stack of (node, next out-edge)
+ReachabilityIndex::ReachabilityIndex(const IdGraph& g, int closure_limit) {
+      int n = g.node_count();
+      components.assign(n, -1);
+      std::vector<int> index(n, -1), lowlink(n, 0), tarjan_stack, component_sizes;
+      std::vector<std::pair<int,int>> call_stack;
+      int next_index = 0, next_component = 0;
+      std::vector<bool> on_stack(n, false);
+
+      for (int root = 0; root < n; ++root) {
+          if (index[root] != -1)
+              continue;
+          call_stack.push_back(std::make_pair(root, g.out_begin(root)));
+          index[root] = lowlink[root] = next_index++;
+          tarjan_stack.push_back(root);
+          on_stack[root] = true;
+          while (!call_stack.empty()) {
+              int u = call_stack.back().first;
+              int& e = call_stack.back().second;
+              if (e < g.out_end(u)) {
+                  int v = g.target(e++);
+                  if (index[v] == -1) {
+                      index[v] = lowlink[v] = next_index++;
+                      tarjan_stack.push_back(v);
+                      on_stack[v] = true;
+                      call_stack.push_back(std::make_pair(v, g.out_begin(v)));
+                  } else if (on_stack[v])
+                      lowlink[u] = std::min(lowlink[u], index[v]);
+                  continue;
+              }
+              call_stack.pop_back();
+              if (!call_stack.empty())
+                  lowlink[call_stack.back().first] = std::min(lowlink[call_stack.back().first], lowlink[u]);
+              if (lowlink[u] == index[u]) {
+                  int v;
+                  do {
+                      v = tarjan_stack.back();
+                      tarjan_stack.pop_back();
+                      on_stack[v] = false;
+                      components[v] = next_component;
+                  } while (v != u);
+                  ++next_component;
+              }
+          }
+      }
+
+      //Members of each component, and its edges to other components (a
+      //  marker array drops duplicates)
+      int c_count = next_component;
+      component_nodes_offsets.assign(c_count+1, 0);
+      for (int id = 0; id < n; ++id)
+          ++component_nodes_offsets[components[id]+1];
+      for (int c = 0; c < c_count; ++c)
+          component_nodes_offsets[c+1] += component_nodes_offsets[c];
+      component_nodes.resize(n);
+      std::vector<int> fill(component_nodes_offsets.begin(), component_nodes_offsets.end()-1);
+      for (int id = 0; id < n; ++id)
+          component_nodes[fill[components[id]]++] = id;
+
+      std::vector<int> marked(c_count, -1);
+      dag_offsets.assign(1, 0);
+      for (int c = 0; c < c_count; ++c) {
+          for (int i = component_nodes_offsets[c]; i < component_nodes_offsets[c+1]; ++i) {
+              int u = component_nodes[i];
+              for (int e = g.out_begin(u); e < g.out_end(u); ++e) {
+                  int d = components[g.target(e)];
+                  if (d != c && marked[d] != c) {
+                      marked[d] = c;
+                      dag_targets.push_back(d);
+                  }
+              }
+          }
+          dag_offsets.push_back(dag_targets.size());
+      }
+
+      if (c_count <= closure_limit) {
+          closure.assign(c_count, Bitset(c_count));
+          for (int c = 0; c < c_count; ++c) {           //Successors have lower numbers: already done
+              closure[c].set(c);
+              for (int i = dag_offsets[c]; i < dag_offsets[c+1]; ++i)
+                  closure[c] |= closure[dag_targets[i]];
+          }
+      } else {
+          label(0);
+          label(1);
+      }
+}
+
+
+bool ReachabilityIndex::reaches(int from, int to) const {
+      int cf = components[from], ct = components[to];
+      if (cf == ct)
+          return true;
+      if (has_closure())
+          return closure[cf].test(ct);
+      if (!labels_allow(cf, ct))
+          return false;
+
+      Bitset visited(component_count());
+      std::vector<int> stack(1, cf);
+      visited.set(cf);
+      while (!stack.empty()) {
+          int c = stack.back();
+          stack.pop_back();
+          for (int i = dag_offsets[c]; i < dag_offsets[c+1]; ++i) {
+              int d = dag_targets[i];
+              if (d == ct)
+                  return true;
+              if (!visited.test(d) && labels_allow(d, ct)) {
+                  visited.set(d);
+                  stack.push_back(d);
+              }
+          }
+      }
+      return false;
+}
+
+
+Bitset ReachabilityIndex::reachable_from(int from) const {
+      Bitset answer(components.size());
+      Bitset reached = reachable_components(components[from]);
+      for (int c = reached.next(0); c != -1; c = reached.next(c+1))
+          for (int i = component_nodes_offsets[c]; i < component_nodes_offsets[c+1]; ++i)
+              answer.set(component_nodes[i]);
+      return answer;
+}
+
+
+//Component numbers only decrease along edges; every component reachable from
+//  from has its interval inside from's in both traversals
+bool ReachabilityIndex::labels_allow(int from, int to) const {
+      return to <= from &&
+             low[0][from] <= low[0][to] && post[0][to] <= post[0][from] &&
+             low[1][from] <= low[1][to] && post[1][to] <= post[1][from];
+}
+
+
+//Post-order DFS of the DAG from each component with no in-edges (highest
+//  numbers first); traversal 1 visits each component's successors in reverse.
+//  low[c] is the smallest post-order number among c and everything below it.
+void ReachabilityIndex::label(int traversal) {
+      int c_count = component_count();
+      std::vector<bool> has_parent(c_count, false), visited(c_count, false);
+      for (int d : dag_targets)
+          has_parent[d] = true;
+      low[traversal].assign(c_count, 0);
+      post[traversal].assign(c_count, 0);
+      int next_post = 0;
+      std::vector<std::pair<int,int>> stack;          //(component, successors visited)
+
+      for (int root = c_count-1; root >= 0; --root) {
+          if (has_parent[root])
+              continue;
+          stack.push_back(std::make_pair(root, 0));
+          visited[root] = true;
+          while (!stack.empty()) {
+              int c = stack.back().first;
+              int& done = stack.back().second;
+              int degree = dag_offsets[c+1] - dag_offsets[c];
+              if (done < degree) {
+                  int i = (traversal == 0 ? dag_offsets[c] + done : dag_offsets[c+1]-1 - done);
+                  ++done;
+                  int d = dag_targets[i];
+                  if (!visited[d]) {
+                      visited[d] = true;
+                      stack.push_back(std::make_pair(d, 0));
+                  }
+                  continue;
+              }
+              stack.pop_back();
+              post[traversal][c] = next_post++;
+              int l = post[traversal][c];
+              for (int i = dag_offsets[c]; i < dag_offsets[c+1]; ++i)
+                  l = std::min(l, low[traversal][dag_targets[i]]);
+              low[traversal][c] = l;
+          }
+      }
+}
+
+
+Bitset ReachabilityIndex::reachable_components(int from) const {
+      if (has_closure())
+          return closure[from];
+      Bitset visited(component_count());
+      std::vector<int> stack(1, from);
+      visited.set(from);
+      while (!stack.empty()) {
+          int c = stack.back();
+          stack.pop_back();
+          for (int i = dag_offsets[c]; i < dag_offsets[c+1]; ++i)
+              if (!visited.test(dag_targets[i])) {
+                  visited.set(dag_targets[i]);
+                  stack.push_back(dag_targets[i]);
+              }
+      }
+      return visited;
+}
+
+
+}
+
+#endif /* REACHABILITY_HPP_ */
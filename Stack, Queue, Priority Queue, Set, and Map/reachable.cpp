@@ -8,6 +8,7 @@
 #include "array_priority_queue.hpp"
 #include "array_set.hpp"
 #include "array_map.hpp"
+#include "reachability.hpp"
 
 
 typedef ics::ArraySet<std::string>          NodeSet;
@@ -54,19 +55,18 @@ void print_graph(const Graph& graph) {
 //  specified (start) node.
 //Use a local Set and a Queue to respectively store the reachable nodes and
 //  the nodes that are being explored.
+//A node goes into the Set when it is queued, so it is queued only once.
 NodeSet reachable(const Graph& graph, std::string start) {
     NodeSet set;
-    std::vector<std::string> searching;
-    searching.push_back(start);
+    ics::ArrayQueue<std::string> searching;
+    set.insert(start);
+    searching.enqueue(start);
     while(!searching.empty()) {
-        auto first = searching[0];
-        searching.erase(searching.begin() + 0);
-        set.insert(first);
+        std::string first = searching.dequeue();
         if (graph.has_key(first)) {
-            auto value = graph[first];
-            for (auto i : value) {
-                if (!set.contains(i)) {
-                    searching.push_back(i);
+            for (const std::string& i : graph[first]) {
+                if (set.insert(i) == 1) {
+                    searching.enqueue(i);
                 }
             }
         }
@@ -74,6 +74,17 @@ NodeSet reachable(const Graph& graph, std::string start) {
 }
 
 
+//Return the same Set as reachable, from a ReachabilityIndex built once for
+//  the graph (see reachability.hpp): no search of the graph per query.
+NodeSet indexed_reachable(const ics::IdGraph& ids, const ics::ReachabilityIndex& index, std::string start) {
+    NodeSet set;
+    ics::Bitset reached = index.reachable_from(ids.find_id(start));
+    for (int id = reached.next(0); id != -1; id = reached.next(id + 1)) {
+        set.insert(ids.node_name(id));
+    } return set;
+}
+
+
 
 
 
@@ -81,7 +92,8 @@ NodeSet reachable(const Graph& graph, std::string start) {
 //  and then repeatedly (until the user enters "quit") prompt the user for a
 //  starting node name and then either print an error (if that the node name
 //  is not a source node in the graph) or print the Set of node names
-//  reachable from it by using the edges in the Graph.
+//  reachable from it by using the edges in the Graph: found by a search
+//  (reachable) or from a ReachabilityIndex (indexed_reachable).
 int main() {
     try {
         std::ifstream inputFile;
@@ -90,6 +102,9 @@ int main() {
         Graph map = read_graph(inputFile);
         print_graph(map);
         std::cout << std::endl;
+        bool use_index = ics::prompt_bool("Answer from a reachability index", true);
+        ics::IdGraph ids(use_index ? map : Graph());
+        ics::ReachabilityIndex index(ids);
         std::string response;
 
         while (true) {
@@ -98,7 +113,8 @@ int main() {
             if (response == "quit") {
                 break;
             } else if (map.has_key(response)) {
-                std::cout << "Reachable from node name " << response << " = " << reachable(map, response);
+                std::cout << "Reachable from node name " << response << " = "
+                          << (use_index ? indexed_reachable(ids, index, response) : reachable(map, response));
             } else {
                 std::cout << "  " << response << " is not a source node name in the graph";
             } std::cout << std::endl << std::endl;